@@ -1,33 +1,207 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <stdexcept>
-#include <list>
+#include <memory>
+#include <new>
+#include <vector>
 
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
 #include <TracyC.h>
 #endif
 
-class Allocator
+/**
+ * \brief Rounds an address up to the next multiple of alignment, which must be a power of two.
+ */
+template<typename T>
+[[nodiscard]] T* AlignForward(T* address, std::size_t alignment) noexcept
+{
+    const auto value = reinterpret_cast<std::uintptr_t>(address);
+    return reinterpret_cast<T*>((value + alignment - 1) & ~(alignment - 1));
+}
+
+/**
+ * \brief Rounds a size up to the next multiple of alignment, which must be a power of two.
+ */
+[[nodiscard]] constexpr std::size_t AlignSize(std::size_t size, std::size_t alignment) noexcept
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * \brief Snapshot of the counters of a tagged allocator, or of all the allocators sharing a tag.
+ */
+struct AllocatorStats
+{
+    const char* tag = nullptr;
+    std::size_t bytesInUse = 0;
+    std::size_t peakBytes = 0;
+    std::size_t allocationCount = 0;
+    std::size_t failedCount = 0;
+};
+
+/**
+ * \brief Base class of the memory sources reporting their statistics: the custom allocators and the SimulationArena.
+ * A recorder given a tag with SetTag records the bytes it hands out, its peak, its allocation count and its failed
+ * requests, and is listed by CollectAllocatorStats. An untagged recorder records nothing.
+ * \n Note : The counters are written by the thread owning the recorder only, and can be read from any thread.
+ */
+class AllocationRecorder
 {
 public:
-    virtual ~Allocator() = default;
+    AllocationRecorder() = default;
+
+    /**
+     * \brief A copy keeps the tag of the source, with its own counters starting at zero.
+     */
+    AllocationRecorder(const AllocationRecorder& other)
+    {
+        if (other._tag)
+        {
+            SetTag(other._tag);
+        }
+    }
+
+    /**
+     * \brief Assigning keeps the tag and the counters of the target, which still owns its own memory.
+     */
+    AllocationRecorder& operator=(const AllocationRecorder&) noexcept
+    {
+        return *this;
+    }
+
+    virtual ~AllocationRecorder();
+
+    /**
+     * \brief Starts recording the statistics of the allocator under a tag.
+     * @param tag The subsystem name, a string literal: Tracy keeps the pointer as the name of the plot.
+     */
+    void SetTag(const char* tag);
+
+    [[nodiscard]] const char* Tag() const noexcept
+    { return _tag; }
+
+    [[nodiscard]] AllocatorStats Stats() const noexcept;
+
+protected:
+    void RecordAllocation(std::size_t size) noexcept
+    {
+        if (!_tag)
+        {
+            return;
+        }
+        const auto bytesInUse = _bytesInUse . load(std::memory_order_relaxed) + size;
+        _bytesInUse . store(bytesInUse, std::memory_order_relaxed);
+        if (bytesInUse > _peakBytes . load(std::memory_order_relaxed))
+        {
+            _peakBytes . store(bytesInUse, std::memory_order_relaxed);
+        }
+        _allocationCount . store(_allocationCount . load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+#ifdef TRACY_ENABLE
+        TracyPlot(_tag, static_cast<std::int64_t>(bytesInUse));
+#endif
+    }
+
+    void RecordDeallocation(std::size_t size) noexcept
+    {
+        if (!_tag)
+        {
+            return;
+        }
+        const auto bytesInUse = _bytesInUse . load(std::memory_order_relaxed) - size;
+        _bytesInUse . store(bytesInUse, std::memory_order_relaxed);
+#ifdef TRACY_ENABLE
+        TracyPlot(_tag, static_cast<std::int64_t>(bytesInUse));
+#endif
+    }
+
+    /**
+     * \brief Gives back every byte at once, for the allocators freeing everything on Reset.
+     */
+    void RecordReset() noexcept
+    {
+        if (!_tag)
+        {
+            return;
+        }
+        _bytesInUse . store(0, std::memory_order_relaxed);
+#ifdef TRACY_ENABLE
+        TracyPlot(_tag, static_cast<std::int64_t>(0));
+#endif
+    }
+
+    void RecordFailure() noexcept
+    {
+        if (!_tag)
+        {
+            return;
+        }
+        _failedCount . store(_failedCount . load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Sets the bytes in use at once, for the memory sources knowing their footprint rather than each block.
+     */
+    void RecordBytesInUse(std::size_t bytesInUse) noexcept
+    {
+        if (!_tag)
+        {
+            return;
+        }
+        _bytesInUse . store(bytesInUse, std::memory_order_relaxed);
+        if (bytesInUse > _peakBytes . load(std::memory_order_relaxed))
+        {
+            _peakBytes . store(bytesInUse, std::memory_order_relaxed);
+        }
+#ifdef TRACY_ENABLE
+        TracyPlot(_tag, static_cast<std::int64_t>(bytesInUse));
+#endif
+    }
+
+private:
+    const char* _tag = nullptr;
+    std::atomic<std::size_t> _bytesInUse{0};
+    std::atomic<std::size_t> _peakBytes{0};
+    std::atomic<std::size_t> _allocationCount{0};
+    std::atomic<std::size_t> _failedCount{0};
+};
 
-    virtual void* Allocate(std::size_t count, std::size_t typeSize) = 0;
+/**
+ * \brief Base class of the custom allocators.
+ */
+class Allocator : public AllocationRecorder
+{
+public:
+    /**
+     * \brief Allocates size bytes starting on a multiple of alignment, which must be a power of two.
+     */
+    virtual void* Allocate(std::size_t size, std::size_t alignment) = 0;
 
     template<typename T>
     T* Allocate(std::size_t count)
     {
-        return static_cast<T*>(Allocate(count, sizeof(T)));
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
     }
 
     virtual void Deallocate(void* ptr) = 0;
 };
 
+/**
+ * \brief Collects the statistics of every tagged allocator and arena alive, summed per tag and sorted by tag.
+ * \n Note : The peak of a tag is the sum of the peaks of its allocators, an upper bound of the real peak.
+ */
+[[nodiscard]] std::vector<AllocatorStats> CollectAllocatorStats();
+
 class LinearAllocator : public Allocator
 {
 public:
+    using Allocator::Allocate;
+
     LinearAllocator(std::size_t size) : _size(size), _ptr(new char[size]), _offset(0)
     {}
 
@@ -36,14 +210,17 @@ public:
         delete[] _ptr;
     }
 
-    void* Allocate(std::size_t size, std::size_t typeSize) override
+    void* Allocate(std::size_t size, std::size_t alignment) override
     {
-        if (_offset + size * typeSize > _size)
+        char* ptr = AlignForward(_ptr + _offset, alignment);
+        const auto end = static_cast<std::size_t>(ptr - _ptr) + size;
+        if (end > _size)
         {
+            RecordFailure();
             throw std::runtime_error("LinearAllocator out of memory");
         }
-        void* ptr = _ptr + _offset;
-        _offset += size * typeSize;
+        RecordAllocation(end - _offset);
+        _offset = end;
         return ptr;
     }
 
@@ -53,6 +230,7 @@ public:
     void Reset()
     {
         _offset = 0;
+        RecordReset();
     }
 
 private:
@@ -63,12 +241,14 @@ private:
 
 struct AllocationHeader
 {
-    std::size_t size;
+    std::size_t previousTop;
 };
 
 class StackAllocator : public Allocator
 {
 public:
+    using Allocator::Allocate;
+
     StackAllocator(std::size_t size) : _size(size), _ptr(new char[size]), _top(0)
     {}
 
@@ -77,36 +257,38 @@ public:
         delete[] _ptr;
     }
 
-    void* Allocate(std::size_t size, std::size_t typeSize) override
+    void* Allocate(std::size_t size, std::size_t alignment) override
     {
-        if (_top + size * typeSize > _size)
+        // The header sits right before the aligned allocation, so the allocation is aligned for it too.
+        alignment = std::max(alignment, alignof(AllocationHeader));
+        char* allocationPtr = AlignForward(_ptr + _top + sizeof(AllocationHeader), alignment);
+        const auto newTop = static_cast<std::size_t>(allocationPtr - _ptr) + size;
+        if (newTop > _size)
         {
+            RecordFailure();
             throw std::runtime_error("StackAllocator out of memory");
         }
+        RecordAllocation(newTop - _top);
 
-        std::size_t headerSize = sizeof(AllocationHeader);
-
-        std::size_t totalSize = size * typeSize + headerSize;
-
-        char* allocationPtr = _ptr + _top;
+        AllocationHeader* header = reinterpret_cast<AllocationHeader*>(allocationPtr - sizeof(AllocationHeader));
+        header -> previousTop = _top;
 
-        AllocationHeader* header = reinterpret_cast<AllocationHeader*>(allocationPtr);
-        header -> size = totalSize;
-
-        _top += totalSize;
-        return allocationPtr + headerSize;
+        _top = newTop;
+        return allocationPtr;
     }
 
     void Deallocate(void* ptr) override
     {
-        char* allocationPtr = reinterpret_cast<char*>(ptr) - sizeof(AllocationHeader);
-        AllocationHeader* header = reinterpret_cast<AllocationHeader*>(allocationPtr);
-        _top -= header -> size;
+        char* allocationPtr = reinterpret_cast<char*>(ptr);
+        AllocationHeader* header = reinterpret_cast<AllocationHeader*>(allocationPtr - sizeof(AllocationHeader));
+        RecordDeallocation(_top - header -> previousTop);
+        _top = header -> previousTop;
     }
 
     void Reset()
     {
         _top = 0;
+        RecordReset();
     }
 
 private:
@@ -115,131 +297,283 @@ private:
     std::size_t _top;
 };
 
+struct HeapAllocationHeader
+{
+    void* rawPtr;
+    std::size_t size;
+};
+
 class HeapAllocator final : public Allocator
 {
 public:
-    void* Allocate(std::size_t size, std::size_t typeSize) override
+    using Allocator::Allocate;
+
+    HeapAllocator() = default;
+
+    explicit HeapAllocator(const char* tag)
+    {
+        SetTag(tag);
+    }
+
+    void* Allocate(std::size_t size, std::size_t alignment) override
     {
-        const auto count = size * typeSize;
-        auto* ptr = std::malloc(count);
+        // Over-allocates to align the block, and keeps the pointer given by malloc and the size right before it.
+        alignment = std::max(alignment, alignof(HeapAllocationHeader));
+        auto* rawPtr = static_cast<char*>(std::malloc(size + alignment + sizeof(HeapAllocationHeader)));
+        if (rawPtr == nullptr)
+        {
+            RecordFailure();
+            throw std::runtime_error("HeapAllocator out of memory");
+        }
+
+        auto* ptr = AlignForward(rawPtr + sizeof(HeapAllocationHeader), alignment);
+        reinterpret_cast<HeapAllocationHeader*>(ptr)[-1] = HeapAllocationHeader{rawPtr, size};
+        RecordAllocation(size);
 #ifdef TRACY_ENABLE
-        TracyAlloc(ptr, count);
+        if (Tag())
+        {
+            TracyAllocN(ptr, size, Tag());
+        }
+        else
+        {
+            TracyAlloc(ptr, size);
+        }
 #endif
         return ptr;
     }
 
     void Deallocate(void* ptr) override
     {
+        if (!ptr)
+        {
+            return;
+        }
 #ifdef TRACY_ENABLE
-        TracyFree(ptr);
+        if (Tag())
+        {
+            TracyFreeN(ptr, Tag());
+        }
+        else
+        {
+            TracyFree(ptr);
+        }
 #endif
-        std::free(ptr);
+        const auto header = reinterpret_cast<HeapAllocationHeader*>(ptr)[-1];
+        RecordDeallocation(header . size);
+        std::free(header . rawPtr);
     }
 };
 
-class ProxyAllocator : public Allocator
+/**
+ * \brief Linear allocator for scratch memory living one frame, reset at the start of each frame.
+ * When the buffer is full, allocations fall back to the heap until the next Reset, which grows the buffer to the
+ * high-water mark of the finished frame. A steady workload stops touching the heap after its first frames.
+ * Deallocate does nothing, the memory is given back all at once by Reset.
+ * Copying a FrameAllocator gives an empty one with the same capacity, and assigning one keeps the target buffer:
+ * the content of an arena is only valid during the frame that wrote it.
+ */
+class FrameAllocator final : public Allocator
 {
 public:
-    ProxyAllocator(Allocator& targetAllocator) : _targetAllocator(targetAllocator)
-    {}
+    using Allocator::Allocate;
 
-    void* Allocate(std::size_t count, std::size_t typeSize) override
+    explicit FrameAllocator(std::size_t capacity, const char* tag = nullptr)
+            : _capacity(capacity), _ptr(new char[capacity])
     {
-        return _targetAllocator . Allocate(count, typeSize);
-    }
-
-    void Deallocate(void* ptr) override
-    {
-        _targetAllocator . Deallocate(ptr);
+        if (tag)
+        {
+            SetTag(tag);
+        }
     }
 
-private:
-    Allocator& _targetAllocator;
-};
-
-struct FreeBlock
-{
-    std::size_t size;
-    FreeBlock* next;
-};
+    FrameAllocator(const FrameAllocator& other)
+            : Allocator(other), _capacity(other._capacity), _ptr(new char[other._capacity])
+    {}
 
-class FreeListAllocator : public Allocator
-{
-public:
-    FreeListAllocator(std::size_t size) : _size(size), _ptr(new char[size]), _freeList(_ptr)
+    FrameAllocator& operator=(const FrameAllocator&) noexcept
     {
-        FreeBlock* firstBlock = reinterpret_cast<FreeBlock*>(_freeList);
-        firstBlock -> size = _size;
-        firstBlock -> next = nullptr;
+        return *this;
     }
 
-    ~FreeListAllocator() override
+    ~FrameAllocator() override
     {
+        ReleaseOverflow();
         delete[] _ptr;
     }
 
-    void* Allocate(std::size_t count, std::size_t typeSize) override
+    void* Allocate(std::size_t size, std::size_t alignment) override
     {
-        FreeBlock* prev = nullptr;
-        FreeBlock* current = reinterpret_cast<FreeBlock*>(_freeList);
+        char* ptr = AlignForward(_ptr + _offset, alignment);
+        const auto end = static_cast<std::size_t>(ptr - _ptr) + size;
+        if (end <= _capacity)
+        {
+            RecordAllocation(end - _offset);
+            _usedSize += end - _offset;
+            _offset = end;
+            return ptr;
+        }
 
-        while (current)
+        // Counted with its worst alignment padding, so it fits in the grown buffer.
+        // Spilling to the heap counts as a failed request: the capacity was too small for the frame.
+        RecordFailure();
+        RecordAllocation(size + alignment - 1);
+        _usedSize += size + alignment - 1;
+
+        // One heap block per spill, chained through a header at its start.
+        const auto headerSize = AlignSize(sizeof(OverflowBlock), alignof(OverflowBlock));
+        auto* rawPtr = static_cast<char*>(std::malloc(headerSize + size + alignment - 1));
+        if (!rawPtr)
         {
-            if (current -> size >= count * typeSize)
-            {
-                if (current -> size > count * typeSize)
-                {
-                    char* newBlockPtr = reinterpret_cast<char*>(current) + count * typeSize;
-                    FreeBlock* newBlockHeader = reinterpret_cast<FreeBlock*>(newBlockPtr);
-                    newBlockHeader -> size = current -> size - count * typeSize;
-                    newBlockHeader -> next = current -> next;
-                }
-
-
-                if (prev)
-                {
-                    prev -> next = current -> next;
-                }
-                else
-                {
-                    _freeList = reinterpret_cast<char*>(current) + count * typeSize;
-                }
-
-                return current + 1;
-            }
-
-            prev = current;
-            current = current -> next;
+            throw std::bad_alloc();
         }
+        auto* block = reinterpret_cast<OverflowBlock*>(rawPtr);
+        block->next = _overflow;
+        _overflow = block;
+        return AlignForward(rawPtr + headerSize, alignment);
+    }
+
+    void Deallocate(void*) override
+    {}
 
-        throw std::runtime_error("FreeListAllocator out of memory");
+    /**
+     * \brief Gives back all the memory of the frame, and grows the buffer if the frame needed more than its capacity.
+     */
+    void Reset()
+    {
+        if (_overflow)
+        {
+            ReleaseOverflow();
+            delete[] _ptr;
+            _capacity = _usedSize;
+            _ptr = new char[_capacity];
+        }
+        _offset = 0;
+        _usedSize = 0;
+        RecordReset();
     }
 
-    void Deallocate(void* ptr) override
+    /**
+     * \return The bytes handed out since the last Reset, the high-water mark of the frame so far.
+     */
+    [[nodiscard]] std::size_t UsedSize() const noexcept
+    { return _usedSize; }
+
+    [[nodiscard]] std::size_t Capacity() const noexcept
+    { return _capacity; }
+
+private:
+    std::size_t _capacity;
+    char* _ptr = nullptr;
+    std::size_t _offset = 0;
+    std::size_t _usedSize = 0;
+
+    /**
+     * \brief Header of a heap block holding an allocation that did not fit in the buffer.
+     */
+    struct OverflowBlock
     {
-        if (!ptr)
+        OverflowBlock* next;
+    };
+
+    OverflowBlock* _overflow = nullptr;
+
+    void ReleaseOverflow() noexcept
+    {
+        while (_overflow)
         {
-            return;
+            auto* next = _overflow->next;
+            std::free(_overflow);
+            _overflow = next;
         }
+    }
+};
 
-        char* blockPtr = reinterpret_cast<char*>(ptr) - sizeof(FreeBlock);
-        FreeBlock* firstBlock = reinterpret_cast<FreeBlock*>(blockPtr);
+class ProxyAllocator : public Allocator
+{
+public:
+    using Allocator::Allocate;
 
-        firstBlock -> next = reinterpret_cast<FreeBlock*>(_freeList);
-        _freeList = blockPtr;
+    ProxyAllocator(Allocator& targetAllocator) : _targetAllocator(targetAllocator)
+    {}
+
+    void* Allocate(std::size_t size, std::size_t alignment) override
+    {
+        return _targetAllocator . Allocate(size, alignment);
     }
 
-    void Reset()
+    void Deallocate(void* ptr) override
     {
-        FreeBlock* firstBlock = reinterpret_cast<FreeBlock*>(_freeList);
-        firstBlock -> size = _size;
-        firstBlock -> next = nullptr;
+        _targetAllocator . Deallocate(ptr);
     }
 
 private:
-    std::size_t _size;
-    char* _ptr;
-    char* _freeList;
+    Allocator& _targetAllocator;
+};
+
+/**
+ * \brief Two-level segregated fit (TLSF) allocator over a fixed buffer, for general purpose allocations.
+ * Free blocks are kept in lists indexed by a power of two (first level) split into SecondLevelCount linear ranges
+ * (second level). Two bitmaps find a non-empty list big enough for a request in constant time, and a freed block is
+ * merged at once with its free neighbours, so the fragmentation stays bounded in long running processes.
+ * Every block starts with a TlsfBlock header giving its size and its previous physical block.
+ *
+ * \n Note : Reset gives back the whole buffer as one free block, and invalidates every live allocation.
+ */
+class TlsfAllocator final : public Allocator
+{
+public:
+    using Allocator::Allocate;
+
+    explicit TlsfAllocator(std::size_t capacity, const char* tag = nullptr);
+
+    TlsfAllocator(const TlsfAllocator&) = delete;
+    TlsfAllocator& operator=(const TlsfAllocator&) = delete;
+
+    ~TlsfAllocator() override;
+
+    void* Allocate(std::size_t size, std::size_t alignment) override;
+
+    void Deallocate(void* ptr) override;
+
+    void Reset();
+
+    [[nodiscard]] std::size_t Capacity() const noexcept
+    { return _capacity; }
+
+    static constexpr std::size_t BlockAlignmentLog2 = 4;
+    static constexpr std::size_t BlockAlignment = std::size_t(1) << BlockAlignmentLog2;
+    static constexpr std::size_t SecondLevelCountLog2 = 4;
+    static constexpr std::size_t SecondLevelCount = std::size_t(1) << SecondLevelCountLog2;
+    static constexpr std::size_t FirstLevelShift = SecondLevelCountLog2 + BlockAlignmentLog2;
+    static constexpr std::size_t FirstLevelMax = 32;
+    static constexpr std::size_t FirstLevelCount = FirstLevelMax - FirstLevelShift + 1;
+    static constexpr std::size_t SmallBlockSize = std::size_t(1) << FirstLevelShift;
+
+private:
+    struct TlsfBlock
+    {
+        TlsfBlock* prevPhysical;
+        // Payload size, a multiple of BlockAlignment: the two low bits hold the free flags.
+        std::size_t sizeAndFlags;
+        // Only valid while the block is free, they lie on the payload.
+        alignas(BlockAlignment) TlsfBlock* nextFree;
+        TlsfBlock* prevFree;
+    };
+
+    static constexpr std::size_t BlockHeaderSize = BlockAlignment;
+    static constexpr std::size_t MinBlockSize = sizeof(TlsfBlock) - BlockHeaderSize;
+
+    std::size_t _capacity;
+    char* _buffer = nullptr;
+    std::uint32_t _firstLevelBitmap = 0;
+    std::uint32_t _secondLevelBitmaps[FirstLevelCount]{};
+    TlsfBlock* _freeBlocks[FirstLevelCount][SecondLevelCount]{};
+
+    void InsertFreeBlock(TlsfBlock* block) noexcept;
+    void RemoveFreeBlock(TlsfBlock* block) noexcept;
+    [[nodiscard]] TlsfBlock* FindFreeBlock(std::size_t size) noexcept;
+    void SplitBlock(TlsfBlock* block, std::size_t size) noexcept;
+    [[nodiscard]] TlsfBlock* MergeFreeNeighbours(TlsfBlock* block) noexcept;
 };
 
 struct PoolBlock
@@ -250,28 +584,37 @@ struct PoolBlock
 class PoolAllocator : public Allocator
 {
 public:
-    PoolAllocator(std::size_t blockCount, std::size_t blockSize) : _blockSize(blockSize), _blockCount(blockCount)
+    using Allocator::Allocate;
+
+    PoolAllocator(std::size_t blockCount, std::size_t blockSize, std::size_t alignment = alignof(std::max_align_t))
+            : _alignment(std::max(alignment, alignof(PoolBlock))),
+              _blockSize(AlignSize(std::max(blockSize, sizeof(PoolBlock)), _alignment)),
+              _blockCount(blockCount)
     {
-        _pool = new char[blockSize * blockCount];
+        _buffer = new char[_blockSize * _blockCount + _alignment];
+        _pool = AlignForward(_buffer, _alignment);
         InitializePoolList();
     }
 
     ~PoolAllocator() override
     {
-        delete[] _pool;
+        delete[] _buffer;
     }
 
-    void* Allocate(std::size_t count, std::size_t typeSize) override
+    void* Allocate(std::size_t size, std::size_t alignment) override
     {
-        if (count * typeSize != _blockSize)
+        if (size > _blockSize || alignment > _alignment)
         {
+            RecordFailure();
             throw std::runtime_error("Invalid allocation size for PoolAllocator");
         }
 
         if (_poolList == nullptr)
         {
+            RecordFailure();
             throw std::runtime_error("PoolAllocator out of memory");
         }
+        RecordAllocation(_blockSize);
 
         PoolBlock* allocatedBlock = _poolList;
         _poolList = _poolList -> next;
@@ -288,16 +631,20 @@ public:
         PoolBlock* deallocatedBlock = reinterpret_cast<PoolBlock*>(ptr);
         deallocatedBlock -> next = _poolList;
         _poolList = deallocatedBlock;
+        RecordDeallocation(_blockSize);
     }
 
     void Reset()
     {
         InitializePoolList();
+        RecordReset();
     }
 
 private:
+    std::size_t _alignment;
     std::size_t _blockSize;
     std::size_t _blockCount;
+    char* _buffer;
     char* _pool;
     PoolBlock* _poolList;
 
@@ -315,6 +662,46 @@ private:
     }
 };
 
+/**
+ * \brief Fixed-size block pool shared by several threads, growing by whole slabs when exhausted.
+ * Each thread keeps two magazines of MagazineSize blocks for this pool: most allocations and frees only touch the
+ * magazines of the calling thread. Full and empty magazines are exchanged with a global depot, two lock-free stacks.
+ * Only the growth by a new slab of blocksPerSlab blocks takes a lock.
+ * A block can be freed by any thread, not only the one that allocated it.
+ *
+ * \n Note : The statistics count the bytes of the slabs, the blocks moving between the magazines are not tracked.
+ * The depot lives until the pool and every thread cache referencing it are gone, the cache of a destroyed pool is
+ * released by the next cache miss or at the exit of the thread.
+ */
+class ThreadCachePoolAllocator final : public Allocator
+{
+public:
+    using Allocator::Allocate;
+
+    static constexpr std::size_t MagazineSize = 32;
+
+    ThreadCachePoolAllocator(std::size_t blockSize, std::size_t alignment = alignof(std::max_align_t),
+                             std::size_t blocksPerSlab = 1024, const char* tag = nullptr);
+
+    ThreadCachePoolAllocator(const ThreadCachePoolAllocator&) = delete;
+    ThreadCachePoolAllocator& operator=(const ThreadCachePoolAllocator&) = delete;
+
+    ~ThreadCachePoolAllocator() override;
+
+    void* Allocate(std::size_t size, std::size_t alignment) override;
+
+    void Deallocate(void* ptr) override;
+
+    [[nodiscard]] std::size_t BlockSize() const noexcept;
+
+    struct Depot;
+
+private:
+    std::shared_ptr<Depot> _depot;
+
+    void GrowSlab(Depot& depot);
+};
+
 /**
  * \brief Custom proxy allocator respecting allocator_traits
  */
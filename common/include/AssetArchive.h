@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * \brief Kind of data stored by an AssetEntry.
+ * Image: pixels decoded to RGBA8, width * height * 4 bytes, ready to be uploaded as a texture.
+ * File: the bytes of a source file kept as they are, like a wav file streamed by the audio.
+ * Sprite: an AtlasRegion, the place of an image in an atlas, itself an Image entry of the archive.
+ */
+enum class AssetType : std::uint32_t
+{
+    Image = 0,
+    File = 1,
+    Sprite = 2
+};
+
+/**
+ * \brief Header at the start of an asset archive, followed by entryCount AssetEntry, then by the data of the entries.
+ * \n Note : The archive is written by the packer of the build, for the same platform: the integers are native.
+ */
+struct AssetArchiveHeader
+{
+    static constexpr std::uint32_t Magic = 0x4B415041; // "APAK"
+    static constexpr std::uint32_t CurrentVersion = 2;
+
+    std::uint32_t magic = Magic;
+    std::uint32_t version = CurrentVersion;
+    std::uint32_t entryCount = 0;
+    std::uint32_t reserved = 0;
+};
+
+/**
+ * \brief Description of an asset in an archive, its data starting offset bytes after the start of the archive.
+ * \n Note : bakedScale is the scale already applied to the pixels of an image or a sprite by the packer, 1 for the
+ * other assets. The width and height of a sprite are the ones of its region.
+ */
+struct AssetEntry
+{
+    static constexpr std::size_t MaxNameLength = 47;
+
+    char name[MaxNameLength + 1]{};
+    AssetType type = AssetType::File;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    float bakedScale = 1.f;
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+};
+
+/**
+ * \brief Data of a Sprite entry: the atlas entry holding its pixels, and the top left corner of its region there.
+ */
+struct AtlasRegion
+{
+    std::uint32_t atlasIndex = 0;
+    std::uint32_t x = 0;
+    std::uint32_t y = 0;
+    std::uint32_t reserved = 0;
+};
+
+/**
+ * \brief An image to pack in an atlas, decoded to RGBA8.
+ */
+struct AtlasSprite
+{
+    std::string name;
+    const void* pixels = nullptr;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    float bakedScale = 1.f;
+};
+
+/**
+ * \brief Builds an asset archive in memory and writes it in one go, used by the asset packer of the build.
+ */
+class AssetArchiveWriter
+{
+public:
+    /**
+     * \brief The data of every entry starts on a multiple of DataAlignment, so it can be read in place.
+     */
+    static constexpr std::size_t DataAlignment = 16;
+
+    /**
+     * \brief Transparent pixels between two neighbouring images of an atlas, half of them on each side of an image.
+     */
+    static constexpr std::uint32_t AtlasPadding = 2;
+
+    /**
+     * \brief Adds an image already decoded to RGBA8.
+     * @param bakedScale The scale the pixels were resized by, drawn back at scale / bakedScale.
+     * @return false if the name is too long or already in the archive.
+     */
+    bool AddImage(std::string_view name, const void* pixels, std::uint32_t width, std::uint32_t height,
+                  float bakedScale);
+
+    /**
+     * \brief Adds the bytes of a file as they are.
+     * @return false if the name is too long or already in the archive.
+     */
+    bool AddFile(std::string_view name, const void* data, std::size_t size);
+
+    /**
+     * \brief Packs images in one atlas image, added with a Sprite entry per image.
+     * The images are placed on shelves, tallest first, AtlasPadding transparent pixels apart: each image gets a
+     * border of AtlasPadding / 2 pixels, enough for bilinear filtering never to sample a neighbour.
+     * @return false if a name is too long or already in the archive, nothing is added then.
+     */
+    bool AddAtlas(std::string_view name, const std::vector<AtlasSprite>& sprites);
+
+    /**
+     * \brief Writes the header, the entries and their data.
+     * @return false if the file could not be written.
+     */
+    [[nodiscard]] bool Write(const char* path) const;
+
+private:
+    std::vector<AssetEntry> _entries;
+    std::vector<std::byte> _data;
+
+    bool AddEntry(std::string_view name, AssetEntry entry, const void* data);
+
+    [[nodiscard]] bool IsNameFree(std::string_view name) const noexcept;
+};
+
+/**
+ * \brief Read only view of an asset archive mapped in memory.
+ * Opening the archive maps the file without reading it, the pages of an asset are loaded by the system the first time
+ * its data is read, so no asset is decoded or copied at startup.
+ * \n Note : The data of the entries stays valid until Close, textures and music streams can be made from it in place.
+ */
+class AssetArchive
+{
+public:
+    AssetArchive() = default;
+
+    AssetArchive(const AssetArchive&) = delete;
+
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    ~AssetArchive();
+
+    /**
+     * \brief Maps an archive and checks its header and entries.
+     * @return false if the file is missing or is not a valid archive, the archive then stays closed.
+     */
+    bool Open(const char* path) noexcept;
+
+    void Close() noexcept;
+
+    [[nodiscard]] bool IsOpen() const noexcept
+    { return _mapping != nullptr; }
+
+    /**
+     * @return The entry of an asset, or nullptr if the archive is closed or has no asset with that name.
+     */
+    [[nodiscard]] const AssetEntry* Find(std::string_view name) const noexcept;
+
+    [[nodiscard]] const std::byte* Data(const AssetEntry& entry) const noexcept
+    { return _mapping + entry.offset; }
+
+    [[nodiscard]] std::size_t EntryCount() const noexcept
+    { return _entryCount; }
+
+    [[nodiscard]] const AssetEntry& Entry(std::size_t index) const noexcept
+    { return _entries[index]; }
+
+    /**
+     * @return The region of a Sprite entry in its atlas.
+     */
+    [[nodiscard]] AtlasRegion Region(const AssetEntry& entry) const noexcept;
+
+private:
+    const std::byte* _mapping = nullptr;
+    std::size_t _mappingSize = 0;
+    const AssetEntry* _entries = nullptr;
+    std::size_t _entryCount = 0;
+#ifdef _WIN32
+    void* _file = nullptr;
+    void* _fileMapping = nullptr;
+#endif
+
+    /**
+     * \brief Checks the header and the entries of the mapped file, then points the entry table to them.
+     */
+    [[nodiscard]] bool ReadEntries() noexcept;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+/**
+ * @brief Schedules the ticks of a simulation running at a fixed rate, whatever the rate of the frames driving it.
+ * Each frame hands its elapsed wall-clock time to Advance, which tells how many ticks are due. The time left over,
+ * less than a tick, is kept for the next frame and gives the interpolation alpha of the frame.
+ *
+ * The class has the following members:
+ * - _step: The duration of a tick, in seconds.
+ * - _maxTicksPerFrame: The most ticks run by a single frame, to catch up after a slow frame.
+ * - _accumulator: The elapsed time not simulated yet, in seconds.
+ * - _droppedTime: The time given up because a frame was late by more than _maxTicksPerFrame ticks.
+ *
+ * \n Note : The accumulator is a double so that the rounding of the frame times does not drift over a long run.
+ */
+class FixedTimestep
+{
+public:
+    explicit FixedTimestep(double step, int maxTicksPerFrame = 5) noexcept;
+
+    /**
+     * @brief Adds the elapsed time of a frame.
+     * A frame late by more than _maxTicksPerFrame ticks, like after a breakpoint or a moved window, gives up the
+     * extra time instead of running ever more ticks to catch up with it.
+     * @return The number of ticks to run this frame, at most _maxTicksPerFrame.
+     */
+    [[nodiscard]] int Advance(double deltaTime) noexcept;
+
+    /**
+     * @return The fraction of a tick elapsed since the last one, in [0, 1], to blend the last two simulated states.
+     */
+    [[nodiscard]] float Alpha() const noexcept
+    { return static_cast<float>(_accumulator / _step); }
+
+    [[nodiscard]] double Step() const noexcept
+    { return _step; }
+
+    [[nodiscard]] double DroppedTime() const noexcept
+    { return _droppedTime; }
+
+    /**
+     * @brief Forgets the time not simulated yet, when the simulation starts over.
+     */
+    void Reset() noexcept;
+
+private:
+    double _step;
+    int _maxTicksPerFrame;
+    double _accumulator = 0.0;
+    double _droppedTime = 0.0;
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "Allocator.h"
+#include "SharedPtr.h"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+template<typename T>
+class IntrusivePtr;
+
+template<typename T, typename... Args>
+IntrusivePtr<T> AllocateIntrusive(Allocator& allocator, Args&& ... args);
+
+/**
+ * \brief Base class of the objects counting their own owners, pointed to by IntrusivePtr.
+ * The count and the allocator the object comes from live in the object, so no control block is allocated.
+ * \n Note : A copy of the object starts with no owner, the count is never copied.
+ */
+template<typename CountPolicy = NonAtomicCount>
+class RefCounted
+{
+private:
+    mutable CountPolicy _refCount{};
+    Allocator* _allocator = nullptr;
+
+    template<typename T>
+    friend class IntrusivePtr;
+
+    template<typename T, typename... Args>
+    friend IntrusivePtr<T> AllocateIntrusive(Allocator& allocator, Args&& ... args);
+
+protected:
+    RefCounted() noexcept = default;
+
+    RefCounted(const RefCounted&) noexcept
+    {}
+
+    RefCounted& operator=(const RefCounted&) noexcept
+    {
+        return *this;
+    }
+
+    ~RefCounted() = default;
+
+public:
+    [[nodiscard]] std::size_t RefCount() const noexcept
+    {
+        return _refCount . Load();
+    }
+};
+
+template<typename T>
+class IntrusivePtr
+{
+private:
+    T* _ptr = nullptr;
+
+    void Release() noexcept
+    {
+        if (_ptr != nullptr && _ptr->_refCount . Decrement())
+        {
+            auto* allocator = _ptr->_allocator;
+            if (allocator != nullptr)
+            {
+                _ptr->~T();
+                allocator->Deallocate(_ptr);
+            }
+            else
+            {
+                delete _ptr;
+            }
+        }
+        _ptr = nullptr;
+    }
+
+public:
+    constexpr IntrusivePtr() noexcept = default;
+
+    /**
+     * \brief Adds an owner to an object, made with new or by AllocateIntrusive, possibly already owned.
+     */
+    IntrusivePtr(T* ptr) noexcept
+    {
+        _ptr = ptr;
+        if (_ptr != nullptr)
+        {
+            _ptr->_refCount . Increment();
+        }
+    }
+
+    ~IntrusivePtr() noexcept
+    {
+        Release();
+    }
+
+    //Copy Constructor
+    IntrusivePtr(const IntrusivePtr& ptr) noexcept : IntrusivePtr(ptr . _ptr)
+    {}
+
+    //Copy
+    IntrusivePtr& operator=(const IntrusivePtr& ptr) noexcept
+    {
+        IntrusivePtr copy(ptr);
+        std::swap(_ptr, copy . _ptr);
+        return *this;
+    }
+
+    //Move Constructor
+    IntrusivePtr(IntrusivePtr&& ptr) noexcept
+    {
+        std::swap(_ptr, ptr . _ptr);
+    }
+
+    //Move Assignment
+    IntrusivePtr& operator=(IntrusivePtr&& ptr) noexcept
+    {
+        std::swap(_ptr, ptr . _ptr);
+        return *this;
+    }
+
+    constexpr T* Get() const noexcept
+    {
+        return _ptr;
+    }
+
+    constexpr T& operator*() const noexcept
+    {
+        return *_ptr;
+    }
+
+    constexpr T* operator->() const noexcept
+    {
+        return _ptr;
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return _ptr != nullptr;
+    }
+
+    [[nodiscard]] std::size_t Count() const noexcept
+    {
+        return _ptr != nullptr ? _ptr->RefCount() : 0;
+    }
+};
+
+/**
+ * \brief Builds a RefCounted object in the memory of an allocator, given back to it by the last owner.
+ * \n Note : One allocation per object, the size of the object only.
+ */
+template<typename T, typename... Args>
+IntrusivePtr<T> AllocateIntrusive(Allocator& allocator, Args&& ... args)
+{
+    auto* memory = allocator.Allocate(sizeof(T), alignof(T));
+    T* ptr;
+    try
+    {
+        ptr = new(memory) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        allocator.Deallocate(memory);
+        throw;
+    }
+    ptr->_allocator = &allocator;
+    return IntrusivePtr<T>(ptr);
+}
@@ -1,67 +1,177 @@
 #pragma once
 
+#include "Allocator.h"
+
+#include <atomic>
 #include <cstddef>
+#include <new>
+#include <utility>
 
-template<typename T>
+/**
+ * \brief Count policy of the pointers owned by one thread at a time, the default one.
+ */
+struct NonAtomicCount
+{
+    std::size_t value = 0;
+
+    void Increment() noexcept
+    {
+        value++;
+    }
+
+    /**
+     * @return True if the last owner is gone.
+     */
+    bool Decrement() noexcept
+    {
+        return --value == 0;
+    }
+
+    [[nodiscard]] std::size_t Load() const noexcept
+    {
+        return value;
+    }
+};
+
+/**
+ * \brief Count policy of the pointers copied and dropped from several threads, like the buffers handed to jobs.
+ * \n Note : The last owner synchronizes with the writes of every other owner before destroying the object.
+ */
+struct AtomicCount
+{
+    std::atomic<std::size_t> value{0};
+
+    void Increment() noexcept
+    {
+        value . fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool Decrement() noexcept
+    {
+        if (value . fetch_sub(1, std::memory_order_release) != 1)
+        {
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t Load() const noexcept
+    {
+        return value . load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * \brief Count of a SharedPtr and the way to destroy its object, shared by all its copies.
+ */
+template<typename CountPolicy>
+struct SharedControlBlock
+{
+    CountPolicy count{};
+    Allocator* allocator = nullptr;
+    void (* destroy)(SharedControlBlock* block, void* ptr) noexcept = nullptr;
+};
+
+template<typename T, typename CountPolicy>
+class SharedPtr;
+
+template<typename T, typename CountPolicy = NonAtomicCount, typename... Args>
+SharedPtr<T, CountPolicy> AllocateShared(Allocator& allocator, Args&& ... args);
+
+template<typename T, typename CountPolicy = NonAtomicCount>
 class SharedPtr
 {
 private:
+    using ControlBlock = SharedControlBlock<CountPolicy>;
+
     T* _ptr = nullptr;
-    std::size_t* _count = nullptr;
+    ControlBlock* _count = nullptr;
+
+    SharedPtr(T* ptr, ControlBlock* block) noexcept : _ptr(ptr), _count(block)
+    {
+        _count->count . Increment();
+    }
+
+    void Release() noexcept
+    {
+        if (_count != nullptr && _count->count . Decrement())
+        {
+            _count->destroy(_count, _ptr);
+        }
+        _ptr = nullptr;
+        _count = nullptr;
+    }
+
+    template<typename U, typename Policy, typename... Args>
+    friend SharedPtr<U, Policy> AllocateShared(Allocator& allocator, Args&& ... args);
 
 public:
     constexpr SharedPtr() noexcept = default;
 
-    constexpr SharedPtr(T* ptr) noexcept
+    /**
+     * \brief Takes an object made with new, the count gets its own control block made with new.
+     */
+    SharedPtr(T* ptr)
     {
         _ptr = ptr;
-        _count = new std::size_t(1);
+        _count = new ControlBlock();
+        _count->destroy = [](ControlBlock* block, void* object) noexcept
+        {
+            delete static_cast<T*>(object);
+            delete block;
+        };
+        _count->count . Increment();
     }
 
     ~SharedPtr() noexcept
     {
-        (*_count)--;
-        if (*_count == 0)
-        {
-            delete _ptr;
-            delete _count;
-        }
+        Release();
     }
 
     //Copy Constructor
-    constexpr SharedPtr(const SharedPtr& ptr) noexcept
+    SharedPtr(const SharedPtr& ptr) noexcept
     {
         _ptr = ptr . _ptr;
         _count = ptr . _count;
-        (*_count)++;
+        if (_count != nullptr)
+        {
+            _count->count . Increment();
+        }
     }
 
     //Copy
-    constexpr SharedPtr<T>& operator=(const SharedPtr<T>& ptr) noexcept
+    SharedPtr& operator=(const SharedPtr& ptr) noexcept
     {
-        _ptr = ptr . _ptr;
-        _count = ptr . _count;
-        (*_count)++;
+        if (this != &ptr)
+        {
+            // Taken before the release, in case the object releasing owns ptr.
+            if (ptr . _count != nullptr)
+            {
+                ptr . _count->count . Increment();
+            }
+            auto* newPtr = ptr . _ptr;
+            auto* newCount = ptr . _count;
+            Release();
+            _ptr = newPtr;
+            _count = newCount;
+        }
+        return *this;
     }
 
     //Move Constructor
-    constexpr SharedPtr(const SharedPtr&& ptr) noexcept
+    SharedPtr(SharedPtr&& ptr) noexcept
     {
-        _ptr = ptr . _ptr;
-        _count = ptr . _count;
-
-        ptr . _ptr = nullptr;
-        ptr . _count = nullptr;
+        std::swap(_ptr, ptr . _ptr);
+        std::swap(_count, ptr . _count);
     }
 
     //Move Assignment
-    constexpr SharedPtr<T>& operator=(SharedPtr<T>&& ptr) noexcept
+    SharedPtr& operator=(SharedPtr&& ptr) noexcept
     {
-        _ptr = ptr . _ptr;
-        _count = ptr . _count;
-
-        ptr . _ptr = nullptr;
-        ptr . _count = nullptr;
+        std::swap(_ptr, ptr . _ptr);
+        std::swap(_count, ptr . _count);
+        return *this;
     }
 
     constexpr T* Get() const noexcept
@@ -79,8 +189,58 @@ public:
         return Get();
     }
 
-    [[nodiscard]] constexpr std::size_t Count() const noexcept
+    constexpr explicit operator bool() const noexcept
+    {
+        return _ptr != nullptr;
+    }
+
+    [[nodiscard]] std::size_t Count() const noexcept
     {
-        return *_count;
+        return _count != nullptr ? _count->count . Load() : 0;
     }
-};
\ No newline at end of file
+};
+
+/**
+ * \brief SharedPtr whose copies can be made and dropped from several threads.
+ */
+template<typename T>
+using AtomicSharedPtr = SharedPtr<T, AtomicCount>;
+
+/**
+ * \brief Builds an object and its control block in a single allocation of an allocator, given back to it by the last owner.
+ * \n Note : The allocator must outlive every copy of the pointer, and be thread safe if the copies are dropped
+ * from several threads.
+ */
+template<typename T, typename CountPolicy, typename... Args>
+SharedPtr<T, CountPolicy> AllocateShared(Allocator& allocator, Args&& ... args)
+{
+    using ControlBlock = SharedControlBlock<CountPolicy>;
+    struct Storage
+    {
+        ControlBlock block;
+        alignas(T) unsigned char object[sizeof(T)];
+    };
+
+    auto* storage = static_cast<Storage*>(allocator.Allocate(sizeof(Storage), alignof(Storage)));
+    T* ptr;
+    try
+    {
+        ptr = new(storage->object) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        allocator.Deallocate(storage);
+        throw;
+    }
+
+    auto* block = new(&storage->block) ControlBlock();
+    block->allocator = &allocator;
+    block->destroy = [](ControlBlock* controlBlock, void* object) noexcept
+    {
+        static_cast<T*>(object)->~T();
+        auto* blockAllocator = controlBlock->allocator;
+        controlBlock->~ControlBlock();
+        blockAllocator->Deallocate(controlBlock);
+    };
+    return SharedPtr<T, CountPolicy>(ptr, block);
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "Allocator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/**
+ * \brief Position of an allocation in a SimulationArena, counted in bytes from the start of its buffer.
+ * Zero is never allocated and stands for no allocation.
+ */
+using ArenaOffset = std::uint32_t;
+
+/**
+ * \brief Handle of a growable array living in a SimulationArena: an offset, a size and a capacity, no pointer.
+ * A handle stays valid when the arena buffer moves, and when the arena is copied to another one.
+ */
+template<typename T>
+struct ArenaVector
+{
+    ArenaOffset offset = 0;
+    std::uint32_t size = 0;
+    std::uint32_t capacity = 0;
+};
+
+/**
+ * \brief View of the elements of an ArenaVector, valid until the next allocation in its arena.
+ */
+template<typename T>
+class ArenaSpan
+{
+public:
+    ArenaSpan() noexcept = default;
+
+    ArenaSpan(T* data, std::size_t size) noexcept : _data(data), _size(size)
+    {}
+
+    [[nodiscard]] T* begin() const noexcept
+    { return _data; }
+
+    [[nodiscard]] T* end() const noexcept
+    { return _data + _size; }
+
+    [[nodiscard]] T& operator[](std::size_t index) const noexcept
+    { return _data[index]; }
+
+    [[nodiscard]] T& back() const noexcept
+    { return _data[_size - 1]; }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    { return _size; }
+
+    [[nodiscard]] bool empty() const noexcept
+    { return _size == 0; }
+
+private:
+    T* _data = nullptr;
+    std::size_t _size = 0;
+};
+
+/**
+ * \brief Contiguous, relocatable memory for the mutable state of a simulation.
+ * Allocations are referred to by ArenaOffset, never by pointer, and the allocator bookkeeping (bump offset and free
+ * lists of power of two size classes) lives in a header at the start of the buffer, made of offsets as well.
+ * The whole state of the arena is thus the prefix of its buffer up to UsedSize: copying an arena, saving it or
+ * restoring it is a single memcpy of that prefix, and the buffer can grow by moving it anywhere.
+ *
+ * A tagged arena reports the bytes of its live blocks through CollectAllocatorStats, like the tagged allocators.
+ *
+ * \n Note : Only trivially copyable types can be stored. A pointer from Data, Get or View is invalidated by any
+ * allocation, which may move the buffer: keep offsets across allocations, not pointers.
+ */
+class SimulationArena final : public AllocationRecorder
+{
+public:
+    static constexpr std::size_t Alignment = 16;
+
+    explicit SimulationArena(std::size_t capacity = 0, const char* tag = nullptr);
+
+    SimulationArena(const SimulationArena& other);
+
+    SimulationArena& operator=(const SimulationArena& other);
+
+    ~SimulationArena();
+
+    /**
+     * \brief Allocates size bytes aligned on Alignment, growing the buffer if needed.
+     */
+    [[nodiscard]] ArenaOffset Allocate(std::size_t size);
+
+    /**
+     * \brief Gives back an allocation of size bytes, size being the one given to Allocate.
+     */
+    void Deallocate(ArenaOffset offset, std::size_t size) noexcept;
+
+    /**
+     * \brief Gives back every allocation, the buffer keeps its capacity.
+     */
+    void Reset() noexcept;
+
+    /**
+     * \brief Replaces the content of the arena with the prefix saved from another arena.
+     */
+    void Load(const std::byte* data, std::size_t size);
+
+    [[nodiscard]] std::byte* Data() noexcept
+    { return _buffer; }
+
+    [[nodiscard]] const std::byte* Data() const noexcept
+    { return _buffer; }
+
+    /**
+     * \return The size of the prefix holding the whole state of the arena, header included.
+     */
+    [[nodiscard]] std::size_t UsedSize() const noexcept
+    { return Header().usedSize; }
+
+    [[nodiscard]] std::size_t Capacity() const noexcept
+    { return _capacity; }
+
+    template<typename T>
+    [[nodiscard]] T* Get(ArenaOffset offset) noexcept
+    { return reinterpret_cast<T*>(_buffer + offset); }
+
+    template<typename T>
+    [[nodiscard]] const T* Get(ArenaOffset offset) const noexcept
+    { return reinterpret_cast<const T*>(_buffer + offset); }
+
+    template<typename T>
+    [[nodiscard]] ArenaSpan<T> View(const ArenaVector<T>& vector) noexcept
+    { return ArenaSpan<T>(Get<T>(vector.offset), vector.size); }
+
+    template<typename T>
+    [[nodiscard]] ArenaSpan<const T> View(const ArenaVector<T>& vector) const noexcept
+    { return ArenaSpan<const T>(Get<T>(vector.offset), vector.size); }
+
+    /**
+     * \brief Grows the capacity of an ArenaVector, moving its elements.
+     * @return The handle, moved with the buffer if it lives in the arena itself, like the handles of a tree node.
+     */
+    template<typename T>
+    ArenaVector<T>& Reserve(ArenaVector<T>& vector, std::size_t capacity)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SimulationArena only stores trivially copyable types");
+        static_assert(alignof(T) <= Alignment, "SimulationArena aligns its allocations on 16 bytes");
+        if (capacity <= vector.capacity)
+        {
+            return vector;
+        }
+
+        const auto handleOffset = OffsetOf(&vector);
+        const auto offset = Allocate(capacity * sizeof(T));
+        auto& handle = handleOffset ? *Get<ArenaVector<T>>(handleOffset) : vector;
+        if (handle.size > 0)
+        {
+            std::memcpy(_buffer + offset, _buffer + handle.offset, handle.size * sizeof(T));
+        }
+        if (handle.capacity > 0)
+        {
+            Deallocate(handle.offset, handle.capacity * sizeof(T));
+        }
+        handle.offset = offset;
+        handle.capacity = static_cast<std::uint32_t>(capacity);
+        return handle;
+    }
+
+    template<typename T>
+    void Resize(ArenaVector<T>& vector, std::size_t size, T value = T())
+    {
+        auto& handle = Reserve(vector, size);
+        auto* data = Get<T>(handle.offset);
+        for (std::size_t i = handle.size; i < size; i++)
+        {
+            data[i] = value;
+        }
+        handle.size = static_cast<std::uint32_t>(size);
+    }
+
+    /**
+     * \brief Appends a value, doubling the capacity when full. The value is taken by copy, it may live in the arena.
+     */
+    template<typename T>
+    void PushBack(ArenaVector<T>& vector, T value)
+    {
+        auto* handle = &vector;
+        if (handle->size == handle->capacity)
+        {
+            handle = &Reserve(vector, vector.capacity == 0 ? 4 : 2 * static_cast<std::size_t>(vector.capacity));
+        }
+        Get<T>(handle->offset)[handle->size] = value;
+        handle->size++;
+    }
+
+    template<typename T>
+    void PopBack(ArenaVector<T>& vector) noexcept
+    {
+        vector.size--;
+    }
+
+    template<typename T>
+    void Clear(ArenaVector<T>& vector) noexcept
+    {
+        vector.size = 0;
+    }
+
+    template<typename T>
+    void Free(ArenaVector<T>& vector) noexcept
+    {
+        if (vector.capacity > 0)
+        {
+            Deallocate(vector.offset, vector.capacity * sizeof(T));
+        }
+        vector = ArenaVector<T>{};
+    }
+
+private:
+    static constexpr std::size_t MinClassSizeLog2 = 4;
+    static constexpr std::size_t ClassCount = 28;
+
+    struct ArenaHeader
+    {
+        std::uint32_t usedSize;
+        std::uint32_t liveSize;
+        ArenaOffset freeLists[ClassCount];
+    };
+
+    static constexpr std::size_t HeaderSize = (sizeof(ArenaHeader) + Alignment - 1) & ~(Alignment - 1);
+
+    std::byte* _buffer = nullptr;
+    std::size_t _capacity = 0;
+
+    [[nodiscard]] ArenaHeader& Header() noexcept
+    { return *reinterpret_cast<ArenaHeader*>(_buffer); }
+
+    [[nodiscard]] const ArenaHeader& Header() const noexcept
+    { return *reinterpret_cast<const ArenaHeader*>(_buffer); }
+
+    void Grow(std::size_t capacity);
+
+    /**
+     * \return The offset of an object living in the buffer, or zero if it lives outside.
+     */
+    [[nodiscard]] ArenaOffset OffsetOf(const void* object) const noexcept;
+
+    [[nodiscard]] static std::size_t SizeClass(std::size_t size) noexcept;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Bounded queue from one producer thread to one consumer thread, without lock.
+ * The producer only writes _tail and the consumer only writes _head, each reading the index of the other with
+ * acquire ordering, so a slot is published by the release store of the index that covers it. Each side caches the
+ * index of the other and reloads it only when the ring looks full or empty, so that the two threads do not share a
+ * cache line on every operation.
+ *
+ * The class has the following members:
+ * - _slots: The values, Capacity being a power of two for the indices to wrap with a mask.
+ * - _head: The number of values popped, written by the consumer.
+ * - _tail: The number of values pushed, written by the producer.
+ * - _cachedHead: The last _head seen by the producer.
+ * - _cachedTail: The last _tail seen by the consumer.
+ *
+ * \n Note : Exactly one thread may push and one thread may pop. T is copied in and out of its slot.
+ */
+template<typename T, std::size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    /**
+     * @brief Pushes a copy of value, on the producer thread.
+     * @return false if the ring is full, the value is not pushed then.
+     */
+    bool Push(const T& value) noexcept
+    {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cachedHead == Capacity)
+        {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead == Capacity)
+            {
+                return false;
+            }
+        }
+        _slots[tail & (Capacity - 1)] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pops the oldest value, on the consumer thread.
+     * @return false if the ring is empty, value is left as it is then.
+     */
+    bool Pop(T& value) noexcept
+    {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail)
+        {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail)
+            {
+                return false;
+            }
+        }
+        value = _slots[head & (Capacity - 1)];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept
+    { return Capacity; }
+
+private:
+    std::array<T, Capacity> _slots{};
+    alignas(64) std::atomic<std::size_t> _head{0};
+    alignas(64) std::atomic<std::size_t> _tail{0};
+    alignas(64) std::size_t _cachedHead = 0;
+    alignas(64) std::size_t _cachedTail = 0;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief Estimates how many frames the local peer of a lockstep simulation runs ahead of the remote one, and slows
+ * down the local ticks while it is ahead.
+ * Each tick, the local advantage is the local frame minus the frame the remote is estimated to be at: its last
+ * received frame, plus the frames it ran while that input travelled, half a round trip. The remote computes its own
+ * advantage the same way and sends it with its inputs. Both are averaged over a window of ticks, and half of their
+ * difference is the advantage to give up for both peers to meet halfway: the peer ahead stretches its ticks by
+ * TimeScale until it is gone, the one behind keeps its rate.
+ *
+ * The class has the following members:
+ * - _step: The duration of a tick, in seconds.
+ * - _localAdvantages, _remoteAdvantages: The advantages of the last WindowSize ticks, in frames.
+ * - _sampleCount: The number of ticks recorded in the window, up to WindowSize.
+ * - _nextSample: The slot of the window overwritten by the next tick.
+ * - _remoteAdvantage: The last advantage received from the remote.
+ *
+ * \n Note : A peer stays at the full rate until it received an input of the remote, since it has no estimate before.
+ */
+class TimeSync
+{
+public:
+    static constexpr std::size_t WindowSize = 32;
+    /**
+     * @brief The advantage in frames, averaged over the window, under which the ticks are not stretched, so that the
+     * jitter of the link does not slow the ticks down.
+     */
+    static constexpr float DeadZone = 0.5f;
+    /**
+     * @brief How much longer a tick lasts per frame of advantage.
+     */
+    static constexpr float DilationPerFrame = 0.02f;
+    /**
+     * @brief The most a tick is stretched, a tenth of a tick given up for every ten ticks at most.
+     */
+    static constexpr float MaxDilation = 0.1f;
+
+    explicit TimeSync(double step) noexcept : _step(step)
+    {}
+
+    /**
+     * @brief Records the advantage of a tick.
+     * @param localFrame The frame the local peer just ran.
+     * @param lastRemoteFrame The last frame received from the remote, negative if none.
+     * @param roundTripTime The round trip time to the remote, in seconds.
+     */
+    void Update(int localFrame, int lastRemoteFrame, double roundTripTime) noexcept;
+
+    /**
+     * @brief Sets the advantage the remote estimated of itself, received with its inputs.
+     */
+    void SetRemoteAdvantage(float remoteAdvantage) noexcept
+    { _remoteAdvantage = remoteAdvantage; }
+
+    /**
+     * @return The advantage of the last tick, in frames, to send to the remote.
+     */
+    [[nodiscard]] float LocalAdvantage() const noexcept;
+
+    /**
+     * @return Half the difference of the averaged local and remote advantages, in frames: positive when the local
+     * peer is ahead.
+     */
+    [[nodiscard]] float Advantage() const noexcept;
+
+    /**
+     * @return The factor to scale the elapsed time by before scheduling the ticks, below one while the local peer
+     * is ahead.
+     */
+    [[nodiscard]] double TimeScale() const noexcept;
+
+    /**
+     * @brief Forgets the estimates, when a game starts over.
+     */
+    void Reset() noexcept;
+
+private:
+    double _step;
+    std::array<float, WindowSize> _localAdvantages{};
+    std::array<float, WindowSize> _remoteAdvantages{};
+    std::size_t _sampleCount = 0;
+    std::size_t _nextSample = 0;
+    float _remoteAdvantage = 0.f;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Hands the latest value written by one thread to one reading thread, without lock nor wait.
+ * The three buffers are owned in turn by the writer, the reader, and the exchange between them. The writer fills its
+ * buffer and publishes it by swapping it with the exchange one, the reader takes the exchange buffer when a new one
+ * was published. Neither thread ever waits for the other: the writer overwrites a value the reader skipped, and the
+ * reader keeps its last value while nothing new is published.
+ *
+ * The class has the following members:
+ * - _buffers: The three values.
+ * - _exchange: The index of the exchange buffer, with NewBit set when it holds a value the reader has not taken.
+ * - _writeIndex: The buffer of the writer, only used by the writer thread.
+ * - _readIndex: The buffer of the reader, only used by the reader thread.
+ *
+ * \n Note : Exactly one thread may write and one thread may read. The value is copied by the writer only, in place.
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+    /**
+     * @return The buffer to fill before Publish, it still holds the value written three publications ago.
+     */
+    [[nodiscard]] T& WriteBuffer() noexcept
+    { return _buffers[_writeIndex]; }
+
+    /**
+     * @brief Makes the write buffer the latest value, and takes a free buffer to write the next one.
+     */
+    void Publish() noexcept
+    {
+        const auto previous = _exchange.exchange(static_cast<std::uint8_t>(_writeIndex | NewBit),
+                                                 std::memory_order_acq_rel);
+        _writeIndex = previous & IndexMask;
+    }
+
+    /**
+     * @brief Takes the latest published value, if any since the last call.
+     * @return true if ReadBuffer changed.
+     */
+    bool Update() noexcept
+    {
+        if ((_exchange.load(std::memory_order_relaxed) & NewBit) == 0)
+        {
+            return false;
+        }
+        const auto previous = _exchange.exchange(_readIndex, std::memory_order_acq_rel);
+        _readIndex = previous & IndexMask;
+        return true;
+    }
+
+    /**
+     * @return The value taken by the last Update, a default value before the first publication.
+     */
+    [[nodiscard]] const T& ReadBuffer() const noexcept
+    { return _buffers[_readIndex]; }
+
+private:
+    static constexpr std::uint8_t NewBit = 4;
+    static constexpr std::uint8_t IndexMask = 3;
+
+    std::array<T, 3> _buffers{};
+    alignas(64) std::atomic<std::uint8_t> _exchange{1};
+    alignas(64) std::uint8_t _writeIndex = 0;
+    alignas(64) std::uint8_t _readIndex = 2;
+};
@@ -1,12 +1,44 @@
 #pragma once
 
+#include "Allocator.h"
+
 #include <algorithm>
+#include <new>
+#include <utility>
+
+/**
+ * \brief Deleter of the objects made with new, the default one of UniquePtr.
+ */
+template<typename T>
+struct DefaultDelete
+{
+    void operator()(T* ptr) const noexcept
+    {
+        delete ptr;
+    }
+};
 
+/**
+ * \brief Deleter of the objects built in the memory of an Allocator: destroys the object, then gives its memory back.
+ */
 template<typename T>
+struct AllocatorDelete
+{
+    Allocator* allocator = nullptr;
+
+    void operator()(T* ptr) const noexcept
+    {
+        ptr->~T();
+        allocator->Deallocate(ptr);
+    }
+};
+
+template<typename T, typename Deleter = DefaultDelete<T>>
 class UniquePtr
 {
 private :
     T* _ptr = nullptr;
+    Deleter _deleter{};
 
 public :
     constexpr UniquePtr() noexcept = default;
@@ -16,34 +48,47 @@ public :
         _ptr = ptr;
     }
 
+    constexpr UniquePtr(T* ptr, Deleter deleter) noexcept : _ptr(ptr), _deleter(deleter)
+    {}
+
     ~UniquePtr() noexcept
     {
-        delete _ptr;
+        if (_ptr != nullptr)
+        {
+            _deleter(_ptr);
+        }
     }
 
 
     //Destroy Copy Constructor
-    UniquePtr(const UniquePtr<T>&) = delete;
+    UniquePtr(const UniquePtr&) = delete;
 
     //Copy
-    constexpr UniquePtr<T>& operator=(const UniquePtr<T>&) noexcept = delete;
+    constexpr UniquePtr& operator=(const UniquePtr&) noexcept = delete;
 
     //Move Constructor
-    constexpr UniquePtr(UniquePtr<T>&& other) noexcept
+    constexpr UniquePtr(UniquePtr&& other) noexcept
     {
 //        _ptr = other._ptr;
 //        other._ptr = nullptr;
         //In one line
         std::swap(_ptr, other . _ptr);
+        std::swap(_deleter, other . _deleter);
     };
 
     //Move Assignment
-    constexpr UniquePtr<T>& operator=(UniquePtr<T>&& other) noexcept
+    constexpr UniquePtr& operator=(UniquePtr&& other) noexcept
     {
         std::swap(_ptr, other . _ptr);
+        std::swap(_deleter, other . _deleter);
         return *this;
     };
 
+    constexpr T* Get() const noexcept
+    {
+        return _ptr;
+    }
+
     constexpr T& operator*() const noexcept
     {
         return *_ptr;
@@ -53,10 +98,35 @@ public :
     {
         return _ptr;
     }
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return _ptr != nullptr;
+    }
 };
 
 template<typename T>
 UniquePtr<T> MakeUnique(T value) noexcept
 {
     return UniquePtr<T>(new T(value));
-}
\ No newline at end of file
+}
+
+/**
+ * \brief Builds an object in the memory of an allocator, given back to it when the UniquePtr is destroyed.
+ * \n Note : The allocator must outlive the pointer.
+ */
+template<typename T, typename... Args>
+UniquePtr<T, AllocatorDelete<T>> AllocateUnique(Allocator& allocator, Args&& ... args)
+{
+    auto* memory = allocator.Allocate(sizeof(T), alignof(T));
+    try
+    {
+        return UniquePtr<T, AllocatorDelete<T>>(new(memory) T(std::forward<Args>(args)...),
+                                                AllocatorDelete<T>{&allocator});
+    }
+    catch (...)
+    {
+        allocator.Deallocate(memory);
+        throw;
+    }
+}
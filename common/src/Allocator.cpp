@@ -0,0 +1,626 @@
+#include "Allocator.h"
+
+#include <cstring>
+#include <mutex>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+    std::mutex& RegistryMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::vector<const AllocationRecorder*>& Registry()
+    {
+        static std::vector<const AllocationRecorder*> registry;
+        return registry;
+    }
+}
+
+AllocationRecorder::~AllocationRecorder()
+{
+    if (!_tag)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    auto& registry = Registry();
+    registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+}
+
+void AllocationRecorder::SetTag(const char* tag)
+{
+    if (!_tag)
+    {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        Registry().push_back(this);
+    }
+    _tag = tag;
+}
+
+AllocatorStats AllocationRecorder::Stats() const noexcept
+{
+    return AllocatorStats{
+            _tag,
+            _bytesInUse.load(std::memory_order_relaxed),
+            _peakBytes.load(std::memory_order_relaxed),
+            _allocationCount.load(std::memory_order_relaxed),
+            _failedCount.load(std::memory_order_relaxed)
+    };
+}
+
+std::vector<AllocatorStats> CollectAllocatorStats()
+{
+    std::vector<AllocatorStats> stats;
+    {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        for (const auto* recorder: Registry())
+        {
+            const auto allocatorStats = recorder->Stats();
+            auto it = std::find_if(stats.begin(), stats.end(), [&allocatorStats](const AllocatorStats& tagStats)
+            {
+                return std::strcmp(tagStats.tag, allocatorStats.tag) == 0;
+            });
+            if (it == stats.end())
+            {
+                stats.push_back(allocatorStats);
+                continue;
+            }
+            it->bytesInUse += allocatorStats.bytesInUse;
+            it->peakBytes += allocatorStats.peakBytes;
+            it->allocationCount += allocatorStats.allocationCount;
+            it->failedCount += allocatorStats.failedCount;
+        }
+    }
+
+    std::sort(stats.begin(), stats.end(), [](const AllocatorStats& a, const AllocatorStats& b)
+    {
+        return std::strcmp(a.tag, b.tag) < 0;
+    });
+    return stats;
+}
+
+namespace
+{
+    constexpr std::size_t FreeFlag = 1;
+    constexpr std::size_t PrevFreeFlag = 2;
+    constexpr std::size_t FlagsMask = FreeFlag | PrevFreeFlag;
+
+    /**
+     * \brief Index of the highest set bit, value must not be zero.
+     */
+    std::size_t HighestBit(std::size_t value) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return index;
+#else
+        return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(value);
+#endif
+    }
+
+    /**
+     * \brief Index of the lowest set bit, value must not be zero.
+     */
+    std::size_t LowestBit(std::uint32_t value) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, value);
+        return index;
+#else
+        return __builtin_ctz(value);
+#endif
+    }
+
+    /**
+     * \brief Gives the lists holding the blocks of a size.
+     */
+    void MapSize(std::size_t size, std::size_t& firstLevel, std::size_t& secondLevel) noexcept
+    {
+        if (size < TlsfAllocator::SmallBlockSize)
+        {
+            firstLevel = 0;
+            secondLevel = size / (TlsfAllocator::SmallBlockSize / TlsfAllocator::SecondLevelCount);
+            return;
+        }
+        const auto highestBit = HighestBit(size);
+        secondLevel = (size >> (highestBit - TlsfAllocator::SecondLevelCountLog2)) ^ TlsfAllocator::SecondLevelCount;
+        firstLevel = highestBit - (TlsfAllocator::FirstLevelShift - 1);
+    }
+}
+
+TlsfAllocator::TlsfAllocator(std::size_t capacity, const char* tag)
+{
+    static_assert(offsetof(TlsfBlock, nextFree) == BlockHeaderSize);
+
+    // The buffer holds the first block header, its payload, and a used sentinel header ending the physical list.
+    _capacity = capacity - capacity % BlockAlignment;
+    if (_capacity < 2 * BlockHeaderSize + MinBlockSize || _capacity >= (std::size_t(1) << FirstLevelMax))
+    {
+        throw std::invalid_argument("Invalid capacity for TlsfAllocator");
+    }
+    _buffer = new char[_capacity + BlockAlignment];
+    Reset();
+
+    if (tag)
+    {
+        SetTag(tag);
+    }
+}
+
+TlsfAllocator::~TlsfAllocator()
+{
+    delete[] _buffer;
+}
+
+void* TlsfAllocator::Allocate(std::size_t size, std::size_t alignment)
+{
+    size = std::max(AlignSize(size, BlockAlignment), MinBlockSize);
+    alignment = std::max(alignment, BlockAlignment);
+
+    // A stricter alignment searches for room to cut a free block in front of the aligned payload.
+    const auto gapSize = BlockHeaderSize + MinBlockSize;
+    const auto searchSize = alignment == BlockAlignment ? size : size + alignment + gapSize;
+
+    TlsfBlock* block = searchSize < (std::size_t(1) << FirstLevelMax) ? FindFreeBlock(searchSize) : nullptr;
+    if (!block)
+    {
+        RecordFailure();
+        throw std::runtime_error("TlsfAllocator out of memory");
+    }
+    RemoveFreeBlock(block);
+
+    if (alignment > BlockAlignment)
+    {
+        char* payload = reinterpret_cast<char*>(block) + BlockHeaderSize;
+        char* alignedPayload = AlignForward(payload, alignment);
+        if (alignedPayload != payload && static_cast<std::size_t>(alignedPayload - payload) < gapSize)
+        {
+            alignedPayload = AlignForward(payload + gapSize, alignment);
+        }
+
+        if (alignedPayload != payload)
+        {
+            // The gap becomes a free block, its previous physical block is used: free blocks are always merged.
+            const auto gap = static_cast<std::size_t>(alignedPayload - payload);
+            auto* alignedBlock = reinterpret_cast<TlsfBlock*>(alignedPayload - BlockHeaderSize);
+            alignedBlock -> prevPhysical = block;
+            alignedBlock -> sizeAndFlags = ((block -> sizeAndFlags & ~FlagsMask) - gap) | FreeFlag | PrevFreeFlag;
+            auto* nextBlock = reinterpret_cast<TlsfBlock*>(alignedPayload + (alignedBlock -> sizeAndFlags & ~FlagsMask));
+            nextBlock -> prevPhysical = alignedBlock;
+
+            block -> sizeAndFlags = (gap - BlockHeaderSize) | (block -> sizeAndFlags & PrevFreeFlag) | FreeFlag;
+            InsertFreeBlock(block);
+            block = alignedBlock;
+        }
+    }
+
+    SplitBlock(block, size);
+
+    // Marks the block as used, in its own flags and in the flags of the next physical block.
+    block -> sizeAndFlags &= ~FreeFlag;
+    const auto blockSize = block -> sizeAndFlags & ~FlagsMask;
+    auto* nextBlock = reinterpret_cast<TlsfBlock*>(reinterpret_cast<char*>(block) + BlockHeaderSize + blockSize);
+    nextBlock -> sizeAndFlags &= ~PrevFreeFlag;
+
+    RecordAllocation(blockSize);
+    return reinterpret_cast<char*>(block) + BlockHeaderSize;
+}
+
+void TlsfAllocator::Deallocate(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    auto* block = reinterpret_cast<TlsfBlock*>(static_cast<char*>(ptr) - BlockHeaderSize);
+    RecordDeallocation(block -> sizeAndFlags & ~FlagsMask);
+
+    block -> sizeAndFlags |= FreeFlag;
+    block = MergeFreeNeighbours(block);
+    auto* nextBlock = reinterpret_cast<TlsfBlock*>(
+            reinterpret_cast<char*>(block) + BlockHeaderSize + (block -> sizeAndFlags & ~FlagsMask));
+    nextBlock -> sizeAndFlags |= PrevFreeFlag;
+    InsertFreeBlock(block);
+}
+
+void TlsfAllocator::Reset()
+{
+    _firstLevelBitmap = 0;
+    std::fill(std::begin(_secondLevelBitmaps), std::end(_secondLevelBitmaps), 0);
+    for (auto& lists: _freeBlocks)
+    {
+        std::fill(std::begin(lists), std::end(lists), nullptr);
+    }
+
+    auto* block = reinterpret_cast<TlsfBlock*>(AlignForward(_buffer, BlockAlignment));
+    const auto blockSize = _capacity - 2 * BlockHeaderSize;
+    block -> prevPhysical = nullptr;
+    block -> sizeAndFlags = blockSize | FreeFlag;
+
+    auto* sentinel = reinterpret_cast<TlsfBlock*>(reinterpret_cast<char*>(block) + BlockHeaderSize + blockSize);
+    sentinel -> prevPhysical = block;
+    sentinel -> sizeAndFlags = PrevFreeFlag;
+
+    InsertFreeBlock(block);
+    RecordReset();
+}
+
+void TlsfAllocator::InsertFreeBlock(TlsfBlock* block) noexcept
+{
+    std::size_t firstLevel, secondLevel;
+    MapSize(block -> sizeAndFlags & ~FlagsMask, firstLevel, secondLevel);
+
+    TlsfBlock*& head = _freeBlocks[firstLevel][secondLevel];
+    block -> nextFree = head;
+    block -> prevFree = nullptr;
+    if (head)
+    {
+        head -> prevFree = block;
+    }
+    head = block;
+
+    _firstLevelBitmap |= 1u << firstLevel;
+    _secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+}
+
+void TlsfAllocator::RemoveFreeBlock(TlsfBlock* block) noexcept
+{
+    std::size_t firstLevel, secondLevel;
+    MapSize(block -> sizeAndFlags & ~FlagsMask, firstLevel, secondLevel);
+
+    if (block -> nextFree)
+    {
+        block -> nextFree -> prevFree = block -> prevFree;
+    }
+    if (block -> prevFree)
+    {
+        block -> prevFree -> nextFree = block -> nextFree;
+        return;
+    }
+
+    _freeBlocks[firstLevel][secondLevel] = block -> nextFree;
+    if (!block -> nextFree)
+    {
+        _secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+        if (!_secondLevelBitmaps[firstLevel])
+        {
+            _firstLevelBitmap &= ~(1u << firstLevel);
+        }
+    }
+}
+
+TlsfAllocator::TlsfBlock* TlsfAllocator::FindFreeBlock(std::size_t size) noexcept
+{
+    // Rounds the size up to the next list, so any block of the list found is big enough.
+    if (size >= SmallBlockSize)
+    {
+        size += (std::size_t(1) << (HighestBit(size) - SecondLevelCountLog2)) - 1;
+    }
+    std::size_t firstLevel, secondLevel;
+    MapSize(size, firstLevel, secondLevel);
+    if (firstLevel >= FirstLevelCount)
+    {
+        return nullptr;
+    }
+
+    auto secondLevelMap = _secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+    if (!secondLevelMap)
+    {
+        const auto firstLevelMap = firstLevel + 1 < 32 ? _firstLevelBitmap & (~0u << (firstLevel + 1)) : 0u;
+        if (!firstLevelMap)
+        {
+            return nullptr;
+        }
+        firstLevel = LowestBit(firstLevelMap);
+        secondLevelMap = _secondLevelBitmaps[firstLevel];
+    }
+    return _freeBlocks[firstLevel][LowestBit(secondLevelMap)];
+}
+
+void TlsfAllocator::SplitBlock(TlsfBlock* block, std::size_t size) noexcept
+{
+    const auto blockSize = block -> sizeAndFlags & ~FlagsMask;
+    if (blockSize < size + BlockHeaderSize + MinBlockSize)
+    {
+        return;
+    }
+
+    auto* remaining = reinterpret_cast<TlsfBlock*>(reinterpret_cast<char*>(block) + BlockHeaderSize + size);
+    remaining -> prevPhysical = block;
+    remaining -> sizeAndFlags = (blockSize - size - BlockHeaderSize) | FreeFlag;
+    auto* nextBlock = reinterpret_cast<TlsfBlock*>(
+            reinterpret_cast<char*>(remaining) + BlockHeaderSize + (remaining -> sizeAndFlags & ~FlagsMask));
+    nextBlock -> prevPhysical = remaining;
+    nextBlock -> sizeAndFlags |= PrevFreeFlag;
+
+    block -> sizeAndFlags = size | (block -> sizeAndFlags & FlagsMask);
+    InsertFreeBlock(remaining);
+}
+
+TlsfAllocator::TlsfBlock* TlsfAllocator::MergeFreeNeighbours(TlsfBlock* block) noexcept
+{
+    auto* nextBlock = reinterpret_cast<TlsfBlock*>(
+            reinterpret_cast<char*>(block) + BlockHeaderSize + (block -> sizeAndFlags & ~FlagsMask));
+    if (nextBlock -> sizeAndFlags & FreeFlag)
+    {
+        RemoveFreeBlock(nextBlock);
+        block -> sizeAndFlags += BlockHeaderSize + (nextBlock -> sizeAndFlags & ~FlagsMask);
+    }
+
+    if (block -> sizeAndFlags & PrevFreeFlag)
+    {
+        auto* prevBlock = block -> prevPhysical;
+        RemoveFreeBlock(prevBlock);
+        prevBlock -> sizeAndFlags += BlockHeaderSize + (block -> sizeAndFlags & ~FlagsMask);
+        block = prevBlock;
+    }
+
+    nextBlock = reinterpret_cast<TlsfBlock*>(
+            reinterpret_cast<char*>(block) + BlockHeaderSize + (block -> sizeAndFlags & ~FlagsMask));
+    nextBlock -> prevPhysical = block;
+    return block;
+}
+
+namespace
+{
+    struct Magazine
+    {
+        std::size_t count = 0;
+        void* blocks[ThreadCachePoolAllocator::MagazineSize]{};
+        std::atomic<Magazine*> next{nullptr};
+    };
+
+    /**
+     * \brief Treiber stack of magazines. The head packs a pointer and a tag counting the pops, so a magazine popped
+     * and pushed back between the read and the swap of another thread makes its swap fail (ABA problem).
+     * \n Note : A magazine is never deleted before the depot, reading the next of a stale head is always safe.
+     */
+    class MagazineStack
+    {
+    public:
+        void Push(Magazine* magazine) noexcept
+        {
+            auto head = _head.load(std::memory_order_relaxed);
+            do
+            {
+                magazine->next.store(PointerOf(head), std::memory_order_relaxed);
+            } while (!_head.compare_exchange_weak(head, Pack(magazine, TagOf(head)),
+                                                  std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        [[nodiscard]] Magazine* Pop() noexcept
+        {
+            auto head = _head.load(std::memory_order_acquire);
+            while (PointerOf(head))
+            {
+                auto* next = PointerOf(head)->next.load(std::memory_order_relaxed);
+                if (_head.compare_exchange_weak(head, Pack(next, TagOf(head) + 1),
+                                                std::memory_order_acquire, std::memory_order_acquire))
+                {
+                    return PointerOf(head);
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        // User space addresses fit in 48 bits on 64-bit targets.
+        static constexpr std::uint64_t PointerBits = sizeof(void*) == 8 ? 48 : 32;
+        static constexpr std::uint64_t PointerMask = (std::uint64_t(1) << PointerBits) - 1;
+
+        std::atomic<std::uint64_t> _head{0};
+
+        static std::uint64_t Pack(Magazine* magazine, std::uint64_t tag) noexcept
+        {
+            return (tag << PointerBits) | reinterpret_cast<std::uintptr_t>(magazine);
+        }
+
+        static Magazine* PointerOf(std::uint64_t head) noexcept
+        {
+            return reinterpret_cast<Magazine*>(static_cast<std::uintptr_t>(head & PointerMask));
+        }
+
+        static std::uint64_t TagOf(std::uint64_t head) noexcept
+        {
+            return head >> PointerBits;
+        }
+    };
+}
+
+struct ThreadCachePoolAllocator::Depot
+{
+    std::size_t blockSize;
+    std::size_t alignment;
+    std::size_t blocksPerSlab;
+    std::atomic<bool> isAlive{true};
+
+    MagazineStack fullMagazines;
+    MagazineStack emptyMagazines;
+
+    std::mutex slabMutex;
+    std::vector<std::unique_ptr<char[]>> slabs;
+    std::vector<std::unique_ptr<Magazine>> magazines;
+
+    Magazine* NewMagazine()
+    {
+        if (auto* magazine = emptyMagazines.Pop())
+        {
+            return magazine;
+        }
+        std::lock_guard<std::mutex> lock(slabMutex);
+        magazines.push_back(std::make_unique<Magazine>());
+        return magazines.back().get();
+    }
+};
+
+namespace
+{
+    struct ThreadCache
+    {
+        std::shared_ptr<ThreadCachePoolAllocator::Depot> depot;
+        Magazine* loaded;
+        Magazine* previous;
+    };
+
+    /**
+     * \brief The magazines of a thread, one pair per pool it used. They go back to their depot when the thread exits.
+     */
+    struct ThreadCaches
+    {
+        std::vector<ThreadCache> caches;
+
+        ~ThreadCaches()
+        {
+            for (auto& cache: caches)
+            {
+                Release(cache);
+            }
+        }
+
+        static void Release(ThreadCache& cache) noexcept
+        {
+            for (auto* magazine: {cache.loaded, cache.previous})
+            {
+                (magazine->count ? cache.depot->fullMagazines : cache.depot->emptyMagazines).Push(magazine);
+            }
+        }
+
+        ThreadCache& Find(const std::shared_ptr<ThreadCachePoolAllocator::Depot>& depot)
+        {
+            for (auto& cache: caches)
+            {
+                if (cache.depot == depot)
+                {
+                    return cache;
+                }
+            }
+
+            // On a miss, drops the caches of destroyed pools before adding the new one.
+            caches.erase(std::remove_if(caches.begin(), caches.end(), [](ThreadCache& cache)
+            {
+                if (cache.depot->isAlive.load(std::memory_order_relaxed))
+                {
+                    return false;
+                }
+                Release(cache);
+                return true;
+            }), caches.end());
+            caches.push_back(ThreadCache{depot, depot->NewMagazine(), depot->NewMagazine()});
+            return caches.back();
+        }
+    };
+
+    thread_local ThreadCaches threadCaches;
+}
+
+ThreadCachePoolAllocator::ThreadCachePoolAllocator(std::size_t blockSize, std::size_t alignment,
+                                                   std::size_t blocksPerSlab, const char* tag)
+        : _depot(std::make_shared<Depot>())
+{
+    _depot->alignment = std::max(alignment, alignof(void*));
+    _depot->blockSize = AlignSize(std::max(blockSize, sizeof(void*)), _depot->alignment);
+    // Whole magazines only, a new slab fills them all.
+    _depot->blocksPerSlab = AlignSize(std::max(blocksPerSlab, MagazineSize), MagazineSize);
+
+    if (tag)
+    {
+        SetTag(tag);
+    }
+}
+
+ThreadCachePoolAllocator::~ThreadCachePoolAllocator()
+{
+    _depot->isAlive.store(false, std::memory_order_relaxed);
+}
+
+std::size_t ThreadCachePoolAllocator::BlockSize() const noexcept
+{
+    return _depot->blockSize;
+}
+
+void* ThreadCachePoolAllocator::Allocate(std::size_t size, std::size_t alignment)
+{
+    if (size > _depot->blockSize || alignment > _depot->alignment)
+    {
+        RecordFailure();
+        throw std::runtime_error("Invalid allocation size for ThreadCachePoolAllocator");
+    }
+
+    auto& cache = threadCaches.Find(_depot);
+    if (cache.loaded->count == 0)
+    {
+        if (cache.previous->count != 0)
+        {
+            std::swap(cache.loaded, cache.previous);
+        }
+        else
+        {
+            auto* full = _depot->fullMagazines.Pop();
+            while (!full)
+            {
+                GrowSlab(*_depot);
+                full = _depot->fullMagazines.Pop();
+            }
+            _depot->emptyMagazines.Push(cache.previous);
+            cache.previous = cache.loaded;
+            cache.loaded = full;
+        }
+    }
+    return cache.loaded->blocks[--cache.loaded->count];
+}
+
+void ThreadCachePoolAllocator::Deallocate(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    auto& cache = threadCaches.Find(_depot);
+    if (cache.loaded->count == MagazineSize)
+    {
+        if (cache.previous->count == 0)
+        {
+            std::swap(cache.loaded, cache.previous);
+        }
+        else
+        {
+            _depot->fullMagazines.Push(cache.previous);
+            cache.previous = cache.loaded;
+            cache.loaded = _depot->NewMagazine();
+        }
+    }
+    cache.loaded->blocks[cache.loaded->count++] = ptr;
+}
+
+void ThreadCachePoolAllocator::GrowSlab(Depot& depot)
+{
+    const auto slabSize = depot.blockSize * depot.blocksPerSlab;
+    auto slab = std::make_unique<char[]>(slabSize + depot.alignment);
+    char* blocks = AlignForward(slab.get(), depot.alignment);
+
+    for (std::size_t i = 0; i < depot.blocksPerSlab; i += MagazineSize)
+    {
+        auto* magazine = depot.NewMagazine();
+        for (std::size_t j = 0; j < MagazineSize; j++)
+        {
+            magazine->blocks[j] = blocks + (i + j) * depot.blockSize;
+        }
+        magazine->count = MagazineSize;
+        depot.fullMagazines.Push(magazine);
+    }
+
+    std::lock_guard<std::mutex> lock(depot.slabMutex);
+    depot.slabs.push_back(std::move(slab));
+    RecordAllocation(slabSize);
+}
@@ -0,0 +1,343 @@
+#include "AssetArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool AssetArchiveWriter::AddImage(std::string_view name, const void* pixels, std::uint32_t width,
+                                  std::uint32_t height, float bakedScale)
+{
+    AssetEntry entry;
+    entry.type = AssetType::Image;
+    entry.width = width;
+    entry.height = height;
+    entry.bakedScale = bakedScale;
+    entry.size = static_cast<std::uint64_t>(width) * height * 4;
+    return AddEntry(name, entry, pixels);
+}
+
+bool AssetArchiveWriter::AddFile(std::string_view name, const void* data, std::size_t size)
+{
+    AssetEntry entry;
+    entry.type = AssetType::File;
+    entry.size = size;
+    return AddEntry(name, entry, data);
+}
+
+bool AssetArchiveWriter::AddAtlas(std::string_view name, const std::vector<AtlasSprite>& sprites)
+{
+    if (!IsNameFree(name))
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < sprites.size(); i++)
+    {
+        const auto isSameName = [&sprites, i](const AtlasSprite& other)
+        {
+            return other.name == sprites[i].name;
+        };
+        if (!IsNameFree(sprites[i].name) || sprites[i].name == name ||
+            std::any_of(sprites.begin(), sprites.begin() + i, isSameName))
+        {
+            return false;
+        }
+    }
+
+    std::vector<std::size_t> order(sprites.size());
+    std::uint64_t area = 0;
+    std::uint32_t widestSprite = 1;
+    for (std::size_t i = 0; i < sprites.size(); i++)
+    {
+        order[i] = i;
+        area += static_cast<std::uint64_t>(sprites[i].width + AtlasPadding) * (sprites[i].height + AtlasPadding);
+        widestSprite = std::max(widestSprite, sprites[i].width + AtlasPadding);
+    }
+    std::sort(order.begin(), order.end(), [&sprites](std::size_t a, std::size_t b)
+    {
+        return sprites[a].height > sprites[b].height;
+    });
+
+    // A power of two wide enough for the widest sprite and for a square holding them all, the shelves grow downward.
+    std::uint32_t width = 1;
+    while (width < widestSprite || static_cast<std::uint64_t>(width) * width < area)
+    {
+        width *= 2;
+    }
+
+    std::vector<AtlasRegion> regions(sprites.size());
+    std::uint32_t x = 0;
+    std::uint32_t shelfY = 0;
+    std::uint32_t shelfHeight = 0;
+    for (const auto index: order)
+    {
+        const auto& sprite = sprites[index];
+        if (x + sprite.width + AtlasPadding > width)
+        {
+            x = 0;
+            shelfY += shelfHeight;
+            shelfHeight = 0;
+        }
+        regions[index] = AtlasRegion{0, x + AtlasPadding / 2, shelfY + AtlasPadding / 2, 0};
+        x += sprite.width + AtlasPadding;
+        shelfHeight = std::max(shelfHeight, sprite.height + AtlasPadding);
+    }
+    const auto height = std::max(shelfY + shelfHeight, 1u);
+
+    std::vector<std::byte> pixels(static_cast<std::size_t>(width) * height * 4);
+    for (std::size_t i = 0; i < sprites.size(); i++)
+    {
+        const auto rowSize = static_cast<std::size_t>(sprites[i].width) * 4;
+        const auto* source = static_cast<const std::byte*>(sprites[i].pixels);
+        for (std::uint32_t row = 0; row < sprites[i].height; row++)
+        {
+            const auto target = ((static_cast<std::size_t>(regions[i].y) + row) * width + regions[i].x) * 4;
+            std::memcpy(pixels.data() + target, source + row * rowSize, rowSize);
+        }
+    }
+
+    const auto atlasIndex = static_cast<std::uint32_t>(_entries.size());
+    AddImage(name, pixels.data(), width, height, 1.f);
+    for (std::size_t i = 0; i < sprites.size(); i++)
+    {
+        AssetEntry entry;
+        entry.type = AssetType::Sprite;
+        entry.width = sprites[i].width;
+        entry.height = sprites[i].height;
+        entry.bakedScale = sprites[i].bakedScale;
+        entry.size = sizeof(AtlasRegion);
+        regions[i].atlasIndex = atlasIndex;
+        AddEntry(sprites[i].name, entry, &regions[i]);
+    }
+    return true;
+}
+
+bool AssetArchiveWriter::IsNameFree(std::string_view name) const noexcept
+{
+    const auto isSameName = [name](const AssetEntry& other)
+    {
+        return name == other.name;
+    };
+    return name.size() <= AssetEntry::MaxNameLength && std::none_of(_entries.begin(), _entries.end(), isSameName);
+}
+
+bool AssetArchiveWriter::AddEntry(std::string_view name, AssetEntry entry, const void* data)
+{
+    if (!IsNameFree(name))
+    {
+        return false;
+    }
+
+    std::memcpy(entry.name, name.data(), name.size());
+    // The offset is relative to the data block here, Write moves it after the entries.
+    entry.offset = (_data.size() + DataAlignment - 1) & ~(DataAlignment - 1);
+    _data.resize(entry.offset + entry.size);
+    if (entry.size > 0)
+    {
+        std::memcpy(_data.data() + entry.offset, data, entry.size);
+    }
+    _entries.push_back(entry);
+    return true;
+}
+
+bool AssetArchiveWriter::Write(const char* path) const
+{
+    AssetArchiveHeader header;
+    header.entryCount = static_cast<std::uint32_t>(_entries.size());
+
+    const auto entriesSize = sizeof(AssetArchiveHeader) + _entries.size() * sizeof(AssetEntry);
+    const auto dataStart = (entriesSize + DataAlignment - 1) & ~(DataAlignment - 1);
+    auto entries = _entries;
+    for (auto& entry: entries)
+    {
+        entry.offset += dataStart;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    const char padding[DataAlignment]{};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()),
+               static_cast<std::streamsize>(entries.size() * sizeof(AssetEntry)));
+    file.write(padding, static_cast<std::streamsize>(dataStart - entriesSize));
+    file.write(reinterpret_cast<const char*>(_data.data()), static_cast<std::streamsize>(_data.size()));
+    return static_cast<bool>(file);
+}
+
+AssetArchive::~AssetArchive()
+{
+    Close();
+}
+
+bool AssetArchive::Open(const char* path) noexcept
+{
+    Close();
+#ifdef _WIN32
+    _file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_file == INVALID_HANDLE_VALUE)
+    {
+        _file = nullptr;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(_file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+    _fileMapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_fileMapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+    _mapping = static_cast<const std::byte*>(MapViewOfFile(_fileMapping, FILE_MAP_READ, 0, 0, 0));
+    _mappingSize = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    const int file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+    struct stat fileStatus{};
+    if (fstat(file, &fileStatus) != 0 || fileStatus.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+    // The mapping keeps its own reference to the file.
+    void* mapping = mmap(nullptr, static_cast<std::size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    _mapping = static_cast<const std::byte*>(mapping);
+    _mappingSize = static_cast<std::size_t>(fileStatus.st_size);
+#endif
+
+    if (!ReadEntries())
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void AssetArchive::Close() noexcept
+{
+#ifdef _WIN32
+    if (_mapping != nullptr)
+    {
+        UnmapViewOfFile(_mapping);
+    }
+    if (_fileMapping != nullptr)
+    {
+        CloseHandle(_fileMapping);
+    }
+    if (_file != nullptr)
+    {
+        CloseHandle(_file);
+    }
+    _fileMapping = nullptr;
+    _file = nullptr;
+#else
+    if (_mapping != nullptr)
+    {
+        munmap(const_cast<std::byte*>(_mapping), _mappingSize);
+    }
+#endif
+    _mapping = nullptr;
+    _mappingSize = 0;
+    _entries = nullptr;
+    _entryCount = 0;
+}
+
+bool AssetArchive::ReadEntries() noexcept
+{
+    if (_mapping == nullptr || _mappingSize < sizeof(AssetArchiveHeader))
+    {
+        return false;
+    }
+
+    AssetArchiveHeader header;
+    std::memcpy(&header, _mapping, sizeof(header));
+    if (header.magic != AssetArchiveHeader::Magic || header.version != AssetArchiveHeader::CurrentVersion ||
+        header.entryCount > (_mappingSize - sizeof(AssetArchiveHeader)) / sizeof(AssetEntry))
+    {
+        return false;
+    }
+
+    const auto* entries = reinterpret_cast<const AssetEntry*>(_mapping + sizeof(AssetArchiveHeader));
+    for (std::size_t i = 0; i < header.entryCount; i++)
+    {
+        const auto& entry = entries[i];
+        if (entry.name[AssetEntry::MaxNameLength] != '\0' || entry.offset > _mappingSize ||
+            entry.size > _mappingSize - entry.offset ||
+            (entry.type == AssetType::Image && entry.size != static_cast<std::uint64_t>(entry.width) * entry.height * 4))
+        {
+            return false;
+        }
+    }
+
+    // The regions are checked once every atlas entry is known to be valid.
+    for (std::size_t i = 0; i < header.entryCount; i++)
+    {
+        const auto& entry = entries[i];
+        if (entry.type != AssetType::Sprite)
+        {
+            continue;
+        }
+
+        AtlasRegion region;
+        if (entry.size != sizeof(AtlasRegion))
+        {
+            return false;
+        }
+        std::memcpy(&region, _mapping + entry.offset, sizeof(region));
+        if (region.atlasIndex >= header.entryCount)
+        {
+            return false;
+        }
+        const auto& atlas = entries[region.atlasIndex];
+        if (atlas.type != AssetType::Image || region.x > atlas.width || entry.width > atlas.width - region.x ||
+            region.y > atlas.height || entry.height > atlas.height - region.y)
+        {
+            return false;
+        }
+    }
+
+    // Only set once checked, Find never sees a broken table.
+    _entries = entries;
+    _entryCount = header.entryCount;
+    return true;
+}
+
+AtlasRegion AssetArchive::Region(const AssetEntry& entry) const noexcept
+{
+    AtlasRegion region;
+    std::memcpy(&region, Data(entry), sizeof(region));
+    return region;
+}
+
+const AssetEntry* AssetArchive::Find(std::string_view name) const noexcept
+{
+    // A few dozen entries, looked up once each at load: a linear search is enough.
+    for (std::size_t i = 0; i < _entryCount; i++)
+    {
+        if (name == _entries[i].name)
+        {
+            return &_entries[i];
+        }
+    }
+    return nullptr;
+}
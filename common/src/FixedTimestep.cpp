@@ -0,0 +1,33 @@
+#include "FixedTimestep.h"
+
+#include <algorithm>
+
+FixedTimestep::FixedTimestep(double step, int maxTicksPerFrame) noexcept :
+        _step(step), _maxTicksPerFrame(std::max(maxTicksPerFrame, 1))
+{}
+
+int FixedTimestep::Advance(double deltaTime) noexcept
+{
+    _accumulator += std::max(deltaTime, 0.0);
+
+    int tickCount = 0;
+    while (_accumulator >= _step && tickCount < _maxTicksPerFrame)
+    {
+        _accumulator -= _step;
+        tickCount++;
+    }
+
+    if (_accumulator >= _step)
+    {
+        // Only the fraction of a tick is kept, so the alpha of this frame is still meaningful.
+        const auto extraTicks = static_cast<double>(static_cast<long long>(_accumulator / _step));
+        _droppedTime += extraTicks * _step;
+        _accumulator -= extraTicks * _step;
+    }
+    return tickCount;
+}
+
+void FixedTimestep::Reset() noexcept
+{
+    _accumulator = 0.0;
+}
@@ -0,0 +1,140 @@
+#include "SimulationArena.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+SimulationArena::SimulationArena(std::size_t capacity, const char* tag)
+{
+    if (tag)
+    {
+        SetTag(tag);
+    }
+    _capacity = std::max(capacity, HeaderSize);
+    _buffer = static_cast<std::byte*>(::operator new(_capacity, std::align_val_t{Alignment}));
+    Reset();
+}
+
+SimulationArena::SimulationArena(const SimulationArena& other) : AllocationRecorder(other)
+{
+    // Only the used prefix is copied, the copy gets a buffer of the same capacity to grow in.
+    _capacity = other._capacity;
+    _buffer = static_cast<std::byte*>(::operator new(_capacity, std::align_val_t{Alignment}));
+    std::memcpy(_buffer, other._buffer, other.UsedSize());
+    RecordBytesInUse(Header().liveSize);
+}
+
+SimulationArena& SimulationArena::operator=(const SimulationArena& other)
+{
+    if (this != &other)
+    {
+        Load(other._buffer, other.UsedSize());
+    }
+    return *this;
+}
+
+SimulationArena::~SimulationArena()
+{
+    ::operator delete(_buffer, std::align_val_t{Alignment});
+}
+
+ArenaOffset SimulationArena::Allocate(std::size_t size)
+{
+    const auto sizeClass = SizeClass(size);
+    if (sizeClass >= ClassCount)
+    {
+        RecordFailure();
+        throw std::length_error("SimulationArena allocation too big");
+    }
+
+    const auto blockSize = std::size_t(1) << (sizeClass + MinClassSizeLog2);
+    auto& freeList = Header().freeLists[sizeClass];
+    if (freeList)
+    {
+        const auto offset = freeList;
+        freeList = *Get<ArenaOffset>(offset);
+        Header().liveSize += static_cast<std::uint32_t>(blockSize);
+        RecordAllocation(blockSize);
+        return offset;
+    }
+
+    const auto offset = static_cast<std::size_t>(Header().usedSize);
+    if (offset + blockSize > std::numeric_limits<ArenaOffset>::max())
+    {
+        RecordFailure();
+        throw std::length_error("SimulationArena out of offsets");
+    }
+    if (offset + blockSize > _capacity)
+    {
+        Grow(std::max(2 * _capacity, offset + blockSize));
+    }
+    Header().usedSize = static_cast<std::uint32_t>(offset + blockSize);
+    Header().liveSize += static_cast<std::uint32_t>(blockSize);
+    RecordAllocation(blockSize);
+    return static_cast<ArenaOffset>(offset);
+}
+
+void SimulationArena::Deallocate(ArenaOffset offset, std::size_t size) noexcept
+{
+    const auto sizeClass = SizeClass(size);
+    auto& freeList = Header().freeLists[sizeClass];
+    *Get<ArenaOffset>(offset) = freeList;
+    freeList = offset;
+
+    const auto blockSize = std::size_t(1) << (sizeClass + MinClassSizeLog2);
+    Header().liveSize -= static_cast<std::uint32_t>(blockSize);
+    RecordDeallocation(blockSize);
+}
+
+void SimulationArena::Reset() noexcept
+{
+    auto& header = Header();
+    header.usedSize = static_cast<std::uint32_t>(HeaderSize);
+    header.liveSize = 0;
+    std::fill(std::begin(header.freeLists), std::end(header.freeLists), 0);
+    RecordReset();
+}
+
+void SimulationArena::Load(const std::byte* data, std::size_t size)
+{
+    if (size > _capacity)
+    {
+        ::operator delete(_buffer, std::align_val_t{Alignment});
+        _buffer = static_cast<std::byte*>(::operator new(size, std::align_val_t{Alignment}));
+        _capacity = size;
+    }
+    std::memcpy(_buffer, data, size);
+    // The live blocks are those of the loaded state.
+    RecordBytesInUse(Header().liveSize);
+}
+
+void SimulationArena::Grow(std::size_t capacity)
+{
+    auto* buffer = static_cast<std::byte*>(::operator new(capacity, std::align_val_t{Alignment}));
+    std::memcpy(buffer, _buffer, UsedSize());
+    ::operator delete(_buffer, std::align_val_t{Alignment});
+    _buffer = buffer;
+    _capacity = capacity;
+}
+
+ArenaOffset SimulationArena::OffsetOf(const void* object) const noexcept
+{
+    const auto* byte = static_cast<const std::byte*>(object);
+    if (std::less<const std::byte*>()(byte, _buffer) || !std::less<const std::byte*>()(byte, _buffer + _capacity))
+    {
+        return 0;
+    }
+    return static_cast<ArenaOffset>(byte - _buffer);
+}
+
+std::size_t SimulationArena::SizeClass(std::size_t size) noexcept
+{
+    std::size_t sizeClass = 0;
+    while ((std::size_t(1) << (sizeClass + MinClassSizeLog2)) < size)
+    {
+        sizeClass++;
+    }
+    return sizeClass;
+}
@@ -0,0 +1,60 @@
+#include "TimeSync.h"
+
+#include <algorithm>
+
+void TimeSync::Update(int localFrame, int lastRemoteFrame, double roundTripTime) noexcept
+{
+    if (lastRemoteFrame < 0)
+    {
+        return;
+    }
+
+    const auto remoteFrame = lastRemoteFrame + std::max(roundTripTime, 0.0) / 2.0 / _step;
+    _localAdvantages[_nextSample] = static_cast<float>(localFrame - remoteFrame);
+    _remoteAdvantages[_nextSample] = _remoteAdvantage;
+    _nextSample = (_nextSample + 1) % WindowSize;
+    _sampleCount = std::min(_sampleCount + 1, WindowSize);
+}
+
+float TimeSync::LocalAdvantage() const noexcept
+{
+    if (_sampleCount == 0)
+    {
+        return 0.f;
+    }
+    return _localAdvantages[(_nextSample + WindowSize - 1) % WindowSize];
+}
+
+float TimeSync::Advantage() const noexcept
+{
+    if (_sampleCount == 0)
+    {
+        return 0.f;
+    }
+
+    float localSum = 0.f;
+    float remoteSum = 0.f;
+    for (std::size_t i = 0; i < _sampleCount; i++)
+    {
+        localSum += _localAdvantages[i];
+        remoteSum += _remoteAdvantages[i];
+    }
+    return (localSum - remoteSum) / static_cast<float>(_sampleCount) / 2.f;
+}
+
+double TimeSync::TimeScale() const noexcept
+{
+    const auto advantage = Advantage();
+    if (advantage < DeadZone)
+    {
+        return 1.0;
+    }
+    return 1.0 / (1.0 + std::min(advantage * DilationPerFrame, MaxDilation));
+}
+
+void TimeSync::Reset() noexcept
+{
+    _sampleCount = 0;
+    _nextSample = 0;
+    _remoteAdvantage = 0.f;
+}
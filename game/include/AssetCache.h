@@ -0,0 +1,202 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetArchive.h"
+#include "raylib_wrapper.h"
+
+/**
+ * @brief Handle of a texture of the AssetCache, shared by every request of
+ * the same path.
+ */
+struct TextureHandle {
+  static constexpr std::uint32_t kInvalidIndex =
+      std::numeric_limits<std::uint32_t>::max();
+
+  std::uint32_t index = kInvalidIndex;
+
+  [[nodiscard]] bool IsValid() const noexcept {
+    return index != kInvalidIndex;
+  }
+};
+
+/**
+ * @brief Loads the textures of the game once per path, in the background.
+ *
+ * A request returns at once. The images packed in the asset archive are
+ * already decoded and only wait for their upload, the loose files are decoded
+ * by worker threads. A sprite packed in an atlas shares the texture of its
+ * atlas and only draws its region of it, so that consecutive sprites of the
+ * atlas do not break the raylib batch. The GPU upload, which needs the context of the window,
+ * is done on the main thread by Update, a few textures per frame, so the
+ * loading hides behind the login menu instead of delaying the first frame.
+ *
+ * Variables:
+ * - archive_: The asset archive searched before the loose files.
+ * - slots_: The textures, indexed by TextureHandle. Main thread only.
+ * - indices_: The handle of each requested path. Main thread only.
+ * - pending_uploads_: Decoded images waiting for their upload. Main thread only.
+ * - workers_: The decoding threads.
+ * - mutex_: Guards jobs_, decoded_ and is_stopping_.
+ * - jobs_: The loose files waiting to be decoded.
+ * - decoded_: The images decoded by the workers, handed to the main thread.
+ */
+class AssetCache {
+ public:
+  /**
+   * @brief Constructs an AssetCache reading from an asset archive.
+   * @param archive Pointer to the asset archive, opened or not.
+   */
+  explicit AssetCache(const AssetArchive* archive) : archive_(archive) {}
+
+  AssetCache(const AssetCache&) = delete;
+  AssetCache& operator=(const AssetCache&) = delete;
+
+  ~AssetCache();
+
+  /**
+   * @brief Starts the decoding threads.
+   */
+  void Init();
+
+  /**
+   * @brief Requests the texture of a path, loaded once however many times it
+   * is requested.
+   * @param path The path of the image, also its name in the asset archive.
+   * @param keep_pixels Keeps the decoded image after the upload, for Pixels.
+   * Honoured as long as the texture is not uploaded yet.
+   * @return The handle of the texture, not ready before a few Update calls.
+   */
+  TextureHandle RequestTexture(const char* path, bool keep_pixels = false);
+
+  /**
+   * @brief Uploads the decoded images to the GPU, on the main thread.
+   * @param max_uploads The most textures uploaded by this call.
+   */
+  void Update(int max_uploads = 4);
+
+  /**
+   * @return The texture, the one of the atlas for a sprite, with an id of 0
+   * until it is uploaded, if its file could not be decoded or if the handle
+   * is not one of this cache.
+   */
+  [[nodiscard]] const raylib::Texture2D& Texture(
+      TextureHandle handle) const noexcept {
+    static const raylib::Texture2D kNoTexture{};
+    return IsKnown(handle) ? slots_[TextureIndex(handle)].texture : kNoTexture;
+  }
+
+  /**
+   * @return The part of Texture holding the image, the whole texture unless
+   * the image is a sprite of an atlas, empty for an unknown handle.
+   */
+  [[nodiscard]] raylib::Rectangle Region(TextureHandle handle) const noexcept;
+
+  /**
+   * @return The scale the asset packer already applied to the pixels, the
+   * texture is drawn at the wanted scale divided by it. 1 for an unknown
+   * handle.
+   */
+  [[nodiscard]] float BakedScale(TextureHandle handle) const noexcept {
+    return IsKnown(handle) ? slots_[handle.index].baked_scale : 1.f;
+  }
+
+  /**
+   * @return The decoded image kept for a request with keep_pixels, or nullptr
+   * until the texture is ready or for an unknown handle.
+   */
+  [[nodiscard]] const raylib::Image* Pixels(
+      TextureHandle handle) const noexcept;
+
+  [[nodiscard]] std::size_t RequestCount() const noexcept {
+    return slots_.size();
+  }
+
+  [[nodiscard]] std::size_t ReadyCount() const noexcept {
+    return ready_count_;
+  }
+
+  [[nodiscard]] bool IsComplete() const noexcept {
+    return ready_count_ == slots_.size();
+  }
+
+  /**
+   * @brief Stops the decoding threads and unloads every texture, before the
+   * window is closed.
+   */
+  void Deinit() noexcept;
+
+ private:
+  struct TextureSlot {
+    raylib::Texture2D texture{};
+    raylib::Image pixels{};
+    // The slot of the atlas holding the pixels of a sprite, and their place.
+    std::uint32_t atlas = TextureHandle::kInvalidIndex;
+    raylib::Rectangle region{};
+    float baked_scale = 1.f;
+    bool is_packed = false;  // The pixels live in the archive mapping.
+    bool keep_pixels = false;
+    bool is_ready = false;
+  };
+
+  struct DecodeJob {
+    std::uint32_t index = 0;
+    std::string path;
+  };
+
+  struct DecodedImage {
+    std::uint32_t index;
+    raylib::Image image;
+  };
+
+  const AssetArchive* archive_ = nullptr;
+
+  std::vector<TextureSlot> slots_;
+  std::unordered_map<std::string, std::uint32_t> indices_;
+  std::deque<DecodedImage> pending_uploads_;
+  std::size_t ready_count_ = 0;
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable has_job_;
+  std::deque<DecodeJob> jobs_;
+  std::vector<DecodedImage> decoded_;
+  bool is_stopping_ = false;
+
+  /**
+   * @return Whether the handle is valid and was returned by this cache.
+   */
+  [[nodiscard]] bool IsKnown(TextureHandle handle) const noexcept {
+    return handle.IsValid() && handle.index < slots_.size();
+  }
+
+  [[nodiscard]] std::uint32_t TextureIndex(
+      TextureHandle handle) const noexcept {
+    const auto atlas = slots_[handle.index].atlas;
+    return atlas != TextureHandle::kInvalidIndex ? atlas : handle.index;
+  }
+
+  TextureHandle RequestSprite(const char* path, const AssetEntry& entry,
+                              bool keep_pixels);
+
+  /**
+   * @brief Marks a sprite ready once its atlas is, copying its pixels out of
+   * the atlas if they are kept.
+   */
+  void CompleteSprite(TextureSlot& sprite);
+
+  /**
+   * @brief Decodes the jobs until the cache is stopped.
+   */
+  void RunWorker();
+
+  void StopWorkers() noexcept;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include "AssetArchive.h"
 #include "GameLogic.h"
 
 /**
@@ -13,7 +14,7 @@
  * - is_audio_playing: Indicates whether audio is currently playing.
  * - audio_volume: The volume level of the audio.
  * - music: The music stream object.
- * - game_logic_: Pointer to the GameLogic object associated with the AudioManager.
+ * - assets_: Pointer to the asset archive the music is streamed from.
  */
 class AudioManager {
  public:
@@ -22,14 +23,15 @@ class AudioManager {
   float audio_volume = 0.22f;  // The volume level of the audio.
 
   /**
-   * @brief Constructs an AudioManager object with a pointer to the game logic.
-   * @param game_logic Pointer to the GameLogic object.
+   * @brief Constructs an AudioManager object with a pointer to the assets.
+   * @param assets Pointer to the asset archive, opened or not.
    */
-  AudioManager(game::GameLogic* game_logic) { game_logic_ = game_logic; }
+  explicit AudioManager(const AssetArchive* assets) { assets_ = assets; }
   raylib::Music music;  // The music stream object.
   /**
    * @brief Initializes the AudioManager.
-   * Loads the background music from file and sets looping.
+   * Streams the background music from the asset archive, or from its file
+   * when the archive does not have it, and sets looping.
    */
   void Init() noexcept;
   /**
@@ -41,9 +43,10 @@ class AudioManager {
    * @brief Updates the AudioManager.
    * Plays or stops the music based on the current game state and volume
    * settings.
+   * @param game_state The state of the game in the latest snapshot.
    */
-  void Update() const noexcept;
+  void Update(game::GameState game_state) const noexcept;
 
  private:
-  game::GameLogic* game_logic_ = nullptr;  // Pointer to the GameLogic object.
+  const AssetArchive* assets_ = nullptr;    // Pointer to the asset archive.
 };
\ No newline at end of file
@@ -6,4 +6,7 @@ constexpr int screen_height = 720;
 
 constexpr int max_player = 2;
 constexpr char* game_name = "Charming Shinobi";
+
+// Built by the asset_packer target, the loose files of data/ are used when it is missing.
+constexpr const char* asset_archive_path = "data/assets.pack";
 }  // namespace game
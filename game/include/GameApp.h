@@ -4,6 +4,7 @@
 #include "NetworkLogic.h"
 #include "Renderer.h"
 #include "RollbackManager.h"
+#include "SimulationThread.h"
 
 /**
  * @brief Represents the main game application.
@@ -12,18 +13,30 @@
  * deinitialization of various game components including game logic, rendering,
  * audio, and networking. It also handles user interface interactions using Dear
  * ImGui for displaying menus and game options.
+ * The game logic runs on the simulation thread and the network client on the
+ * network thread, the main thread samples the inputs and draws the latest
+ * snapshot of the simulation.
  *
  * Variables:
  * - is_collider_visible_: Indicates whether collider shapes are visible.
  * - is_game_option_visible_ : Indicates whether the game options menu is
  * visible.
+ * - is_memory_panel_visible_ : Indicates whether the allocator statistics
+ * panel is visible.
+ * - input_delay_setting_ : The input delay of the next game in frames, or
+ * automatic.
+ * - predictor_type_ : The InputPredictorType predicting the remote inputs.
  * - appID: The application ID for networking purposes.
  * - appVersion: The application version for networking purposes.
+ * - asset_archive: The packed assets, mapped in memory before the renderer and
+ * audio are initialized.
+ * - asset_cache: Loads the textures once per path, decoding in the background.
  * - rollback_manager: Manages game state rollback for network synchronization.
  * - game_logic: Manages the game logic and state.
  * - game_renderer: Handles rendering of the game world.
  * - audio_manager: Manages audio playback and volume settings.
  * - networkLogic_: Handles networking logic and communication.
+ * - simulation: Runs the game logic and the rollbacks.
  */
 class GameApp {
  private:
@@ -31,23 +44,34 @@ class GameApp {
       false;  // Indicates whether collider shapes are visible.
   bool is_game_option_visible_ =
       false;  // Indicates whether the game options menu is visible.
+  bool is_memory_panel_visible_ =
+      false;  // Indicates whether the allocator statistics panel is visible.
+  int input_delay_setting_ =
+      game::GameLogic::kAutoInputDelay;  // The input delay of the next game.
+  int predictor_type_ = static_cast<int>(
+      InputPredictorType::kRepeatLast);  // Predicts the remote inputs.
 
  public:
+  AssetArchive asset_archive;  // The packed assets, mapped for the whole run.
+  AssetCache asset_cache{
+      &asset_archive};  // Loads the textures once per path, in the background.
   RollbackManager rollback_manager;  // Manages game state rollback for network synchronization.
   game::GameLogic game_logic{
       &rollback_manager};  // Manages the game logic and state.
   Renderer game_renderer{
-      &game_logic, &network_logic};  // Handles rendering of the game world.
+      &asset_cache};  // Handles rendering of the game world.
   AudioManager audio_manager{
-      &game_logic};  // Manages audio playback and volume settings.
+      &asset_archive};  // Manages audio playback and volume settings.
 
   ExitGames::Common::JString appID =
       L"d7a7fb07-5b89-4563-af7f-a83778fe14f8";  // The Photon application ID for networking purposes.
   ExitGames::Common::JString appVersion =
       L"1.0";  // The Photon application version.
   NetworkLogic network_logic{
-      appID, appVersion,
-      &game_logic};  // Handles networking logic and communication.
+      appID, appVersion};  // Handles networking logic and communication.
+  SimulationThread simulation{
+      &game_logic, &rollback_manager,
+      &network_logic};  // Runs the game logic and the rollbacks.
 
   /**
    * @brief Initializes the game application, create Window, init logic, manager
@@ -60,14 +84,25 @@ class GameApp {
   void InitImgui();
   /**
    * @brief Draws the Dear ImGui interface according to the current game state.
+   * @param snapshot The latest state of the simulation.
    */
-  void DrawImgui();
+  void DrawImgui(const RenderSnapshot& snapshot);
+  /**
+   * @brief Draws the bytes in use, peak, allocation count and failed requests
+   * of every tagged allocator, one row per subsystem.
+   */
+  void DrawMemoryPanel();
+  /**
+   * @brief Draws the choice of the strategy predicting the remote inputs.
+   */
+  void DrawPredictorCombo();
   /**
    * @brief Deinitializes the game application.
    */
   void Deinit();
   /**
-   * @brief Runs the main game loop.
+   * @brief Runs a frame of the main game loop: samples the local input and
+   * draws the latest snapshot, while the simulation thread ticks.
    */
   void Loop(void);
 };
@@ -1,9 +1,10 @@
 #pragma once
-#include <queue>
+#include <cstdint>
 #include <vector>
 
 #include "FrameInput.h"
 #include "PlayerManager.h"
+#include "TimeSync.h"
 #include "Timer.h"
 #include "World.h"
 #include "event.h"
@@ -42,13 +43,25 @@ struct collider {
  * - player_manager: Manages player entities and their interactions with the
  * game world.
  * - inputs: Stores the current frame inputs for all players.
+ * - local_input: The input of the local player, sampled by the render thread
+ * and used by the next Update.
  * - last_inputs: Stores the inputs from the previous frames for rollback
  * purposes.
- * - network_events: Queue to store incoming network events.
  * - colliders_: Vector of collider structures representing physics objects and
  * their colliders.
  * - client_player_nbr: ID of the local client player.
  * - current_game_state: Enum representing the current state of the game.
+ * - rollback_count: Number of rollbacks so far, for the renderer to smooth
+ * their corrections.
+ * - time_sync: Estimates how far ahead of the remote player the local one runs,
+ * to slow down the ticks while ahead.
+ * - input_delay_setting: The input delay of the next game in frames, or
+ * kAutoInputDelay to choose it from the round trip time.
+ * - input_delay: The frames the local inputs are scheduled ahead in this game,
+ * for the remote to receive them before it simulates their frame.
+ * - remote_input_delay: The input delay of the remote player.
+ * - stalled_tick_count: The ticks spent waiting for the remote inputs, past
+ * the prediction window.
  *
  * Member Functions:
  * - Rollback: Rolls back the game state to match the provided GameLogic
@@ -64,10 +77,16 @@ struct collider {
  * - Init: Initializes the game environment, including creating platforms and
  * ropes.
  * - OnInputReceived: Handles input events received from the network.
+ * - OnPlayerJoined: Assigns the local player and launches the game once the
+ * room is full.
+ * - ChooseInputDelay: Chooses the input delay of a game about to launch.
+ * - ProcessNetworkEvents: Handles the records received from the network
+ * thread.
  * - Update: Updates the game logic, processes inputs, and advances the game
  * state.
  * - DeInit: Deinitializes the game environment.
  * - ManageInput: Manages player inputs and sends input events to the network.
+ * - SendInputs: Sends the local inputs not confirmed yet.
  * - UpdateGameplay: Updates player actions and game physics.
  * - CreatePlatform: Creates a platform in the game world.
  * - CreateRope: Creates a rope in the game world.
@@ -84,10 +103,9 @@ class GameLogic {
   PlayerManager player_manager{
       &world_};              // Manages player entities and their interactions.
   Input::FrameInput inputs;  // Stores the current frame inputs for all players.
+  std::uint8_t local_input = 0;  // The sampled input of the local player.
   std::vector<Input::FrameInput>
       last_inputs;  // Stores inputs from previous frames for rollback.
-  std::queue<NetworkEvent>
-      network_events;  // Queue to store incoming network events.
   std::vector<game::collider>
       colliders_;  // Vector of collider structures representing physics objects
                    // and their colliders.
@@ -99,6 +117,17 @@ class GameLogic {
   static constexpr int master_client_ID = 0;
   GameState current_game_state =
       GameState::LogMenu;  // Enum representing the current state of the game.
+  std::uint32_t rollback_count = 0;  // Number of rollbacks so far.
+  TimeSync time_sync{
+      fixedUpdateFrenquency};  // Keeps the peers in step, frame for frame.
+  static constexpr int kAutoInputDelay = -1;
+  static constexpr int kMaxInputDelay = 4;
+  int input_delay_setting =
+      kAutoInputDelay;  // The input delay of the next game, or automatic.
+  int input_delay = 0;  // The frames the local inputs are scheduled ahead.
+  int remote_input_delay = 0;  // The input delay of the remote player.
+  std::uint32_t stalled_tick_count =
+      0;  // The ticks spent waiting for the remote inputs.
 
   /**
    * @brief Rolls back the game state to match the provided `GameLogic`
@@ -132,10 +161,9 @@ class GameLogic {
       const std::vector<Input::FrameInput>& remote_frame_inputs) noexcept;
   /**
    * @brief Handles frame confirmation events received from the master client.
-   * @param event_content The content of the received event.
+   * @param record The received confirmation.
    */
-  void OnFrameConfirmationReceived(
-      const ExitGames::Common::Hashtable& event_content);
+  void OnFrameConfirmationReceived(const NetworkRecord& record);
 
   /**
    * @brief Initializes the game environment.
@@ -144,9 +172,29 @@ class GameLogic {
 
   /**
    * @brief Handles input events received from the network.
-   * @param content The content of the received event.
+   * @param record The received inputs.
    */
-  void OnInputReceived(const ExitGames::Common::Hashtable& content);
+  void OnInputReceived(const NetworkRecord& record);
+
+  /**
+   * @brief Handles a player joining the room, the local one included.
+   * @param record The record of the joining player.
+   */
+  void OnPlayerJoined(const NetworkRecord& record) noexcept;
+
+  /**
+   * @brief Chooses the input delay of a game about to launch: the setting, or
+   * the whole frames of the one way latency to the remote, at most
+   * kMaxInputDelay. The rollbacks only cover the latency left.
+   */
+  void ChooseInputDelay() noexcept;
+
+  /**
+   * @brief Handles the records received since the last update, until one of
+   * them changes the game state: the records after it wait for the update of
+   * the new state.
+   */
+  void ProcessNetworkEvents();
 
   /**
    * @brief Updates the player gameplay logic based on player inputs.
@@ -171,6 +219,11 @@ class GameLogic {
    */
   void ManageInput() noexcept;
 
+  /**
+   * @brief Sends the local inputs not confirmed yet to the network.
+   */
+  void SendInputs() noexcept;
+
   /**
    * @brief Creates a platform in the game world.
    * @param position The position of the platform.
@@ -1,4 +1,5 @@
 #pragma once
+#include "AssetCache.h"
 #include "raylib_wrapper.h"
 
 /**
@@ -10,36 +11,28 @@ enum class Pivot { Default, Center };
  * @brief Class representing a custom image with the ability to specify pivot point.
  *
  * Member Variables:
- * - sprite: The texture representing the main image.
+ * - cache: The AssetCache owning the texture, shared with the other images of the same file.
+ * - texture: The handle of the texture in the cache.
  * - originalScale: The original scale of the image.
  * - pivot: The pivot point of the image (Default or Center).
- * - icon: The image loaded as an icon.
  */
 class ImageCustom {
 public:
-	raylib::Texture2D sprite;  /* The texture sprite of the image.*/
+	const AssetCache* cache = nullptr; /* The cache owning the texture.*/
+	TextureHandle texture; /* The handle of the texture in the cache.*/
 	float originalScale; /* The original scale of the image.*/
 	Pivot pivot; /* The pivot point of the image.*/
 
-	raylib::Image icon;   /* The window icon image.*/
-
 	/**
 	 * @brief Sets up the image with the specified path, scale, and pivot mode.
+	 * The texture is requested from the cache, the image draws nothing until
+	 * it is loaded.
+	 * @param asset_cache The cache loading the texture.
 	 * @param path The path to the image file.
 	 * @param scale The scale factor for the image.
 	 * @param mode The pivot mode for the image.
 	 */
-	void Setup(const char* path, float scale, Pivot mode);
-	/**
-	 * @brief Sets up the icon with the specified path and pivot mode.
-	 * @param path The path to the icon image file.
-	 * @param mode The pivot mode for the icon.
-	 */
-	void SetupIcon(const char* path, Pivot mode);
-	/**
-	 * @brief Tears down the image, releasing associated resources.
-	 */
-	void TearDown();
+	void Setup(AssetCache& asset_cache, const char* path, float scale, Pivot mode);
 	/**
 	 * @brief Draws the image at the specified position.
 	 * @param position The position to draw the image.
@@ -51,4 +44,14 @@ public:
 	 * @param scale The scale factor for the image.
 	 */
 	void Draw(raylib::Vector2 position, float scale)const noexcept;
+	/**
+	 * @brief Computes the quad drawing the image at the specified position and scale.
+	 * @param position The position to draw the image.
+	 * @param scale The scale factor for the image.
+	 * @param source The region of the texture to draw.
+	 * @param dest The rectangle covered on screen.
+	 * @return false while the texture is not loaded.
+	 */
+	bool ComputeQuad(raylib::Vector2 position, float scale, raylib::Rectangle& source,
+		raylib::Rectangle& dest) const noexcept;
 };
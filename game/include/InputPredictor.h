@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief The strategies to predict the inputs of the remote player.
+ */
+enum class InputPredictorType : std::uint8_t {
+  kRepeatLast = 0,  // Repeats the last input received.
+  kNeutral,         // Predicts no input at all.
+  kReleaseTaps,     // Repeats the moves, releases the jump and the attack.
+  kMarkov,          // Learns which input follows the last two.
+  kCount
+};
+
+/**
+ * @brief How well an InputPredictor did, counted by the RollbackManager while
+ * it is the active one.
+ *
+ * Variables:
+ * - predicted_frames: The simulated frames whose input was predicted, then
+ * received.
+ * - mispredicted_frames: Those of them whose prediction was wrong.
+ * - rollback_count: The rollbacks the wrong predictions caused.
+ * - rollback_depth_sum: The frames each rollback simulated again, summed.
+ * - misprediction_distance_sum: The frames from the earliest wrong frame of
+ * each rollback to the current one, summed.
+ */
+struct PredictionStats {
+  std::uint32_t predicted_frames = 0;
+  std::uint32_t mispredicted_frames = 0;
+  std::uint32_t rollback_count = 0;
+  std::uint64_t rollback_depth_sum = 0;
+  std::uint64_t misprediction_distance_sum = 0;
+
+  [[nodiscard]] float MispredictionRate() const noexcept {
+    return predicted_frames == 0 ? 0.f
+                                 : static_cast<float>(mispredicted_frames) /
+                                       static_cast<float>(predicted_frames);
+  }
+
+  [[nodiscard]] float AverageRollbackDepth() const noexcept {
+    return rollback_count == 0 ? 0.f
+                               : static_cast<float>(rollback_depth_sum) /
+                                     static_cast<float>(rollback_count);
+  }
+
+  [[nodiscard]] float AverageMispredictionDistance() const noexcept {
+    return rollback_count == 0
+               ? 0.f
+               : static_cast<float>(misprediction_distance_sum) /
+                     static_cast<float>(rollback_count);
+  }
+};
+
+/**
+ * @brief Predicts the input of the remote player for the frames it did not
+ * send yet, from the inputs it sent before.
+ *
+ * Every predictor observes every input received, in frame order, so that the
+ * one chosen during a game is already trained.
+ *
+ * Variables:
+ * - stats: How well the predictor did while active.
+ */
+class InputPredictor {
+ public:
+  virtual ~InputPredictor() = default;
+
+  /**
+   * @brief Learns the input of the next frame received.
+   */
+  virtual void Observe(std::uint8_t) noexcept {}
+
+  /**
+   * @brief Predicts the input of a frame not received yet.
+   * @param last_input The input of the last frame received.
+   * @param distance The frames from the last frame received, one or more.
+   */
+  [[nodiscard]] virtual std::uint8_t Predict(std::uint8_t last_input,
+                                             int distance) const noexcept = 0;
+
+  /**
+   * @brief Forgets what was learnt, when a game starts over.
+   */
+  virtual void Reset() noexcept { stats = PredictionStats{}; }
+
+  PredictionStats stats;
+};
+
+/**
+ * @brief Predicts that the remote keeps its last input.
+ */
+class RepeatLastPredictor final : public InputPredictor {
+ public:
+  [[nodiscard]] std::uint8_t Predict(std::uint8_t last_input,
+                                     int) const noexcept override {
+    return last_input;
+  }
+};
+
+/**
+ * @brief Predicts that the remote releases everything.
+ */
+class NeutralPredictor final : public InputPredictor {
+ public:
+  [[nodiscard]] std::uint8_t Predict(std::uint8_t,
+                                     int) const noexcept override {
+    return 0;
+  }
+};
+
+/**
+ * @brief Predicts that the remote keeps moving but that its jump and attack
+ * are taps, released on the next frame.
+ */
+class ReleaseTapsPredictor final : public InputPredictor {
+ public:
+  [[nodiscard]] std::uint8_t Predict(std::uint8_t last_input,
+                                     int distance) const noexcept override;
+};
+
+/**
+ * @brief Predicts the most frequent input to follow the last two inputs of
+ * the remote, an order two Markov chain learnt during the game.
+ *
+ * The counts of a context are halved when one of them saturates, so that the
+ * recent habits of the remote weigh more than the old ones. A context never
+ * seen repeats the last input.
+ *
+ * Variables:
+ * - counts_: How often each input followed each pair of inputs.
+ * - history_: The last two inputs observed, the oldest first.
+ * - observed_count_: The inputs observed, up to two.
+ */
+class MarkovPredictor final : public InputPredictor {
+ public:
+  static constexpr int kInputCount = 16;  // The values of the four flags.
+
+  void Observe(std::uint8_t input) noexcept override;
+
+  [[nodiscard]] std::uint8_t Predict(std::uint8_t last_input,
+                                     int distance) const noexcept override;
+
+  void Reset() noexcept override;
+
+ private:
+  std::array<std::array<std::uint8_t, kInputCount>, kInputCount * kInputCount>
+      counts_{};
+  std::array<std::uint8_t, 2> history_{};
+  int observed_count_ = 0;
+};
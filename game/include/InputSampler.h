@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief The input of the local player for a tick, and when it was sampled.
+ *
+ * Variables:
+ * - input: The Input flags held at the latest sample, or pressed at any sample
+ * since the previous tick.
+ * - sample_time: The time of the latest sample, in seconds of the steady clock.
+ */
+struct SampledInput {
+  std::uint8_t input = 0;
+  double sample_time = 0.0;
+};
+
+/**
+ * @brief Hands the input of the local player from the render thread, which
+ * polls the devices, to the simulation thread, which consumes it at the start
+ * of each tick.
+ *
+ * The devices can only be polled on the thread of the window, once per frame,
+ * so the render thread samples them as soon as they are polled and the tick
+ * takes the latest sample. A flag seen at any sample since the previous tick
+ * is latched until the next one consumes it: a tap shorter than a tick is
+ * never lost when the frames are faster than the ticks. Each sample carries
+ * its time, so that the latency from a sample to its tick and to its frame
+ * can be measured.
+ *
+ * The held flags, the latched flags and the time of the latest sample share
+ * one atomic, updated with compare and swap by both threads: no lock, and no
+ * sample is torn.
+ *
+ * Variables:
+ * - state_: The held flags in the low byte, the latched flags in the next
+ * one, and the time of the latest sample in microseconds above.
+ */
+class InputSampler {
+ public:
+  /**
+   * @brief Records the flags held at a sample, on the render thread.
+   * @param input The Input flags currently held.
+   * @param sample_time When the devices were polled, in seconds of the steady
+   * clock.
+   */
+  void Sample(std::uint8_t input, double sample_time) noexcept;
+
+  /**
+   * @brief Takes the input of a tick, on the simulation thread: the flags
+   * latched since the previous tick, the held ones latched again for the next.
+   */
+  [[nodiscard]] SampledInput Consume() noexcept;
+
+ private:
+  static constexpr int kLatchedShift = 8;
+  static constexpr int kTimeShift = 16;
+  static constexpr std::uint64_t kFlagsMask = 0xFF;
+
+  std::atomic<std::uint64_t> state_ = 0;
+};
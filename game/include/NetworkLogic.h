@@ -4,9 +4,25 @@
 #include <LoadBalancing-cpp/inc/Client.h>
 #include <LoadBalancing-cpp/inc/Listener.h>
 
-#include "GameLogic.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <thread>
+
+#include "SpscRing.h"
 #include "event.h"
 
+/**
+ * @brief The requests of the other threads to the network thread, which owns
+ * the Photon client.
+ */
+enum class NetworkCommand : std::uint32_t {
+  kConnect = 1 << 0,     // Connects the client to the server.
+  kJoinRoom = 1 << 1,    // Joins a random room, or creates one.
+  kDisconnect = 1 << 2,  // Disconnects the client from the server.
+};
+
 /**
  * @brief NetworkLogic is a class responsible for managing network operations
  * and interactions.
@@ -14,28 +30,80 @@
  * It facilitates communication between the game client and server, handling
  * tasks such as connecting to the server, creating and joining rooms, sending
  * and receiving events, and managing network errors using Photon services.
+ *
+ * The Photon client is serviced on its own thread, every kServiceInterval, so
+ * that the arrival of an input does not wait for a frame or a tick. That
+ * thread decodes the events into NetworkRecord and pushes them to a ring the
+ * simulation thread drains with Poll, and raises the records the simulation
+ * thread pushes with Send: the game logic never touches a Hashtable.
+ *
+ * Only the inputs, sent again every tick, are dropped when a ring is full. The
+ * other records are reliable and the protocol counts on each of them: they are
+ * held back by the thread pushing them, in order, until the ring has room.
  */
 class NetworkLogic : private ExitGames::LoadBalancing::Listener {
  public:
-  bool is_connected = false; /* Indicates whether the client is currently
-                                connected to the server. */
-  const char* currentLogInfo =
+  static constexpr std::size_t kRecordQueueSize = 256;
+  static constexpr std::chrono::milliseconds kServiceInterval{1};
+
+  std::atomic<bool> is_connected = false; /* Indicates whether the client is
+                                             currently connected to the
+                                             server. */
+  std::atomic<const char*> currentLogInfo =
       ""; /* Information about the current network state. */
+  std::atomic<int> round_trip_time_ms =
+      0; /* The round trip time to the server, in milliseconds. */
 
   /**
    * @brief Constructs a new NetworkLogic object.
    *
    * @param appID The application ID used for connection.
    * @param appVersion The application version used for connection.
-   * @param game_logic Pointer to the game logic object.
    */
   NetworkLogic(const ExitGames::Common::JString& appID,
-               const ExitGames::Common::JString& appVersion,
-               game::GameLogic* game_logic);
+               const ExitGames::Common::JString& appVersion);
+
+  NetworkLogic(const NetworkLogic&) = delete;
+  NetworkLogic& operator=(const NetworkLogic&) = delete;
+
+  ~NetworkLogic() override { Stop(); }
+
+  void Start(); /* Starts servicing the client on the network thread. */
+  /**
+   * @brief Runs the commands still pending and joins the network thread.
+   */
+  void Stop() noexcept;
+
+  /**
+   * @brief Asks the network thread to run a command, from any thread.
+   */
+  void Post(NetworkCommand command) noexcept {
+    pending_commands_.fetch_or(static_cast<std::uint32_t>(command),
+                               std::memory_order_release);
+  }
+
+  /**
+   * @brief Queues a record to be raised by the network thread, from the
+   * simulation thread only.
+   * @return false if the record is an input and the queue is full, the input
+   * is dropped then.
+   */
+  bool Send(const NetworkRecord& record);
+
+  /**
+   * @brief Takes the oldest record received, from the simulation thread only.
+   * @return false if there is none.
+   */
+  bool Poll(NetworkRecord& record) {
+    // The records held back are sent even on the ticks sending nothing.
+    PushHeldRecords(sent_records_, held_sent_records_);
+    return received_records_.Pop(record);
+  }
+
+  /* The methods below run on the network thread only. */
 
   void Connect();    /* Connects the client to the server. */
   void Disconnect(); /* Disconnects the client from the server. */
-  void Run(); /* Runs the network loop for handling events and operations. */
 
   /**
    * @brief Creates a room on the server.
@@ -60,32 +128,57 @@ class NetworkLogic : private ExitGames::LoadBalancing::Listener {
    */
   void JoinRandomOrCreateRoom() noexcept;
 
+ private:
+  ExitGames::LoadBalancing::Client
+      mLoadBalancingClient;          /* The LoadBalancing client instance. */
+  ExitGames::Common::Logger mLogger; /* Logger instance for debug messages. */
+
+  std::thread thread_;                    /* The network thread. */
+  std::atomic<bool> is_stopping_ = false; /* Asks the network thread to
+                                             return. */
+  std::atomic<std::uint32_t> pending_commands_ =
+      0; /* The NetworkCommand flags posted since the last service. */
+  using RecordRing = SpscRing<NetworkRecord, kRecordQueueSize>;
+
+  RecordRing received_records_; /* From the network to the simulation
+                                   thread. */
+  RecordRing sent_records_; /* From the simulation to the network thread. */
+  std::deque<NetworkRecord>
+      held_received_records_; /* The records not pushed yet to
+                                 received_records_, on the network thread. */
+  std::deque<NetworkRecord>
+      held_sent_records_; /* The records not pushed yet to sent_records_, on
+                             the simulation thread. */
+
   /**
-   * @brief Raises an event to the server.
-   *
-   * @param reliable Indicates whether the event transmission should be
-   * reliable.
-   * @param event_code The code associated with the event.
-   * @param event_data The data associated with the event.
+   * @brief Pushes a record to a ring after the records held back for it,
+   * holding it back too if the ring is full, or dropping it if it is an
+   * input.
+   * @return false if the record is dropped.
    */
-  void RaiseEvent(bool reliable, EventCode event_code,
-                  const ExitGames::Common::Hashtable& event_data) noexcept;
-
+  static bool PushOrHold(RecordRing& ring, std::deque<NetworkRecord>& held,
+                         const NetworkRecord& record);
   /**
-   * @brief Receives an event from the server.
-   *
-   * @param player_nr The player number associated with the event.
-   * @param event_code The code associated with the received event.
-   * @param event_content The content of the received event.
+   * @brief Pushes the records held back for a ring, as many as it has room
+   * for.
    */
-  void ReceiveEvent(int player_nr, EventCode event_code,
-                    const ExitGames::Common::Hashtable& event_content) noexcept;
+  static void PushHeldRecords(RecordRing& ring,
+                              std::deque<NetworkRecord>& held) noexcept;
 
- private:
-  ExitGames::LoadBalancing::Client
-      mLoadBalancingClient;          /* The LoadBalancing client instance. */
-  ExitGames::Common::Logger mLogger; /* Logger instance for debug messages. */
-  game::GameLogic* game_logic_;      /* Pointer to the game logic object. */
+  /**
+   * @brief Services the client every kServiceInterval until stopped.
+   */
+  void Run();
+  void ExecuteCommands();
+  /**
+   * @brief Encodes the records queued by Send into events and raises them.
+   */
+  void RaiseSentRecords() noexcept;
+  /**
+   * @brief Queues a record for the simulation thread. An input is dropped if
+   * the simulation thread lags kRecordQueueSize records behind.
+   */
+  void Receive(const NetworkRecord& record);
 
   // Listener callbacks
   void debugReturn(int debugLevel,
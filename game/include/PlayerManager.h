@@ -11,7 +11,6 @@ using namespace raylib;
  * Member Variables:
  * - is_grounded: Flag indicating whether the player is grounded or not.
  * - is_projectile_ready: Flag indicating whether the player is ready to launch a projectile.
- * - trigger_nbr: Number of trigger events detected by the player.
  * - life_point: Remaining life points of the player.
  * - attack_timer: Time remaining until the player can perform another attack.
  * - input: Input data for the player.
@@ -19,7 +18,6 @@ using namespace raylib;
 struct Player {
 	bool is_grounded = false;
 	bool is_projectile_ready = true;
-	int trigger_nbr = 0;
 	int life_point = 5;
 	float attack_timer = 0.0f;
 	std::uint8_t input;
@@ -185,6 +183,15 @@ public:
 	 */
 	Math::Vec2F GetPlayerPosition(int idx) const noexcept;
 
+	/**
+	 * @brief Checks if the grounded collider of a player touches anything but
+	 * the player itself and the projectiles, with a query on the physics world.
+	 *
+	 * @param player_idx Index of the player.
+	 * @return True if the player stands on a platform, a rope or the other player.
+	 */
+	bool IsGrounded(int player_idx) const noexcept;
+
 	/**
 	 * @brief Handles trigger event detection when colliders enter.
 	 *
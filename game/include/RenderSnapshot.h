@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "GameLogic.h"
+#include "InputPredictor.h"
+#include "raylib_wrapper.h"
+
+/**
+ * @brief A collider outline drawn for debugging.
+ *
+ * Variables:
+ * - type: Rectangle or circle.
+ * - position: The top left corner of a rectangle, the center of a circle.
+ * - size: The size of a rectangle, the radius of a circle in x.
+ * - color: The color of the outline.
+ */
+struct DebugShape {
+  Math::ShapeType type = Math::ShapeType::Rectangle;
+  raylib::Vector2 position{};
+  raylib::Vector2 size{};
+  raylib::Color color{};
+};
+
+/**
+ * @brief Where an entity is drawn at a tick.
+ *
+ * Variables:
+ * - position: Its simulated position.
+ * - correction: What is left of the rollbacks that moved it, the position it
+ * was predicted at minus the resimulated one, fading tick after tick.
+ */
+struct PresentedTransform {
+  raylib::Vector2 position{};
+  raylib::Vector2 correction{};
+};
+
+/**
+ * @brief Everything the render thread draws of a simulation tick, copied by
+ * the simulation thread at the end of the tick.
+ *
+ * Variables:
+ * - tick: Number of the snapshot, increasing with each published tick.
+ * - tick_time: When the tick ended, in seconds of the steady clock.
+ * - input_sample_time: When the local input used by the tick was sampled, in
+ * seconds of the steady clock.
+ * - game_state: The state of the game.
+ * - client_player_nbr: ID of the local client player.
+ * - rollback_count: Number of rollbacks of the game logic so far.
+ * - frame_advantage: How many frames the local player runs ahead of the remote
+ * one.
+ * - input_delay: The frames the local inputs are scheduled ahead.
+ * - stalled_tick_count: The ticks the game logic waited for the remote inputs.
+ * - prediction_stats: How well the active predictor of the remote inputs did.
+ * - is_connected: Whether the client is connected to the server.
+ * - log_info: Information about the current network state.
+ * - players, life_points, is_projectile_ready: The state of each player.
+ * - projectiles, is_projectile_active: The state of each projectile.
+ * - previous_players, previous_projectiles: The transforms at the tick before,
+ * the snapshots published in between may not be drawn. A projectile fired this
+ * tick starts where it is.
+ * - debug_shapes: The collider outlines, the first debug_shape_count only,
+ * collected while they are shown.
+ */
+struct RenderSnapshot {
+  static constexpr std::size_t kMaxDebugShapes = 128;
+
+  std::uint32_t tick = 0;
+  double tick_time = 0.0;
+  double input_sample_time = 0.0;
+  game::GameState game_state = game::GameState::LogMenu;
+  int client_player_nbr = -1;
+  std::uint32_t rollback_count = 0;
+  float frame_advantage = 0.f;
+  int input_delay = 0;
+  std::uint32_t stalled_tick_count = 0;
+  PredictionStats prediction_stats{};
+  bool is_connected = false;
+  const char* log_info = "";
+
+  std::array<PresentedTransform, game::max_player> players{};
+  std::array<int, game::max_player> life_points{};
+  std::array<bool, game::max_player> is_projectile_ready{};
+
+  std::array<PresentedTransform, PlayerManager::max_projectile_> projectiles{};
+  std::array<bool, PlayerManager::max_projectile_> is_projectile_active{};
+
+  std::array<PresentedTransform, game::max_player> previous_players{};
+  std::array<PresentedTransform, PlayerManager::max_projectile_>
+      previous_projectiles{};
+
+  std::array<DebugShape, kMaxDebugShapes> debug_shapes{};
+  std::size_t debug_shape_count = 0;
+};
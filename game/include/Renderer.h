@@ -1,6 +1,7 @@
 #pragma once
-#include "GameLogic.h"
 #include "Image.h"
+#include "RenderSnapshot.h"
+#include "SpriteBatch.h"
 
 
 /**
@@ -10,29 +11,38 @@
  * platforms, background, UI elements, and debug collider shapes. It provides methods
  * to initialize and deinitialize the renderer, as well as to draw the game scene with
  * optional collider visibility for debugging purposes.
+ * The sprites of the game scene are collected in a SpriteBatch and drawn at the
+ * end of the frame, layer by layer.
+ * The renderer reads the game from the RenderSnapshot published by the
+ * simulation thread, never from the game logic itself.
+ * The players and projectiles are drawn between the last two simulated states,
+ * so that their motion stays smooth at any frame rate, and offset by the
+ * rollback corrections published with them, so that a correction is spread
+ * over a few ticks instead of snapping.
  */
 class Renderer {
 public:
 	/**
 	 * @brief Constructs a new Renderer object.
 	 *
-	 * @param gl Pointer to the GameLogic object.
-	 * @param network_logic Pointer to the NetworkLogic object.
+	 * @param assets Pointer to the cache the textures are loaded by.
 	 */
-	Renderer(game::GameLogic* gl, NetworkLogic* network_logic)
-		: game_logic_(gl), network_logic_(network_logic) {}
+	explicit Renderer(AssetCache* assets) : assets_(assets) {}
 
 	/**
-	 * @brief Initializes the renderer.
+	 * @brief Initializes the renderer, requesting its textures from the cache.
+	 * Returns at once, the images are drawn as their textures are loaded.
 	 */
 	void Init() noexcept;
 
 	/**
-	 * @brief Draws the game scene.
+	 * @brief Draws the game scene, with the collider shapes of the snapshot if
+	 * it collected them.
 	 *
-	 * @param isColliderVisible Flag indicating whether collider shapes should be visible for debugging.
+	 * @param snapshot The latest state of the simulation.
+	 * @param alpha The fraction of a simulation tick elapsed since the snapshot, in [0, 1].
 	 */
-	void Draw(bool isColliderVisible) noexcept;
+	void Draw(const RenderSnapshot& snapshot, float alpha) noexcept;
 
 	/**
 	 * @brief Deinitializes the renderer.
@@ -41,14 +51,23 @@ public:
 
 private:
 	/**
-	 * @brief Renders collider shapes in the game window for debugging purposes.
+	 * @brief The layers of the game scene, drawn from the first to the last.
 	 */
-	void DrawColliderShape() noexcept;
+	enum Layer : int {
+		kBackgroundLayer,
+		kProjectileLayer,
+		kRopeLayer,
+		kLimitLayer,
+		kPlatformLayer,
+		kPlayerWeaponLayer,
+		kPlayerLayer,
+		kUILayer
+	};
 
 	/**
-	 * @brief Draws collider shapes for player entities.
+	 * @brief Renders collider shapes in the game window for debugging purposes.
 	 */
-	void DrawPlayerColliderShape() noexcept;
+	void DrawColliderShape() noexcept;
 
 	/**
 	 * @brief Draws platforms in the game scene.
@@ -66,7 +85,7 @@ private:
 	void DrawPlayer() noexcept;
 
 	/**
-	 * @brief Draws projectiles in the game scene.
+	 * @brief Draws the active projectiles in the game scene.
 	 */
 	void DrawProjectiles() noexcept;
 
@@ -85,8 +104,7 @@ private:
 	 */
 	void DrawUI() noexcept;
 
-	game::GameLogic* game_logic_ = nullptr; /* Pointer to the GameLogic object.*/
-	NetworkLogic* network_logic_ = nullptr; /* Pointer to the NetworkLogic object.*/
+	AssetCache* assets_ = nullptr; /* Pointer to the cache loading the textures.*/
 
 	// Images for rendering
 	ImageCustom player_;
@@ -100,12 +118,26 @@ private:
 	ImageCustom border_left_;
 	ImageCustom border_right_;
 	ImageCustom border_top_;
-	ImageCustom icon_;
 	ImageCustom winner_layer_p1;
 	ImageCustom winner_layer_p2;
 	ImageCustom player1_life_point_;
 	ImageCustom player2_life_point_;
 
+	SpriteBatch batch_; /* The sprites of the game scene drawn this frame.*/
+
+	TextureHandle icon_; /* The window icon, set once its pixels are loaded.*/
+	bool is_icon_set_ = false;
+
+	const RenderSnapshot* snapshot_ = nullptr; /* The snapshot drawn this frame.*/
+	float alpha_ = 1.f; /* The fraction of a tick elapsed since the simulated state drawn this frame.*/
+
+	/**
+	 * @return The transform blended between the tick before the snapshot and
+	 * the snapshot by alpha_.
+	 */
+	[[nodiscard]] raylib::Vector2 Interpolate(const PresentedTransform& previous,
+		const PresentedTransform& current) const noexcept;
+
 	raylib::Vector2 center_pos_ = { game::screen_width * 0.5f,
 								   game::screen_height * 0.5f };  /* Represent the center of the window*/
 };
@@ -1,23 +1,63 @@
 #pragma once
 
+#include <array>
+#include <limits>
+
 #include "FrameInput.h"
 #include "GameLogic.h"
+#include "InputPredictor.h"
 
 /**
  * @brief RollbackManager is a class responsible for maintaining the integrity
  * of the game simulation.
  *
- * It manages three game states with different temporalities:
+ * It manages four game states with different temporalities:
  * - The current game state represents the local client's real-time game.
  * - The confirmed state is the last game state confirmed by the client
  * (verified through checksum).
+ * - The settled state is the game at the last frame whose inputs are all
+ * known, restored by a rollback.
  * - The state to be confirmed is the game state calculated by the master client
  * once all inputs for a frame have been received. Other clients receive the
  * checksum of this game state and verify its integrity against their own
  * checksum for the same state.
+ *
+ * The inputs of a player may be known ahead of the current frame, when they
+ * are scheduled with an input delay. Each new frame whose input of a player is
+ * not known yet is predicted by the active InputPredictor, and a rollback only
+ * happens when an input received for a frame already simulated differs from
+ * its prediction. The inputs received during a tick are all stored first, and a
+ * single rollback at the end covers every misprediction they revealed, so a
+ * burst of events costs one resimulation instead of one each.
+ *
+ * The prediction is bounded: the current frame stays within
+ * kMaxPredictionFrames of the last remote input, the game logic stalls beyond.
+ * The settled state advances each tick as the remote inputs arrive, so that a
+ * rollback never simulates more than kMaxPredictionFrames again however late
+ * the confirmations of the master are.
  */
 class RollbackManager {
  public:
+  /**
+   * @brief How far the rollbacks moved the entities: the positions predicted
+   * before each rollback minus the resimulated ones, summed.
+   *
+   * Variables:
+   * - players: The offset of each player.
+   * - projectiles: The offset of each projectile, active before and after the
+   * rollback, 0 for the others.
+   */
+  struct RollbackOffsets {
+    std::array<Math::Vec2F, game::max_player> players{};
+    std::array<Math::Vec2F, PlayerManager::max_projectile_> projectiles{};
+  };
+
+  static constexpr short kNoRollback = std::numeric_limits<short>::max();
+  static constexpr short kMaxPredictionFrames =
+      8; /* The most frames predicted past the last remote input, 160 ms at
+          * 50 Hz.
+          */
+
   /**
    * @brief Registers the GameManager for the RollbackManager.
    *
@@ -26,6 +66,7 @@ class RollbackManager {
   void RegisterGameManager(game::GameLogic* current_game_manager) noexcept {
     current_game_manager_ = current_game_manager;
     confirmed_game_manager_.Init();
+    settled_game_manager_.Init();
 
     for (std::size_t i = 0; i < game::max_player; i++) {
       inputs_[i].resize(kMaxFrameCount);
@@ -33,7 +74,8 @@ class RollbackManager {
   }
 
   /**
-   * @brief Sets the local player's input for a specific frame.
+   * @brief Sets the local player's input for a specific frame, the current
+   * one or a later one with an input delay.
    *
    * @param local_input The input for the local player.
    * @param player_id The ID of the local player.
@@ -51,10 +93,27 @@ class RollbackManager {
       const std::vector<Input::FrameInput>& new_remote_inputs, int player_id);
 
   /**
-   * @brief Simulates the game until the current frame.
+   * @brief Simulates the game from the settled state until the current frame.
    */
   void SimulateUntilCurrentFrame() const noexcept;
 
+  /**
+   * @brief Settles the frames whose inputs are all known since the last call,
+   * then rolls back once if those inputs revealed a misprediction, before the
+   * current frame is simulated.
+   */
+  void ApplyPendingRollback() noexcept;
+
+  /**
+   * @brief Retrieves the earliest frame simulated with a wrong prediction
+   * since the last rollback.
+   *
+   * @return The frame, or kNoRollback if no rollback is pending.
+   */
+  [[nodiscard]] short rollback_frame() const noexcept {
+    return rollback_frame_;
+  }
+
   /**
    * @brief Confirms the current frame and advances to the next frame.
    *
@@ -63,13 +122,42 @@ class RollbackManager {
   int ConfirmFrame() noexcept;
 
   /**
-   * @brief Retrieves the last confirmed input for a specific player.
+   * @brief Takes the offsets of the rollbacks since the last call, for the
+   * drawn entities to slide from their predicted positions.
+   */
+  [[nodiscard]] RollbackOffsets TakeRollbackOffsets() noexcept {
+    const auto offsets = rollback_offsets_;
+    rollback_offsets_ = RollbackOffsets{};
+    return offsets;
+  }
+
+  /**
+   * @brief Chooses the strategy predicting the inputs not received yet.
+   */
+  void SetPredictor(InputPredictorType type) noexcept {
+    predictor_ = predictors_[static_cast<std::size_t>(type)];
+  }
+
+  /**
+   * @brief Retrieves how well the active predictor did.
+   *
+   * @return The counters of the active predictor.
+   */
+  [[nodiscard]] const PredictionStats& prediction_stats() const noexcept {
+    return predictor_->stats;
+  }
+
+  /**
+   * @brief Retrieves the input of a player for the current frame, received or
+   * predicted.
    *
    * @param player_id The ID of the player.
-   * @return The last confirmed input for the player.
+   * @return The input of the player for the current frame.
    */
-  [[nodiscard]] const Input::FrameInput& GetLastPlayerConfirmedInput(
-      int player_id) const noexcept;
+  [[nodiscard]] const Input::FrameInput& GetCurrentPlayerInput(
+      int player_id) const noexcept {
+    return inputs_[player_id][current_frame_];
+  }
 
   /**
    * @brief Retrieves the current frame number.
@@ -79,9 +167,29 @@ class RollbackManager {
   [[nodiscard]] short current_frame() const noexcept { return current_frame_; }
 
   /**
-   * @brief Increments the current frame number.
+   * @brief Increments the current frame number, predicting the remote inputs
+   * not known yet for it.
+   *
+   * @param local_player_id The ID of the local player, whose input is not
+   * predicted.
+   */
+  void IncreaseCurrentFrame(int local_player_id) noexcept;
+
+  /**
+   * @brief Decrements the current frame number, for a frame not simulated
+   * after all.
+   */
+  void DecreaseCurrentFrame() noexcept { current_frame_--; }
+
+  /**
+   * @brief Tells whether the current frame can be predicted.
+   *
+   * @return false if the current frame is more than kMaxPredictionFrames past
+   * the last remote input.
    */
-  void IncreaseCurrentFrame() noexcept { current_frame_++; }
+  [[nodiscard]] bool IsInPredictionWindow() const noexcept {
+    return current_frame_ - last_remote_input_frame_ <= kMaxPredictionFrames;
+  }
 
   /**
    * @brief Retrieves the last confirmed frame number.
@@ -118,11 +226,19 @@ class RollbackManager {
     last_remote_input_frame_ = -1;
     frame_to_confirm_ = 0;
     confirmed_frame_ = -1;
+    settled_frame_ = -1;
     for (auto& input : inputs_) {
       input.clear();
     }
     last_inputs_.fill({});
+    next_input_frames_.fill(0);
+    rollback_frame_ = kNoRollback;
+    rollback_offsets_ = RollbackOffsets{};
+    for (auto* predictor : predictors_) {
+      predictor->Reset();
+    }
     confirmed_game_manager_.ResetState();
+    settled_game_manager_.ResetState();
     current_game_manager_ = nullptr;
   }
 
@@ -151,6 +267,15 @@ class RollbackManager {
                                 * (frame verified with checksum).
                                 */
 
+  game::GameLogic settled_game_manager_{
+      this}; /* The game at settled_frame_, the state a rollback restores.
+              */
+
+  short settled_frame_ = -1; /* The last frame whose inputs of every player
+                              * are known and which is simulated in
+                              * settled_game_manager_.
+                              */
+
   static constexpr short kMaxFrameCount =
       30'000; /* kMaxFrameCount is the maximum of frame that the game can last.
                * Here 30'000 corresponds to 10 minutes at a fixed 50fps.
@@ -162,4 +287,41 @@ class RollbackManager {
       last_inputs_{}; /* last_inputs_ is an array which stores the last inputs
                        * received by the different players.
                        */
+
+  RepeatLastPredictor repeat_last_predictor_;
+  NeutralPredictor neutral_predictor_;
+  ReleaseTapsPredictor release_taps_predictor_;
+  MarkovPredictor markov_predictor_;
+  std::array<InputPredictor*, static_cast<std::size_t>(
+                                  InputPredictorType::kCount)>
+      predictors_{&repeat_last_predictor_, &neutral_predictor_,
+                  &release_taps_predictor_,
+                  &markov_predictor_}; /* The predictors, indexed by
+                                        * InputPredictorType.
+                                        */
+  InputPredictor* predictor_ =
+      &repeat_last_predictor_; /* The predictor of the inputs not received
+                                * yet.
+                                */
+
+  short rollback_frame_ =
+      kNoRollback; /* The earliest frame simulated with a wrong prediction
+                    * since the last rollback.
+                    */
+
+  RollbackOffsets rollback_offsets_; /* The offsets of the rollbacks since the
+                                      * last TakeRollbackOffsets.
+                                      */
+
+  std::array<short, game::max_player>
+      next_input_frames_{}; /* The first frame whose input of each player is
+                             * not known yet, ahead of the current frame with
+                             * an input delay.
+                             */
+
+  /**
+   * @brief Simulates in settled_game_manager_ the frames before the current
+   * one whose remote inputs were received since the last call.
+   */
+  void SettleKnownFrames() noexcept;
 };
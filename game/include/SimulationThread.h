@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "InputSampler.h"
+#include "NetworkLogic.h"
+#include "RenderSnapshot.h"
+#include "RollbackManager.h"
+#include "TripleBuffer.h"
+
+/**
+ * @brief The requests of the render thread to the simulation thread, which
+ * owns the game logic.
+ */
+enum class SimulationCommand : std::uint32_t {
+  kReturnToMenu = 1 << 0,  // Resets the game and disconnects.
+};
+
+/**
+ * @brief Runs the game logic and its rollbacks on their own thread, at the
+ * fixed rate of the game logic. The network client runs on the thread of
+ * NetworkLogic, and exchanges records with the game logic through rings.
+ *
+ * Each tick publishes a RenderSnapshot through a lock-free triple buffer: the
+ * render thread draws the latest one and never waits for a tick, and a tick
+ * never waits for a frame, so a frame costs the longest of the two instead of
+ * their sum. Nothing else crosses the threads: the local input goes through
+ * an InputSampler and the commands of the menus are a single atomic.
+ *
+ * Variables:
+ * - game_logic_, rollback_manager_: Owned by the simulation thread while it
+ * runs.
+ * - network_logic_: The network client, posted the disconnections and read
+ * for its connection state.
+ * - thread_: The simulation thread.
+ * - is_stopping_: Asks the simulation thread to return.
+ * - pending_commands_: The SimulationCommand flags posted since the last tick.
+ * - input_sampler_: The input of the local player, sampled by the render
+ * thread.
+ * - input_sample_time_: When the input of the last tick was sampled.
+ * - are_debug_shapes_visible_: Whether the snapshots collect the colliders.
+ * - input_delay_setting_: The input delay chosen in the menu, for the next
+ * game.
+ * - predictor_type_: The InputPredictorType chosen in the menu.
+ * - snapshots_: Hands the snapshots to the render thread.
+ * - tick_: The number of the last published snapshot.
+ */
+class SimulationThread {
+ public:
+  static constexpr int kMaxTicksPerWake = 5;
+
+  SimulationThread(game::GameLogic* game_logic,
+                   RollbackManager* rollback_manager,
+                   NetworkLogic* network_logic) noexcept
+      : game_logic_(game_logic),
+        rollback_manager_(rollback_manager),
+        network_logic_(network_logic) {}
+
+  SimulationThread(const SimulationThread&) = delete;
+  SimulationThread& operator=(const SimulationThread&) = delete;
+
+  ~SimulationThread() { Stop(); }
+
+  /**
+   * @brief Starts ticking, once the game logic is initialized.
+   */
+  void Start();
+
+  /**
+   * @brief Runs the commands still pending and joins the simulation thread.
+   * The game logic belongs to the caller again afterwards.
+   */
+  void Stop() noexcept;
+
+  /**
+   * @brief Asks the simulation thread to run a command before its next tick.
+   */
+  void Post(SimulationCommand command) noexcept {
+    pending_commands_.fetch_or(static_cast<std::uint32_t>(command),
+                               std::memory_order_release);
+  }
+
+  /**
+   * @brief Samples the input of the local player for the next tick, on the
+   * render thread right after the devices are polled.
+   * @param input The Input flags currently held.
+   * @param sample_time When the devices were polled, from Now.
+   */
+  void SampleLocalInput(std::uint8_t input, double sample_time) noexcept {
+    input_sampler_.Sample(input, sample_time);
+  }
+
+  void SetDebugShapesVisible(bool is_visible) noexcept {
+    are_debug_shapes_visible_.store(is_visible, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Sets the input delay of the next game, in frames, or
+   * GameLogic::kAutoInputDelay.
+   */
+  void SetInputDelaySetting(int input_delay) noexcept {
+    input_delay_setting_.store(input_delay, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Sets the strategy predicting the inputs of the remote player.
+   */
+  void SetInputPredictor(InputPredictorType type) noexcept {
+    predictor_type_.store(type, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Takes the latest snapshot, on the render thread.
+   * @return The snapshot, valid until the next call.
+   */
+  [[nodiscard]] const RenderSnapshot& AcquireSnapshot() noexcept {
+    snapshots_.Update();
+    return snapshots_.ReadBuffer();
+  }
+
+  /**
+   * @return The fraction of a tick elapsed since the snapshot was published,
+   * in [0, 1], to interpolate from the snapshot before it.
+   */
+  [[nodiscard]] static float InterpolationAlpha(
+      const RenderSnapshot& snapshot) noexcept;
+
+  /**
+   * @return The time of the steady clock, in seconds.
+   */
+  [[nodiscard]] static double Now() noexcept;
+
+ private:
+  game::GameLogic* game_logic_ = nullptr;
+  RollbackManager* rollback_manager_ = nullptr;
+  NetworkLogic* network_logic_ = nullptr;
+
+  std::thread thread_;
+  std::atomic<bool> is_stopping_ = false;
+  std::atomic<std::uint32_t> pending_commands_ = 0;
+  InputSampler input_sampler_;
+  double input_sample_time_ = 0.0;
+  std::atomic<bool> are_debug_shapes_visible_ = false;
+  std::atomic<int> input_delay_setting_ = game::GameLogic::kAutoInputDelay;
+  std::atomic<InputPredictorType> predictor_type_ =
+      InputPredictorType::kRepeatLast;
+
+  TripleBuffer<RenderSnapshot> snapshots_;
+  std::uint32_t tick_ = 0;
+  // The transforms of the last published tick, the previous transforms of the
+  // next one while has_published_positions_.
+  std::array<PresentedTransform, game::max_player> players_{};
+  std::array<PresentedTransform, PlayerManager::max_projectile_>
+      projectiles_{};
+  std::array<bool, PlayerManager::max_projectile_> is_projectile_active_{};
+  bool has_published_positions_ = false;
+
+  /**
+   * @brief Ticks the game logic at its fixed rate until stopped.
+   */
+  void Run();
+
+  void ExecuteCommands();
+
+  /**
+   * @brief Copies the state of the tick just run to a snapshot and publishes
+   * it.
+   */
+  void Publish() noexcept;
+
+  void CollectDebugShapes(RenderSnapshot& snapshot) const noexcept;
+};
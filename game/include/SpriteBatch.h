@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Image.h"
+#include "raylib_wrapper.h"
+
+/**
+ * @brief Collects the sprites of a frame and draws them sorted by layer.
+ *
+ * The quads are drawn by layer, then by texture inside a layer, so that the
+ * quads sharing a texture follow each other and raylib draws them in a single
+ * batch: with the sprites packed in one atlas, a frame costs a draw call per
+ * texture instead of one per sprite. Inside a layer, quads of the same texture
+ * keep the order they were added in.
+ *
+ * Variables:
+ * - quads_: The quads added since the last Flush, its capacity reused from a
+ * frame to the next.
+ */
+class SpriteBatch {
+ public:
+  /**
+   * @brief Adds an image to draw at the next Flush, nothing if its texture is
+   * not loaded yet.
+   * @param image The image to draw.
+   * @param position The position to draw the image.
+   * @param scale The scale factor for the image.
+   * @param layer The layer of the image, lower layers are drawn below.
+   */
+  void Add(const ImageCustom& image, raylib::Vector2 position, float scale,
+           int layer);
+
+  /**
+   * @brief Draws the quads added since the last Flush and empties the batch.
+   */
+  void Flush() noexcept;
+
+  [[nodiscard]] std::size_t QuadCount() const noexcept {
+    return quads_.size();
+  }
+
+ private:
+  struct Quad {
+    raylib::Texture2D texture;
+    raylib::Rectangle source;
+    raylib::Rectangle dest;
+    int layer;
+    std::uint32_t order;
+  };
+
+  std::vector<Quad> quads_;
+};
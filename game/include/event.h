@@ -1,7 +1,9 @@
 #pragma once
-#include <Common-cpp/inc/Containers/Hashtable.h>
 #include <Common-cpp/inc/defines.h>
 
+#include <array>
+#include <cstdint>
+
 /**
  * @brief The EventCode enum represents different types of events that can occur
  * in the application, such as input events or frame confirmation events.
@@ -20,15 +22,56 @@ enum class EventKey : nByte {
   kPlayerInput = 0,  // Key for player input data.
   kFrameNbr,         // Key for frame number data.
   kDelay,            // Key for delay data.
-  kCheckSum          // Key for checksum data.
+  kCheckSum,         // Key for checksum data.
+  kFrameAdvantage,   // Key for the frame advantage of the sender.
+  kInputDelay        // Key for the input delay of the sender.
+};
+
+/**
+ * @brief NetworkInput is the input of a player for one frame, as carried by a
+ * NetworkRecord.
+ */
+struct NetworkInput {
+  short frame_nbr = 0;     // The frame number associated with the input.
+  std::uint8_t input = 0;  // Flags of the player actions for the frame.
 };
 
 /**
- * @brief NetworkEvent represents an event sent over the network.
- * The NetworkEvent struct encapsulates an event code and a hashtable containing
- * event content.
+ * @brief The NetworkRecordType enum tells what a NetworkRecord stands for.
  */
-struct NetworkEvent {
-  EventCode code{};  // Event code indicating the type of event.
-  ExitGames::Common::Hashtable content{};  // Hashtable containing event data.
-};
\ No newline at end of file
+enum class NetworkRecordType : std::uint8_t {
+  kInput = 0,          // Inputs of the remote player.
+  kFrameConfirmation,  // Confirmation of a frame, or its acknowledgement.
+  kPlayerJoined,       // A player joined the room, the local one included.
+  kDisconnected        // The client got disconnected from the server.
+};
+
+/**
+ * @brief NetworkRecord is an event decoded by the network thread, or to be
+ * encoded by it, of a fixed size to cross the threads through a ring without
+ * allocating.
+ *
+ * Variables:
+ * - kMaxInputs: The most inputs a record carries. A longer history keeps its
+ * oldest inputs, which the remote needs first.
+ * - type: What the record stands for.
+ * - player_nbr: The Photon number of the sender, or of the joining player.
+ * - checksum: The checksum of the confirmed frame, for a frame confirmation
+ * carrying inputs.
+ * - frame_advantage: How many frames the sender of inputs runs ahead of its
+ * receiver, as estimated by the sender.
+ * - input_delay: The frames the sender of inputs schedules them ahead.
+ * - input_count: The number of inputs used in inputs.
+ * - inputs: The inputs, ordered by frame.
+ */
+struct NetworkRecord {
+  static constexpr int kMaxInputs = 64;
+
+  NetworkRecordType type = NetworkRecordType::kInput;
+  int player_nbr = 0;
+  int checksum = 0;
+  float frame_advantage = 0.f;
+  std::uint8_t input_delay = 0;
+  int input_count = 0;
+  std::array<NetworkInput, kMaxInputs> inputs{};
+};
@@ -0,0 +1,205 @@
+#include "AssetCache.h"
+
+#include <algorithm>
+
+AssetCache::~AssetCache() { StopWorkers(); }
+
+void AssetCache::Init() {
+  is_stopping_ = false;
+  // Decoding is bound by the PNG inflate, a few threads are enough and leave
+  // cores to the main and network threads.
+  const auto thread_count = std::clamp(
+      static_cast<int>(std::thread::hardware_concurrency()) - 1, 1, 4);
+  for (int i = 0; i < thread_count; i++) {
+    workers_.emplace_back(&AssetCache::RunWorker, this);
+  }
+}
+
+TextureHandle AssetCache::RequestTexture(const char* path, bool keep_pixels) {
+  const auto it = indices_.find(path);
+  if (it != indices_.end()) {
+    slots_[it->second].keep_pixels |= keep_pixels;
+    return TextureHandle{it->second};
+  }
+
+  const auto* entry = archive_ != nullptr ? archive_->Find(path) : nullptr;
+  if (entry != nullptr && entry->type == AssetType::Sprite) {
+    return RequestSprite(path, *entry, keep_pixels);
+  }
+
+  const auto index = static_cast<std::uint32_t>(slots_.size());
+  indices_.emplace(path, index);
+  auto& slot = slots_.emplace_back();
+  slot.keep_pixels = keep_pixels;
+
+  if (entry != nullptr && entry->type == AssetType::Image) {
+    // Already decoded by the packer, the upload reads the mapped bytes.
+    slot.is_packed = true;
+    slot.baked_scale = entry->bakedScale;
+    pending_uploads_.push_back(DecodedImage{
+        index, raylib::Image{const_cast<std::byte*>(archive_->Data(*entry)),
+                             static_cast<int>(entry->width),
+                             static_cast<int>(entry->height), 1,
+                             raylib::PIXELFORMAT_UNCOMPRESSED_R8G8B8A8}});
+    return TextureHandle{index};
+  }
+
+  {
+    std::lock_guard lock(mutex_);
+    jobs_.push_back(DecodeJob{index, path});
+  }
+  has_job_.notify_one();
+  return TextureHandle{index};
+}
+
+TextureHandle AssetCache::RequestSprite(const char* path,
+                                        const AssetEntry& entry,
+                                        bool keep_pixels) {
+  // The atlas is requested first, as any texture, then shared by its sprites.
+  const auto region = archive_->Region(entry);
+  const auto atlas =
+      RequestTexture(archive_->Entry(region.atlasIndex).name).index;
+
+  const auto index = static_cast<std::uint32_t>(slots_.size());
+  indices_.emplace(path, index);
+  auto& slot = slots_.emplace_back();
+  slot.keep_pixels = keep_pixels;
+  slot.atlas = atlas;
+  slot.region = raylib::Rectangle{
+      static_cast<float>(region.x), static_cast<float>(region.y),
+      static_cast<float>(entry.width), static_cast<float>(entry.height)};
+  slot.baked_scale = entry.bakedScale;
+  if (slots_[atlas].is_ready) {
+    CompleteSprite(slot);
+  }
+  return TextureHandle{index};
+}
+
+void AssetCache::Update(int max_uploads) {
+  {
+    std::lock_guard lock(mutex_);
+    pending_uploads_.insert(pending_uploads_.end(), decoded_.begin(),
+                            decoded_.end());
+    decoded_.clear();
+  }
+
+  for (int upload = 0; upload < max_uploads && !pending_uploads_.empty();
+       upload++) {
+    auto [index, image] = pending_uploads_.front();
+    pending_uploads_.pop_front();
+
+    auto& slot = slots_[index];
+    if (image.data != nullptr) {
+      slot.texture = raylib::LoadTextureFromImage(image);
+    }
+    if (slot.keep_pixels || slot.is_packed) {
+      slot.pixels = image;
+    } else {
+      raylib::UnloadImage(image);
+    }
+    slot.is_ready = true;
+    ready_count_++;
+
+    for (auto& sprite : slots_) {
+      if (sprite.atlas == index) {
+        CompleteSprite(sprite);
+      }
+    }
+  }
+}
+
+raylib::Rectangle AssetCache::Region(TextureHandle handle) const noexcept {
+  if (!IsKnown(handle)) {
+    return raylib::Rectangle{};
+  }
+  const auto& slot = slots_[handle.index];
+  if (slot.atlas != TextureHandle::kInvalidIndex) {
+    return slot.region;
+  }
+  return raylib::Rectangle{0.f, 0.f, static_cast<float>(slot.texture.width),
+                           static_cast<float>(slot.texture.height)};
+}
+
+const raylib::Image* AssetCache::Pixels(TextureHandle handle) const noexcept {
+  if (!IsKnown(handle)) {
+    return nullptr;
+  }
+  const auto& slot = slots_[handle.index];
+  if (!slot.is_ready || slot.pixels.data == nullptr) {
+    return nullptr;
+  }
+  return &slot.pixels;
+}
+
+void AssetCache::CompleteSprite(TextureSlot& sprite) {
+  const auto& atlas = slots_[sprite.atlas];
+  if (sprite.keep_pixels && atlas.pixels.data != nullptr) {
+    sprite.pixels = raylib::ImageFromImage(atlas.pixels, sprite.region);
+  }
+  sprite.is_ready = true;
+  ready_count_++;
+}
+
+void AssetCache::Deinit() noexcept {
+  StopWorkers();
+
+  for (auto& decoded : decoded_) {
+    raylib::UnloadImage(decoded.image);
+  }
+  for (auto& pending : pending_uploads_) {
+    if (!slots_[pending.index].is_packed) {
+      raylib::UnloadImage(pending.image);
+    }
+  }
+  for (auto& slot : slots_) {
+    if (slot.texture.id != 0) {
+      raylib::UnloadTexture(slot.texture);
+    }
+    if (!slot.is_packed && slot.pixels.data != nullptr) {
+      raylib::UnloadImage(slot.pixels);
+    }
+  }
+
+  decoded_.clear();
+  pending_uploads_.clear();
+  slots_.clear();
+  indices_.clear();
+  ready_count_ = 0;
+}
+
+void AssetCache::RunWorker() {
+  while (true) {
+    DecodeJob job;
+    {
+      std::unique_lock lock(mutex_);
+      has_job_.wait(lock, [this]() { return is_stopping_ || !jobs_.empty(); });
+      if (is_stopping_) {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+
+    // A file that cannot be decoded still completes, with an empty texture.
+    auto image = raylib::LoadImage(job.path.c_str());
+    if (image.data != nullptr) {
+      raylib::ImageFormat(&image, raylib::PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    }
+
+    std::lock_guard lock(mutex_);
+    decoded_.push_back(DecodedImage{job.index, image});
+  }
+}
+
+void AssetCache::StopWorkers() noexcept {
+  {
+    std::lock_guard lock(mutex_);
+    is_stopping_ = true;
+    jobs_.clear();
+  }
+  has_job_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
@@ -1,7 +1,16 @@
 #include "AudioManager.h"
 
 void AudioManager::Init() noexcept {
-  music = raylib::LoadMusicStream("data/theme.wav");
+  constexpr const char* music_path = "data/theme.wav";
+  // The stream reads the mapped wav while it plays, the archive outlives it.
+  const auto* entry = assets_->Find(music_path);
+  if (entry != nullptr && entry->type == AssetType::File) {
+    music = raylib::LoadMusicStreamFromMemory(
+        ".wav", reinterpret_cast<const unsigned char*>(assets_->Data(*entry)),
+        static_cast<int>(entry->size));
+  } else {
+    music = raylib::LoadMusicStream(music_path);
+  }
   music.looping = true;
 }
 
@@ -10,8 +19,8 @@ void AudioManager::Deinit() noexcept {
   raylib::CloseAudioDevice();
 }
 
-void AudioManager::Update() const noexcept {
-  if (game_logic_->current_game_state != game::GameState::GameLaunch) {
+void AudioManager::Update(game::GameState game_state) const noexcept {
+  if (game_state != game::GameState::GameLaunch) {
     return;
   }
   if (is_audio_playing) {
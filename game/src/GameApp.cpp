@@ -1,11 +1,17 @@
 #include "GameApp.h"
 
+#include <iterator>
+
+#include "Allocator.h"
 #include "imgui_impl_raylib.h"
 
 void GameApp::Init() {
   raylib::InitWindow(game::screen_width, game::screen_height, game::game_name);
 
   raylib::InitAudioDevice();
+  // Without the archive, the renderer and the audio load the files of data/.
+  asset_archive.Open(game::asset_archive_path);
+  asset_cache.Init();
   game_renderer.Init();
   audio_manager.Init();
   InitImgui();
@@ -14,6 +20,8 @@ void GameApp::Init() {
   rollback_manager.RegisterGameManager(&game_logic);
   raylib::SetExitKey(KEY_NULL);
   Input::FrameInput::registerType();
+  network_logic.Start();
+  simulation.Start();
 }
 
 void GameApp::InitImgui() {
@@ -28,10 +36,10 @@ void GameApp::InitImgui() {
   ImGui::StyleColorsClassic();
 }
 
-void GameApp::DrawImgui() {
+void GameApp::DrawImgui(const RenderSnapshot& snapshot) {
   ImGui_ImplRaylib_NewFrame();
   ImGui::NewFrame();
-  if (game_logic.current_game_state == game::GameState::LogMenu) {
+  if (snapshot.game_state == game::GameState::LogMenu) {
     ImGui::SetNextWindowSize(ImVec2(280, 600));
     ImGui::SetNextWindowPos(ImVec2(80, 80));
 
@@ -39,22 +47,22 @@ void GameApp::DrawImgui() {
     {
       ImGui::Text("--- Online: ---");
       ImGui::Spacing();
-      if (!network_logic.is_connected) {
+      if (!snapshot.is_connected) {
         if (ImGui::Button("Connect", ImVec2(125, 25))) {
-          network_logic.Connect();
+          network_logic.Post(NetworkCommand::kConnect);
         }
         ImGui::Spacing();
       }
 
-      if (network_logic.is_connected) {
+      if (snapshot.is_connected) {
         if (ImGui::Button("Join Game", ImVec2(125, 25))) {
-          network_logic.JoinRandomOrCreateRoom();
+          network_logic.Post(NetworkCommand::kJoinRoom);
         }
 
         ImGui::Spacing();
 
         if (ImGui::Button("Disconnect", ImVec2(125, 25))) {
-          network_logic.Disconnect();
+          network_logic.Post(NetworkCommand::kDisconnect);
         }
       }
       ImGui::Spacing();
@@ -67,6 +75,17 @@ void GameApp::DrawImgui() {
       ImGui::Spacing();
       ImGui::Checkbox("Show Collider Shape", &is_collider_visible_);
       ImGui::Spacing();
+      ImGui::Checkbox("Show Memory Panel", &is_memory_panel_visible_);
+      ImGui::Spacing();
+      ImGui::SliderInt("Input Delay", &input_delay_setting_,
+                       game::GameLogic::kAutoInputDelay,
+                       game::GameLogic::kMaxInputDelay,
+                       input_delay_setting_ == game::GameLogic::kAutoInputDelay
+                           ? "Auto"
+                           : "%d frames");
+      ImGui::Spacing();
+      DrawPredictorCombo();
+      ImGui::Spacing();
 
       ImGui::Text("");
       ImGui::Spacing();
@@ -99,7 +118,7 @@ void GameApp::DrawImgui() {
     }
   }
 
-  if (game_logic.current_game_state == game::GameState::GameLaunch) {
+  if (snapshot.game_state == game::GameState::GameLaunch) {
     if (is_game_option_visible_) {
       ImGui::Begin("Game Option");
       {
@@ -108,11 +127,32 @@ void GameApp::DrawImgui() {
         ImGui::Checkbox("Play Sound", &audio_manager.is_audio_playing);
         ImGui::Spacing();
         ImGui::Checkbox("Show Collider Shape", &is_collider_visible_);
+        ImGui::Spacing();
+        ImGui::Checkbox("Show Memory Panel", &is_memory_panel_visible_);
+        ImGui::Spacing();
+        // From the sample of the input to the end of its tick, and to this
+        // frame.
+        ImGui::Text("Input latency: %.1f ms to tick, %.1f ms to frame",
+                    (snapshot.tick_time - snapshot.input_sample_time) * 1e3,
+                    (SimulationThread::Now() - snapshot.input_sample_time) *
+                        1e3);
+        ImGui::Text("Frame advantage: %.1f, rollbacks: %u",
+                    snapshot.frame_advantage, snapshot.rollback_count);
+        ImGui::Text("Input delay: %d frames, stalled ticks: %u",
+                    snapshot.input_delay, snapshot.stalled_tick_count);
+        ImGui::Spacing();
+        DrawPredictorCombo();
+        const auto& stats = snapshot.prediction_stats;
+        ImGui::Text("Mispredictions: %.1f %%, %.1f frames before the rollback",
+                    stats.MispredictionRate() * 100.f,
+                    stats.AverageMispredictionDistance());
+        ImGui::Text("Average rollback depth: %.1f frames simulated again",
+                    stats.AverageRollbackDepth());
       }
     }
   }
 
-  if (game_logic.current_game_state == game::GameState::GameVictory) {
+  if (snapshot.game_state == game::GameState::GameVictory) {
     ImGui::SetNextWindowSize(ImVec2(280, 600));
     ImGui::SetNextWindowPos(ImVec2(80, 80));
     ImGui::Begin("Ending Menu");
@@ -120,14 +160,11 @@ void GameApp::DrawImgui() {
       ImGui::TextWrapped("--- Game: ---");
       ImGui::Spacing();
       if (ImGui::Button("Return to Main Menu", ImVec2(125, 25))) {
-        rollback_manager.Reset();
-      	game_logic.ResetState();
-        rollback_manager.RegisterGameManager(&game_logic);
-        network_logic.Disconnect();
+        simulation.Post(SimulationCommand::kReturnToMenu);
       }
       ImGui::Spacing();
       if (ImGui::Button("Quit", ImVec2(125, 25))) {
-        network_logic.Disconnect();
+        network_logic.Post(NetworkCommand::kDisconnect);
         Deinit();
       }
       ImGui::Spacing();
@@ -139,25 +176,81 @@ void GameApp::DrawImgui() {
     }
   }
   ImGui::End();
+  if (is_memory_panel_visible_) {
+    DrawMemoryPanel();
+  }
   ImGui::Render();
   ImGui_ImplRaylib_RenderDrawData(ImGui::GetDrawData());
 }
 
+void GameApp::DrawPredictorCombo() {
+  static constexpr const char* kPredictorNames[] = {
+      "Repeat Last", "Neutral", "Release Taps", "Markov"};
+  static_assert(std::size(kPredictorNames) ==
+                static_cast<std::size_t>(InputPredictorType::kCount));
+  ImGui::Combo("Prediction", &predictor_type_, kPredictorNames,
+               static_cast<int>(std::size(kPredictorNames)));
+}
+
+void GameApp::DrawMemoryPanel() {
+  ImGui::SetNextWindowSize(ImVec2(420, 200), ImGuiCond_FirstUseEver);
+  ImGui::Begin("Memory", &is_memory_panel_visible_);
+  if (ImGui::BeginTable("Allocators", 5,
+                        ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+    ImGui::TableSetupColumn("Tag");
+    ImGui::TableSetupColumn("In use (KiB)");
+    ImGui::TableSetupColumn("Peak (KiB)");
+    ImGui::TableSetupColumn("Allocations");
+    ImGui::TableSetupColumn("Failed");
+    ImGui::TableHeadersRow();
+
+    for (const auto& stats : CollectAllocatorStats()) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(stats.tag);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", static_cast<float>(stats.bytesInUse) / 1024.f);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", static_cast<float>(stats.peakBytes) / 1024.f);
+      ImGui::TableNextColumn();
+      ImGui::Text("%zu", stats.allocationCount);
+      ImGui::TableNextColumn();
+      ImGui::Text("%zu", stats.failedCount);
+    }
+    ImGui::EndTable();
+  }
+  ImGui::End();
+}
+
 void GameApp::Deinit() {
+  // The game logic and the network belong to the main thread again. The
+  // network stops last, to send the disconnection of a return to the menu.
+  simulation.Stop();
+  network_logic.Stop();
   game_renderer.Deinit();
+  asset_cache.Deinit();
   audio_manager.Deinit();
   raylib::CloseAudioDevice();
   raylib::CloseWindow();
+  asset_archive.Close();
 
   game_logic.DeInit();
   Input::FrameInput::unregisterType();
 }
 
 void GameApp::Loop(void) {
-  game_logic.Update();
-  network_logic.Run();
+  // The devices were polled by the last EndDrawing, the input is sampled
+  // right away for the next tick instead of after this frame.
+  Input::FrameInput sampled_input;
+  sampled_input.UpdatePlayerInputs();
+  simulation.SampleLocalInput(sampled_input.input, SimulationThread::Now());
+  simulation.SetDebugShapesVisible(is_collider_visible_);
+  simulation.SetInputDelaySetting(input_delay_setting_);
+  simulation.SetInputPredictor(
+      static_cast<InputPredictorType>(predictor_type_));
+  const auto& snapshot = simulation.AcquireSnapshot();
 
-  if (game_logic.current_game_state == game::GameState::GameLaunch) {
+  if (snapshot.game_state == game::GameState::GameLaunch) {
     if (IsKeyReleased(KEY_ESCAPE)) {
       is_game_option_visible_ = !is_game_option_visible_;
     }
@@ -165,12 +258,14 @@ void GameApp::Loop(void) {
 
   ImGui_ImplRaylib_ProcessEvents();
 
-  audio_manager.Update();
+  audio_manager.Update(snapshot.game_state);
+  asset_cache.Update();
   raylib::BeginDrawing();
   {
     raylib::ClearBackground(raylib::BLACK);
-    game_renderer.Draw(is_collider_visible_);
+    game_renderer.Draw(snapshot,
+                       SimulationThread::InterpolationAlpha(snapshot));
   }
-  DrawImgui();
+  DrawImgui(snapshot);
   raylib::EndDrawing();
 }
\ No newline at end of file
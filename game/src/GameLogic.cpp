@@ -1,16 +1,42 @@
 #include "GameLogic.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "NetworkLogic.h"
 #include "Random.h"
 #include "RollbackManager.h"
 
+namespace {
+// Copies the oldest inputs not confirmed yet to a record, at most
+// NetworkRecord::kMaxInputs of them: the remote needs the oldest first.
+void EncodeInputs(const std::vector<Input::FrameInput>& inputs,
+                  NetworkRecord& record) noexcept {
+  record.input_count = static_cast<int>(
+      std::min(inputs.size(), std::size_t{NetworkRecord::kMaxInputs}));
+  for (int i = 0; i < record.input_count; i++) {
+    record.inputs[i] = NetworkInput{inputs[i].frame_nbr, inputs[i].input};
+  }
+}
+
+std::vector<Input::FrameInput> DecodeInputs(
+    const NetworkRecord& record) noexcept {
+  std::vector<Input::FrameInput> inputs;
+  inputs.reserve(record.input_count);
+  for (int i = 0; i < record.input_count; i++) {
+    inputs.emplace_back(Math::Vec2F(0.f, 0.f), record.inputs[i].frame_nbr,
+                        record.inputs[i].input);
+  }
+  return inputs;
+}
+}  // namespace
+
 namespace game {
 void GameLogic::Rollback(const GameLogic& game_logic) {
   world_ = game_logic.world_;
   world_.contactListener = &player_manager;
   player_manager.players = game_logic.player_manager.players;
+  rollback_count++;
 }
 
 void GameLogic::SetPlayerInput(const Input::FrameInput& input, int player_id) {
@@ -65,11 +91,12 @@ void GameLogic::SendFrameConfirmationEvent(
 
   const auto current_frame = rollback_manager->current_frame();
 
-  // If the last remote inputs is greater than the current frame. The end
-  // iterator must be equal to the frame input of the local current frame.
-  if (remote_frame_inputs.back().frame_nbr > current_frame) {
+  // The local input of the current frame is set after the network events, only
+  // the frames before it are confirmed. If the last remote inputs reach the
+  // current frame, the end iterator is the frame input of the current frame.
+  if (remote_frame_inputs.back().frame_nbr >= current_frame) {
     // Get the iterator of the inputs at the current frame to avoid to confirm
-    // a frame greater than the local current frame.
+    // a frame whose local input is not set yet.
     const auto current_frame_it =
         std::find_if(remote_frame_inputs.begin(), remote_frame_inputs.end(),
                      [current_frame](const Input::FrameInput& frame_input) {
@@ -82,55 +109,31 @@ void GameLogic::SendFrameConfirmationEvent(
   while (frame_to_confirm_it != end_it) {
     const auto frame_to_confirm = *frame_to_confirm_it;
 
-    if (frame_to_confirm.frame_nbr > current_frame) {
-      // Tried to confirm a frame greater than the local current frame.
+    if (frame_to_confirm.frame_nbr >= current_frame) {
+      // Tried to confirm the local current frame or a frame after it.
       break;
     }
 
-    const int check_sum = rollback_manager->ConfirmFrame();
-
-    ExitGames::Common::Hashtable event_check_sum;
-    event_check_sum.put(static_cast<nByte>(EventKey::kCheckSum), check_sum);
-    event_check_sum.put(static_cast<nByte>(EventKey::kPlayerInput),
-                        last_inputs.data(), last_inputs.size());
-
-    network_logic->RaiseEvent(true, EventCode::kFrameConfirmation,
-                              event_check_sum);
+    NetworkRecord confirmation;
+    confirmation.type = NetworkRecordType::kFrameConfirmation;
+    confirmation.checksum = rollback_manager->ConfirmFrame();
+    EncodeInputs(last_inputs, confirmation);
+    network_logic->Send(confirmation);
 
     ++frame_to_confirm_it;
   }
 }
 
-void GameLogic::OnFrameConfirmationReceived(
-    const ExitGames::Common::Hashtable& event_content) {
+void GameLogic::OnFrameConfirmationReceived(const NetworkRecord& record) {
   if (client_player_nbr == master_client_ID) {
     last_inputs.erase(last_inputs.begin());
     return;
   }
 
-  std::vector<Input::FrameInput> frame_inputs{};
-
-  const auto checksum_value =
-      event_content.getValue(static_cast<nByte>(EventKey::kCheckSum));
-  int checksum =
-      ExitGames::Common::ValueObject<int>(checksum_value).getDataCopy();
-
-  const auto input_value =
-      event_content.getValue(static_cast<nByte>(EventKey::kPlayerInput));
-
-  const Input::FrameInput* inputs =
-      ExitGames::Common::ValueObject<Input::FrameInput*>(input_value)
-          .getDataCopy();
-
-  const int inputs_count =
-      *ExitGames::Common::ValueObject<Input::FrameInput*>(input_value)
-           .getSizes();
-
-  frame_inputs.reserve(inputs_count);
-  for (int i = 0; i < inputs_count; i++) {
-    Input::FrameInput frame_input = inputs[i];
-    frame_inputs.push_back(frame_input);
+  if (record.input_count <= 0) {
+    return;
   }
+  const auto frame_inputs = DecodeInputs(record);
 
   // If we did not receive the inputs before the frame to confirm, add them.
   if (rollback_manager->last_remote_input_frame() <
@@ -141,7 +144,7 @@ void GameLogic::OnFrameConfirmationReceived(
 
   const int check_sum = rollback_manager->ConfirmFrame();
 
-  if (check_sum != checksum) {
+  if (check_sum != record.checksum) {
     std::cerr << "Not same checksum for frame: "
               << rollback_manager->frame_to_confirm() << '\n';
     return;
@@ -150,11 +153,11 @@ void GameLogic::OnFrameConfirmationReceived(
   // Send a frame confirmation event with empty data to the master client
   // just to tell him that we confirmed the frame and that he can erase
   // the input at the confirmed frame in its vector of inputs.
-  network_logic->RaiseEvent(true, EventCode::kFrameConfirmation,
-                            ExitGames::Common::Hashtable());
+  NetworkRecord acknowledgement;
+  acknowledgement.type = NetworkRecordType::kFrameConfirmation;
+  network_logic->Send(acknowledgement);
 
   last_inputs.erase(last_inputs.begin());
-  ExitGames::Common::MemoryManagement::deallocateArray(inputs);
 }
 
 void GameLogic::Init() noexcept {
@@ -191,72 +194,135 @@ void GameLogic::Init() noexcept {
              {0.0, 0.0}, {20.0f, 250.0f});
 }
 
-void GameLogic::OnInputReceived(const ExitGames::Common::Hashtable& content) {
-  std::vector<Input::FrameInput> remote_frame_inputs{};
-
-  const auto input_value =
-      content.getValue(static_cast<nByte>(EventKey::kPlayerInput));
-
-  const Input::FrameInput* inputs =
-      ExitGames::Common::ValueObject<Input::FrameInput*>(input_value)
-          .getDataCopy();
-
-  const int inputs_count =
-      *ExitGames::Common::ValueObject<Input::FrameInput*>(input_value)
-           .getSizes();
-
-  if (inputs_count <= 0) {
+void GameLogic::OnInputReceived(const NetworkRecord& record) {
+  time_sync.SetRemoteAdvantage(record.frame_advantage);
+  remote_input_delay = record.input_delay;
+  if (record.input_count <= 0) {
     return;
   }
 
-  remote_frame_inputs.reserve(inputs_count);
-  for (int i = 0; i < inputs_count; i++) {
-    Input::FrameInput frame_input{inputs[i]};
-    remote_frame_inputs.push_back(frame_input);
-  }
-
-  if (remote_frame_inputs.back().frame_nbr <
+  if (record.inputs[record.input_count - 1].frame_nbr <
       rollback_manager->last_remote_input_frame()) {
     // received old input, no need to send confirm packet.
     return;
   }
 
+  if (record.inputs[0].frame_nbr >
+      rollback_manager->last_remote_input_frame() + 1) {
+    // The inputs after the last one received are missing, a later event
+    // carries them again.
+    return;
+  }
+
+  const auto remote_frame_inputs = DecodeInputs(record);
   const int other_client_id = client_player_nbr == 0 ? 1 : 0;
   rollback_manager->SetRemotePlayerInput(remote_frame_inputs, other_client_id);
 
   if (client_player_nbr == master_client_ID) {
     SendFrameConfirmationEvent(remote_frame_inputs);
   }
+}
 
-  ExitGames::Common::MemoryManagement::deallocateArray(inputs);
+void GameLogic::OnPlayerJoined(const NetworkRecord& record) noexcept {
+  // If currentClientPlayer is not set
+  if (client_player_nbr == invalid_client_player_nbr) {
+    client_player_nbr = record.player_nbr - 1;
+    rollback_manager->confirmed_game_manager_.client_player_nbr =
+        record.player_nbr - 1;
+  }
+  if (record.player_nbr >= game::max_player) {
+    ChooseInputDelay();
+    current_game_state = GameState::GameLaunch;
+    rollback_manager->confirmed_game_manager_.current_game_state =
+        GameState::GameLaunch;
+  }
 }
 
-void GameLogic::Update() noexcept {
-  if (current_game_state != GameState::GameLaunch) {
+void GameLogic::ChooseInputDelay() noexcept {
+  if (input_delay_setting != kAutoInputDelay) {
+    input_delay = std::clamp(input_delay_setting, 0, kMaxInputDelay);
     return;
   }
-  rollback_manager->IncreaseCurrentFrame();
 
-  while (!network_events.empty()) {
-    const auto& event = network_events.front();
+  // The events are relayed by the server: the one way latency to the remote
+  // is about the round trip to the server.
+  const double one_way_latency =
+      network_logic->round_trip_time_ms.load(std::memory_order_relaxed) /
+      1000.0;
+  input_delay = std::min(
+      static_cast<int>(one_way_latency / fixedUpdateFrenquency),
+      kMaxInputDelay);
+}
 
-    switch (event.code) {
-      case EventCode::kInput:
-        OnInputReceived(event.content);
+void GameLogic::ProcessNetworkEvents() {
+  const auto game_state = current_game_state;
+  NetworkRecord record;
+  while (current_game_state == game_state && network_logic->Poll(record)) {
+    switch (record.type) {
+      case NetworkRecordType::kInput:
+        // Stale inputs of a game left are dropped.
+        if (current_game_state == GameState::GameLaunch) {
+          OnInputReceived(record);
+        }
+        break;
+      case NetworkRecordType::kFrameConfirmation:
+        if (current_game_state == GameState::GameLaunch) {
+          OnFrameConfirmationReceived(record);
+        }
         break;
-      case EventCode::kFrameConfirmation:
-        OnFrameConfirmationReceived(event.content);
+      case NetworkRecordType::kPlayerJoined:
+        OnPlayerJoined(record);
+        break;
+      case NetworkRecordType::kDisconnected:
+        current_game_state = GameState::LogMenu;
         break;
       default:
         break;
     }
-    network_events.pop();
   }
+}
+
+void GameLogic::Update() noexcept {
+  if (current_game_state != GameState::GameLaunch) {
+    ProcessNetworkEvents();
+    return;
+  }
+  rollback_manager->IncreaseCurrentFrame(client_player_nbr);
+
+  // Every input received this tick is stored before a single rollback
+  // replays them all.
+  ProcessNetworkEvents();
+  if (current_game_state != GameState::GameLaunch) {
+    return;
+  }
+  rollback_manager->ApplyPendingRollback();
+  if (!rollback_manager->IsInPredictionWindow()) {
+    // Too far ahead of the remote: the frame waits for its inputs, and the
+    // local inputs are sent again in case the remote is waiting too.
+    rollback_manager->DecreaseCurrentFrame();
+    SendInputs();
+    stalled_tick_count++;
+    return;
+  }
+
+  // The events are relayed by the server: the round trip to the remote is
+  // about twice the one to the server.
+  const double round_trip_time =
+      2 * network_logic->round_trip_time_ms.load(std::memory_order_relaxed) /
+      1000.0;
+  // The remote schedules its inputs remote_input_delay frames ahead of its
+  // frame.
+  const int last_remote_frame =
+      rollback_manager->last_remote_input_frame() < 0
+          ? -1
+          : rollback_manager->last_remote_input_frame() - remote_input_delay;
+  time_sync.Update(rollback_manager->current_frame(), last_remote_frame,
+                   round_trip_time);
 
   // PlayerManager Input
   ManageInput();
   for (int i = 0; i < game::max_player; i++) {
-    auto input = rollback_manager->GetLastPlayerConfirmedInput(i);
+    const auto& input = rollback_manager->GetCurrentPlayerInput(i);
     SetPlayerInput(input, i);
   }
   UpdateGameplay();
@@ -271,32 +337,47 @@ void GameLogic::DeInit() noexcept {
   world_.contactListener = nullptr;
   colliders_.clear();
   client_player_nbr = invalid_client_player_nbr;
-  while (!network_events.empty()) {
-    network_events.pop();
-  }
   last_inputs.clear();
 }
 
 void GameLogic::ResetState() noexcept {
   client_player_nbr = invalid_client_player_nbr;
-  while (!network_events.empty()) {
-    network_events.pop();
-  }
   last_inputs.clear();
+  time_sync.Reset();
+  input_delay = 0;
+  remote_input_delay = 0;
+  stalled_tick_count = 0;
   player_manager.ResetState();
 }
 
 void GameLogic::ManageInput() noexcept {
-  inputs.UpdatePlayerInputs();
-  inputs.frame_nbr = rollback_manager->current_frame();
+  const auto current_frame = rollback_manager->current_frame();
+  if (current_frame == 0) {
+    // The frames before the first delayed input have no input, they are sent
+    // like the others for the remote to confirm them.
+    for (short frame = 0; frame < input_delay; frame++) {
+      const Input::FrameInput no_input(Math::Vec2F(0.f, 0.f), frame, 0);
+      last_inputs.emplace_back(no_input);
+      rollback_manager->SetLocalPlayerInput(no_input, client_player_nbr);
+    }
+  }
+
+  // The input is applied input_delay frames later, leaving the time for it to
+  // reach the remote before the remote simulates its frame.
+  inputs.input = local_input;
+  inputs.frame_nbr = static_cast<short>(current_frame + input_delay);
   last_inputs.emplace_back(inputs);
   rollback_manager->SetLocalPlayerInput(inputs, client_player_nbr);
+  SendInputs();
+}
 
-  // Send Input
-  ExitGames::Common::Hashtable event_data;
-  event_data.put(static_cast<nByte>(EventCode::kInput), last_inputs.data(),
-                 static_cast<int>(last_inputs.size()));
-  network_logic->RaiseEvent(false, EventCode::kInput, event_data);
+void GameLogic::SendInputs() noexcept {
+  NetworkRecord record;
+  record.type = NetworkRecordType::kInput;
+  record.frame_advantage = time_sync.LocalAdvantage();
+  record.input_delay = static_cast<std::uint8_t>(input_delay);
+  EncodeInputs(last_inputs, record);
+  network_logic->Send(record);
 }
 
 void GameLogic::UpdateGameplay() noexcept {
@@ -311,9 +392,7 @@ void GameLogic::UpdateGameplay() noexcept {
     }
 
     // Gravity
-    player.is_grounded = player.trigger_nbr > 1;
-    // std::cout << "player " << it << " trigger nbrs : " << player.trigger_nbr
-    // << std::endl;
+    player.is_grounded = player_manager.IsGrounded(it);
     auto& body = world_.GetBody(player_manager.players_BodyRefs_[it]);
     if (!player.is_grounded) {
       body.AddForce({0, PlayerManager::gravity_});
@@ -1,31 +1,41 @@
 #include "Image.h"
 
 using namespace raylib;
-void ImageCustom::Setup(const char* path, float scale, Pivot mode) {
-  sprite = LoadTexture(path);
+
+void ImageCustom::Setup(AssetCache& asset_cache, const char* path, float scale,
+                        Pivot mode) {
+  cache = &asset_cache;
+  texture = asset_cache.RequestTexture(path);
   originalScale = scale;
   pivot = mode;
 }
 
-void ImageCustom::SetupIcon(const char* path, Pivot mode) {
-  icon = LoadImage(path);
-  pivot = mode;
+void ImageCustom::Draw(Vector2 position) const noexcept {
+  Draw(position, 1.f);
 }
 
-void ImageCustom::TearDown() { UnloadTexture(sprite); }
-
-void ImageCustom::Draw(Vector2 position) const noexcept {
-  if (pivot == Pivot::Center) {
-    position.x -= sprite.width * originalScale * 0.5f;
-    position.y -= sprite.height * originalScale * 0.5f;
+void ImageCustom::Draw(Vector2 position, float scale) const noexcept {
+  Rectangle source;
+  Rectangle dest;
+  if (ComputeQuad(position, scale, source, dest)) {
+    DrawTexturePro(cache->Texture(texture), source, dest, Vector2{0, 0}, 0.f,
+                   WHITE);
   }
-  DrawTextureEx(sprite, position, 0.f, originalScale, WHITE);
 }
 
-void ImageCustom::Draw(Vector2 position, float scale) const noexcept {
+bool ImageCustom::ComputeQuad(Vector2 position, float scale, Rectangle& source,
+                              Rectangle& dest) const noexcept {
+  if (cache->Texture(texture).id == 0) {
+    return false;
+  }
+  // The packer may have resized the pixels already, only the rest is applied.
+  const float draw_scale = originalScale * scale / cache->BakedScale(texture);
+  source = cache->Region(texture);
+  dest = Rectangle{position.x, position.y, source.width * draw_scale,
+                   source.height * draw_scale};
   if (pivot == Pivot::Center) {
-    position.x -= sprite.width * originalScale * scale * 0.5f;
-    position.y -= sprite.height * originalScale * scale * 0.5f;
+    dest.x -= dest.width * 0.5f;
+    dest.y -= dest.height * 0.5f;
   }
-  DrawTextureEx(sprite, position, 0.f, originalScale * scale, WHITE);
-}
\ No newline at end of file
+  return true;
+}
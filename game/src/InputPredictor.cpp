@@ -0,0 +1,58 @@
+#include "InputPredictor.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "FrameInput.h"
+
+std::uint8_t ReleaseTapsPredictor::Predict(std::uint8_t last_input,
+                                           int) const noexcept {
+  return static_cast<std::uint8_t>(last_input &
+                                   ~(Input::kJump | Input::kAttack));
+}
+
+void MarkovPredictor::Observe(std::uint8_t input) noexcept {
+  input &= kInputCount - 1;
+  if (observed_count_ == 2) {
+    auto& counts = counts_[history_[0] * kInputCount + history_[1]];
+    if (++counts[input] == std::numeric_limits<std::uint8_t>::max()) {
+      for (auto& count : counts) {
+        count /= 2;
+      }
+    }
+  } else {
+    observed_count_++;
+  }
+  history_[0] = history_[1];
+  history_[1] = input;
+}
+
+std::uint8_t MarkovPredictor::Predict(std::uint8_t last_input,
+                                      int distance) const noexcept {
+  if (observed_count_ < 2) {
+    return last_input;
+  }
+
+  // The frames further away are predicted from the predictions before them.
+  auto history = history_;
+  for (int step = 0; step < distance; step++) {
+    const auto& counts = counts_[history[0] * kInputCount + history[1]];
+    const auto most_frequent = std::max_element(counts.begin(), counts.end());
+    const auto next =
+        *most_frequent == 0
+            ? history[1]
+            : static_cast<std::uint8_t>(most_frequent - counts.begin());
+    history[0] = history[1];
+    history[1] = next;
+  }
+  return history[1];
+}
+
+void MarkovPredictor::Reset() noexcept {
+  InputPredictor::Reset();
+  for (auto& counts : counts_) {
+    counts.fill(0);
+  }
+  history_.fill(0);
+  observed_count_ = 0;
+}
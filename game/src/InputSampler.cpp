@@ -0,0 +1,34 @@
+#include "InputSampler.h"
+
+#include <cmath>
+
+void InputSampler::Sample(std::uint8_t input, double sample_time) noexcept {
+  const auto time_us =
+      static_cast<std::uint64_t>(std::llround(sample_time * 1e6));
+  auto state = state_.load(std::memory_order_relaxed);
+  std::uint64_t new_state;
+  do {
+    const auto latched = ((state >> kLatchedShift) & kFlagsMask) | input;
+    new_state = (time_us << kTimeShift) | (latched << kLatchedShift) | input;
+  } while (!state_.compare_exchange_weak(state, new_state,
+                                         std::memory_order_relaxed));
+}
+
+SampledInput InputSampler::Consume() noexcept {
+  auto state = state_.load(std::memory_order_relaxed);
+  std::uint64_t new_state;
+  do {
+    // The flags still held are latched for the next tick.
+    const auto held = state & kFlagsMask;
+    new_state = (state & ~(kFlagsMask << kLatchedShift)) |
+                (held << kLatchedShift);
+  } while (!state_.compare_exchange_weak(state, new_state,
+                                         std::memory_order_relaxed));
+
+  SampledInput sampled_input;
+  sampled_input.input =
+      static_cast<std::uint8_t>((state >> kLatchedShift) & kFlagsMask);
+  sampled_input.sample_time =
+      static_cast<double>(state >> kTimeShift) / 1e6;
+  return sampled_input;
+}
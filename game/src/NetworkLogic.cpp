@@ -1,6 +1,36 @@
 #include "NetworkLogic.h"
 
-#include "RollbackManager.h"
+#include <algorithm>
+#include <iostream>
+
+#include "FrameInput.h"
+#include "GameLogic.h"
+
+namespace {
+// Copies at most NetworkRecord::kMaxInputs inputs of an event to a record.
+void DecodeInputs(const ExitGames::Common::Hashtable& event_content,
+                  NetworkRecord& record) noexcept {
+  record.input_count = 0;
+  const auto input_value =
+      event_content.getValue(static_cast<nByte>(EventKey::kPlayerInput));
+  if (input_value == nullptr) {
+    return;
+  }
+
+  // Reads the array in place instead of copying it once more.
+  const ExitGames::Common::ValueObject<Input::FrameInput*> inputs_object(
+      input_value);
+  const Input::FrameInput* inputs = *inputs_object.getDataAddress();
+  if (inputs == nullptr) {
+    return;
+  }
+  record.input_count =
+      std::min(*inputs_object.getSizes(), NetworkRecord::kMaxInputs);
+  for (int i = 0; i < record.input_count; i++) {
+    record.inputs[i] = NetworkInput{inputs[i].frame_nbr, inputs[i].input};
+  }
+}
+}  // namespace
 
 void NetworkLogic::debugReturn(int debugLevel,
                                const ExitGames::Common::JString& string) {
@@ -10,7 +40,7 @@ void NetworkLogic::debugReturn(int debugLevel,
 
 void NetworkLogic::connectionErrorReturn(int errorCode) {
   std::cout << "error connection\n";
-  currentLogInfo = "- error connection";
+  currentLogInfo.store("- error connection", std::memory_order_relaxed);
 }
 
 void NetworkLogic::clientErrorReturn(int errorCode) {
@@ -31,19 +61,13 @@ void NetworkLogic::joinRoomEventAction(
   std::cout << "Room state: player nr: " << playerNr
             << " player nrs size: " << playernrs.getSize() << " player userID: "
             << player.getUserID().UTF8Representation().cstr() << '\n';
-  currentLogInfo = "- Room Join, currently player ";
+  currentLogInfo.store("- Room Join, currently player ",
+                       std::memory_order_relaxed);
 
-  // If currentClientPlayer is not set
-  if (game_logic_->client_player_nbr == -1) {
-    game_logic_->client_player_nbr = playerNr - 1;
-    game_logic_->rollback_manager->confirmed_game_manager_.client_player_nbr =
-        playerNr - 1;
-  }
-  if (playerNr >= game::max_player) {
-    game_logic_->current_game_state = game::GameState::GameLaunch;
-    game_logic_->rollback_manager->confirmed_game_manager_.current_game_state =
-        game::GameState::GameLaunch;
-  }
+  NetworkRecord record;
+  record.type = NetworkRecordType::kPlayerJoined;
+  record.player_nbr = playerNr;
+  Receive(record);
 }
 
 void NetworkLogic::leaveRoomEventAction(int playerNr, bool isInactive) {
@@ -59,11 +83,44 @@ void NetworkLogic::customEventAction(
     return;
   }
 
-  const ExitGames::Common::Hashtable& event_data =
-      ExitGames::Common::ValueObject<ExitGames::Common::Hashtable>(eventContent)
-          .getDataCopy();
+  NetworkRecord record;
+  record.player_nbr = playerNr;
+  switch (static_cast<EventCode>(eventCode)) {
+    case EventCode::kInput:
+      record.type = NetworkRecordType::kInput;
+      break;
+    case EventCode::kFrameConfirmation:
+      record.type = NetworkRecordType::kFrameConfirmation;
+      break;
+    default:
+      std::cerr << "Unsupported event code " << static_cast<int>(eventCode)
+                << '\n';
+      return;
+  }
 
-  ReceiveEvent(playerNr, static_cast<EventCode>(eventCode), event_data);
+  const ExitGames::Common::ValueObject<ExitGames::Common::Hashtable>
+      content_object(eventContent);
+  const auto& event_content = *content_object.getDataAddress();
+  const auto checksum_value =
+      event_content.getValue(static_cast<nByte>(EventKey::kCheckSum));
+  if (checksum_value != nullptr) {
+    record.checksum =
+        ExitGames::Common::ValueObject<int>(checksum_value).getDataCopy();
+  }
+  const auto advantage_value =
+      event_content.getValue(static_cast<nByte>(EventKey::kFrameAdvantage));
+  if (advantage_value != nullptr) {
+    record.frame_advantage =
+        ExitGames::Common::ValueObject<float>(advantage_value).getDataCopy();
+  }
+  const auto delay_value =
+      event_content.getValue(static_cast<nByte>(EventKey::kInputDelay));
+  if (delay_value != nullptr) {
+    record.input_delay =
+        ExitGames::Common::ValueObject<nByte>(delay_value).getDataCopy();
+  }
+  DecodeInputs(event_content, record);
+  Receive(record);
 }
 
 void NetworkLogic::connectReturn(int errorCode,
@@ -75,15 +132,18 @@ void NetworkLogic::connectReturn(int errorCode,
             << " "
             << "region: " << region.UTF8Representation().cstr() << " "
             << "cluster: " << cluster.UTF8Representation().cstr() << '\n';
-  currentLogInfo = "- client connected";
-  is_connected = true;
+  currentLogInfo.store("- client connected", std::memory_order_relaxed);
+  is_connected.store(true, std::memory_order_relaxed);
 }
 
 void NetworkLogic::disconnectReturn() {
   std::cout << "client disconnected\n";
-  currentLogInfo = "- client disconnected";
-  is_connected = false;
-  game_logic_->current_game_state = game::GameState::LogMenu;
+  currentLogInfo.store("- client disconnected", std::memory_order_relaxed);
+  is_connected.store(false, std::memory_order_relaxed);
+
+  NetworkRecord record;
+  record.type = NetworkRecordType::kDisconnected;
+  Receive(record);
 }
 
 void NetworkLogic::leaveRoomReturn(
@@ -94,24 +154,137 @@ void NetworkLogic::leaveRoomReturn(
 }
 
 NetworkLogic::NetworkLogic(const ExitGames::Common::JString& appID,
-                           const ExitGames::Common::JString& appVersion,
-                           game::GameLogic* game_logic)
-    : mLoadBalancingClient(*this, appID, appVersion) {
-  game_logic_ = game_logic;
+                           const ExitGames::Common::JString& appVersion)
+    : mLoadBalancingClient(*this, appID, appVersion) {}
+
+void NetworkLogic::Start() {
+  is_stopping_.store(false, std::memory_order_relaxed);
+  thread_ = std::thread(&NetworkLogic::Run, this);
+}
+
+void NetworkLogic::Stop() noexcept {
+  if (!thread_.joinable()) {
+    return;
+  }
+  is_stopping_.store(true, std::memory_order_relaxed);
+  thread_.join();
+}
+
+bool NetworkLogic::Send(const NetworkRecord& record) {
+  if (!PushOrHold(sent_records_, held_sent_records_, record)) {
+    std::cerr << "Network send queue full, input dropped\n";
+    return false;
+  }
+  return true;
+}
+
+bool NetworkLogic::PushOrHold(RecordRing& ring,
+                              std::deque<NetworkRecord>& held,
+                              const NetworkRecord& record) {
+  PushHeldRecords(ring, held);
+  if (held.empty() && ring.Push(record)) {
+    return true;
+  }
+  // Inputs are sent every tick, a dropped one is sent again with the next.
+  if (record.type == NetworkRecordType::kInput) {
+    return false;
+  }
+  held.push_back(record);
+  return true;
+}
+
+void NetworkLogic::PushHeldRecords(RecordRing& ring,
+                                   std::deque<NetworkRecord>& held) noexcept {
+  while (!held.empty() && ring.Push(held.front())) {
+    held.pop_front();
+  }
+}
+
+void NetworkLogic::Run() {
+  while (!is_stopping_.load(std::memory_order_relaxed)) {
+    PushHeldRecords(received_records_, held_received_records_);
+    ExecuteCommands();
+    RaiseSentRecords();
+    mLoadBalancingClient.service();
+    round_trip_time_ms.store(mLoadBalancingClient.getRoundTripTime(),
+                             std::memory_order_relaxed);
+    std::this_thread::sleep_for(kServiceInterval);
+  }
+
+  // A last disconnect posted before the stop is still honoured.
+  ExecuteCommands();
+  RaiseSentRecords();
+  mLoadBalancingClient.service();
+}
+
+void NetworkLogic::ExecuteCommands() {
+  const auto commands =
+      pending_commands_.exchange(0, std::memory_order_acquire);
+  const auto has = [commands](NetworkCommand command) {
+    return (commands & static_cast<std::uint32_t>(command)) != 0;
+  };
+
+  if (has(NetworkCommand::kDisconnect)) {
+    Disconnect();
+  }
+  if (has(NetworkCommand::kConnect)) {
+    Connect();
+  }
+  if (has(NetworkCommand::kJoinRoom)) {
+    JoinRandomOrCreateRoom();
+  }
+}
+
+void NetworkLogic::RaiseSentRecords() noexcept {
+  std::array<Input::FrameInput, NetworkRecord::kMaxInputs> inputs;
+  NetworkRecord record;
+  while (sent_records_.Pop(record)) {
+    ExitGames::Common::Hashtable event_data;
+    if (record.type == NetworkRecordType::kFrameConfirmation &&
+        record.input_count > 0) {
+      event_data.put(static_cast<nByte>(EventKey::kCheckSum), record.checksum);
+    }
+    if (record.type == NetworkRecordType::kInput) {
+      event_data.put(static_cast<nByte>(EventKey::kFrameAdvantage),
+                     record.frame_advantage);
+      event_data.put(static_cast<nByte>(EventKey::kInputDelay),
+                     static_cast<nByte>(record.input_delay));
+    }
+    if (record.input_count > 0) {
+      for (int i = 0; i < record.input_count; i++) {
+        inputs[i].frame_nbr = record.inputs[i].frame_nbr;
+        inputs[i].input = record.inputs[i].input;
+      }
+      event_data.put(static_cast<nByte>(EventKey::kPlayerInput), inputs.data(),
+                     record.input_count);
+    }
+
+    // Inputs are sent every tick, a lost one is sent again with the next.
+    const bool reliable = record.type != NetworkRecordType::kInput;
+    const auto event_code = reliable ? EventCode::kFrameConfirmation
+                                     : EventCode::kInput;
+    if (!mLoadBalancingClient.opRaiseEvent(reliable, event_data,
+                                           static_cast<nByte>(event_code))) {
+      EGLOG(ExitGames::Common::DebugLevel::ERRORS, L"Could not raise event.");
+    }
+  }
+}
+
+void NetworkLogic::Receive(const NetworkRecord& record) {
+  if (!PushOrHold(received_records_, held_received_records_, record)) {
+    std::cerr << "Network receive queue full, input dropped\n";
+  }
 }
 
 void NetworkLogic::Connect() {
   std::cout << "hello\n";
   if (!mLoadBalancingClient.connect()) {
     EGLOG(ExitGames::Common::DebugLevel::ERRORS, L"Could not connect.");
-    currentLogInfo = "- Could not connect.";
+    currentLogInfo.store("- Could not connect.", std::memory_order_relaxed);
   }
 }
 
-void NetworkLogic::Run() { mLoadBalancingClient.service(); }
-
 void NetworkLogic::Disconnect() { mLoadBalancingClient.disconnect(); }
-
 void NetworkLogic::CreateRoom(const ExitGames::Common::JString& roomName,
                               nByte maxPlayers) {
   if (mLoadBalancingClient.opCreateRoom(
@@ -134,22 +307,7 @@ void NetworkLogic::JoinRandomOrCreateRoom() noexcept {
   if (!mLoadBalancingClient.opJoinRandomOrCreateRoom(game_id, room_options)) {
     EGLOG(ExitGames::Common::DebugLevel::ERRORS,
           L"Could not join or create room.");
-    currentLogInfo = "- Could not join or create room.";
-  }
-}
-
-void NetworkLogic::RaiseEvent(
-    bool reliable, EventCode event_code,
-    const ExitGames::Common::Hashtable& event_data) noexcept {
-  if (!mLoadBalancingClient.opRaiseEvent(reliable, event_data,
-                                         static_cast<nByte>(event_code))) {
-    EGLOG(ExitGames::Common::DebugLevel::ERRORS, L"Could not raise event.");
+    currentLogInfo.store("- Could not join or create room.",
+                         std::memory_order_relaxed);
   }
 }
-
-void NetworkLogic::ReceiveEvent(
-    int player_nr, EventCode event_code,
-    const ExitGames::Common::Hashtable& event_content) noexcept {
-  NetworkEvent event{event_code, event_content};
-  game_logic_->network_events.push(event);
-}
@@ -143,8 +143,6 @@ void PlayerManager::ResetState() {
   world_->GetBody(players_BodyRefs_[1]).SetPosition(player2_spawn_pos_);
   players[0].life_point = 5;
   players[1].life_point = 5;
-  players[0].trigger_nbr = 0;
-  players[1].trigger_nbr = 0;
 }
 
 void PlayerManager::Jump(int playerIdx) {
@@ -173,6 +171,28 @@ Math::Vec2F PlayerManager::GetPlayerPosition(int idx) const noexcept {
   return body.Position();
 }
 
+bool PlayerManager::IsGrounded(int player_idx) const noexcept {
+  const auto& grounded_collider =
+      world_->GetCollider(players_grounded_CollidersRefs_[player_idx]);
+  bool is_grounded = false;
+  world_->QueryAABB(
+      grounded_collider.rectangleShape,
+      [this, player_idx, &is_grounded](Physics::ColliderRef collider_ref) {
+        if (collider_ref == players_CollidersRefs_[player_idx] ||
+            collider_ref == players_grounded_CollidersRefs_[player_idx]) {
+          return true;
+        }
+        // The projectiles, launched, neutral or unused, never ground a player.
+        const auto id = world_->GetCollider(collider_ref).ID;
+        if (id >= projectile_id_ || id == neutral_projectile_id_ || id == -1) {
+          return true;
+        }
+        is_grounded = true;
+        return false;
+      });
+  return is_grounded;
+}
+
 void PlayerManager::Attack(int player_idx) {
   if (players[player_idx].attack_timer <= 0.0f) {
     players[player_idx].attack_timer = time_between_attack;
@@ -251,53 +271,14 @@ void PlayerManager::ProjectileTriggerDetection(Physics::Collider colliderA,
 
 void PlayerManager::OnTriggerEnter(Physics::Collider colliderA,
                                    Physics::Collider colliderB) noexcept {
-  int it = 0;
-  for (auto& player : players) {
-    if (colliderA == world_->GetCollider(players_grounded_CollidersRefs_[it]) ||
-        colliderB == world_->GetCollider(players_grounded_CollidersRefs_[it])) {
-      // No detection for playersgrounded and projectile
-      if (colliderA.ID >= projectile_id_ || colliderB.ID >= projectile_id_) {
-        break;
-      }
-      if (colliderA.ID == neutral_projectile_id_ ||
-          colliderB.ID == neutral_projectile_id_) {
-        break;
-      }
-      // When projectile is set unvalid, player was detecting trigger
-      if (colliderA.ID == -1 || colliderB.ID == -1) {
-        break;
-      }
-      players[it].trigger_nbr++;
-    }
-    it++;
-  }
-
+  // The projectile hits need the enter event: a projectile turning neutral
+  // while it still overlaps its launcher must not hit it.
   for (auto& projectile : projectiles_) {
     ProjectileTriggerDetection(colliderA, colliderB, projectile);
   }
 }
-void PlayerManager::OnTriggerExit(Physics::Collider colliderA,
-                                  Physics::Collider colliderB) noexcept {
-  int it = 0;
-  for (auto& player : players) {
-    if (colliderA == world_->GetCollider(players_grounded_CollidersRefs_[it]) ||
-        colliderB == world_->GetCollider(players_grounded_CollidersRefs_[it])) {
-      if (colliderA.ID >= projectile_id_ || colliderB.ID >= projectile_id_) {
-        break;
-      }
-      if (colliderA.ID == neutral_projectile_id_ ||
-          colliderB.ID == neutral_projectile_id_) {
-        break;
-      }
-      // When projectile is set unvalid, player was detecting trigger
-      if (colliderA.ID == -1 || colliderB.ID == -1) {
-        break;
-      }
-      players[it].trigger_nbr--;
-    }
-    it++;
-  }
-}
+void PlayerManager::OnTriggerExit(Physics::Collider,
+                                  Physics::Collider) noexcept {}
 void PlayerManager::OnCollisionEnter(Physics::Collider colliderA,
                                      Physics::Collider colliderB) noexcept {}
 void PlayerManager::OnCollisionExit(Physics::Collider colliderA,
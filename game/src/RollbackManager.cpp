@@ -1,86 +1,102 @@
 #include "RollbackManager.h"
 
+#include <algorithm>
+
 void RollbackManager::SetLocalPlayerInput(const Input::FrameInput& local_input,
     int player_id) noexcept {
     inputs_[player_id][local_input.frame_nbr] = local_input;
     last_inputs_[player_id] = local_input;
+    next_input_frames_[player_id] = static_cast<short>(local_input.frame_nbr + 1);
 }
 
 void RollbackManager::SetRemotePlayerInput(
     const std::vector<Input::FrameInput>& new_remote_inputs, int player_id) {
-    auto last_new_remote_input = new_remote_inputs.back();
-
-    // Calculate the difference between the last new remote frame and the last remote
-    // input frame
-    const auto frame_diff = last_new_remote_input.frame_nbr - last_remote_input_frame_;
+    const auto last_new_remote_input = new_remote_inputs.back();
 
-    if (frame_diff < 1) {
+    if (last_new_remote_input.frame_nbr <= last_remote_input_frame_) {
         return;
     }
 
-    // If the last remote input frame is greater than the current frame, adjust
-    // last_new_remote_input
-    if (last_new_remote_input.frame_nbr > current_frame_) {
-        const auto& current_frame_it =
-            std::find_if(new_remote_inputs.begin(), new_remote_inputs.end(),
-                [this](const Input::FrameInput& frame_input) {
-                    return frame_input.frame_nbr == current_frame_;
-                });
-        last_new_remote_input = *current_frame_it;
-    }
-
     auto missing_input_it = std::find_if(
         new_remote_inputs.begin(), new_remote_inputs.end(),
         [this](const Input::FrameInput& frame_input) {
             return frame_input.frame_nbr == last_remote_input_frame_ + 1;
         });
 
-    // Check if rollback is necessary
-    bool must_rollback = last_remote_input_frame_ == -1;
-
-    // Iterate over the missing inputs and update the inputs array
-    for (short frame = last_remote_input_frame_ + 1;
-        frame <= last_new_remote_input.frame_nbr; frame++) {
-        // Get the input for the current frame
-        const auto input = missing_input_it->input;
+    if (missing_input_it == new_remote_inputs.end()) {
+        // The inputs right after the last one received are missing, a later
+        // event carries them again.
+        return;
+    }
 
-        // Check if rollback is necessary
-        if (last_remote_input_frame_ > -1 && input != last_inputs_[player_id].input) {
-            must_rollback = true;
+    // Check if rollback is necessary: only a frame already simulated with
+    // another prediction needs it. The inputs of the current frame, and of the
+    // frames after it sent early by a delayed remote, are simply stored.
+    for (; missing_input_it != new_remote_inputs.end(); ++missing_input_it) {
+        const auto frame = missing_input_it->frame_nbr;
+        if (frame < current_frame_) {
+            predictor_->stats.predicted_frames++;
+            if (missing_input_it->input != inputs_[player_id][frame].input) {
+                predictor_->stats.mispredicted_frames++;
+                rollback_frame_ = std::min(rollback_frame_, frame);
+            }
         }
-
-        // Update the inputs array
         inputs_[player_id][frame] = *missing_input_it;
 
-        // Move to the next missing input
-        ++missing_input_it;
+        // Every predictor learns, to be trained when it is chosen.
+        for (auto* predictor : predictors_) {
+            predictor->Observe(missing_input_it->input);
+        }
     }
 
-    // Predict inputs for frames up to the current frame with the last remote input.
-    for (short frame = last_new_remote_input.frame_nbr;
+    // Predict inputs for frames up to the current frame from the last remote input.
+    for (short frame = last_new_remote_input.frame_nbr + 1;
         frame <= current_frame_; frame++) {
-        inputs_[player_id][frame] = last_new_remote_input;
-    }
-
-    // Rollback if necessary.
-    if (must_rollback) {
-        SimulateUntilCurrentFrame();
+        auto predicted_input = last_new_remote_input;
+        predicted_input.frame_nbr = frame;
+        predicted_input.input = predictor_->Predict(
+            last_new_remote_input.input, frame - last_new_remote_input.frame_nbr);
+        if (frame < current_frame_ &&
+            predicted_input.input != inputs_[player_id][frame].input) {
+            rollback_frame_ = std::min(rollback_frame_, frame);
+        }
+        inputs_[player_id][frame] = predicted_input;
     }
 
     // Update last inputs and last remote input frame.
     last_inputs_[player_id] = last_new_remote_input;
     last_remote_input_frame_ = last_new_remote_input.frame_nbr;
+    next_input_frames_[player_id] = static_cast<short>(last_remote_input_frame_ + 1);
 }
 
+void RollbackManager::IncreaseCurrentFrame(int local_player_id) noexcept {
+    current_frame_++;
+
+    // The remote players whose input is not known yet are predicted from their
+    // last one. The local input is set by the game logic before the frame is
+    // simulated, never made up.
+    for (int player_id = 0; player_id < game::max_player; player_id++) {
+        if (player_id == local_player_id) {
+            continue;
+        }
+        if (current_frame_ >= next_input_frames_[player_id]) {
+            auto& input = inputs_[player_id][current_frame_];
+            input = last_inputs_[player_id];
+            input.frame_nbr = current_frame_;
+            input.input = predictor_->Predict(last_inputs_[player_id].input,
+                current_frame_ - next_input_frames_[player_id] + 1);
+        }
+    }
+}
 
 void RollbackManager::SimulateUntilCurrentFrame() const noexcept {
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
 
-    current_game_manager_->Rollback(confirmed_game_manager_);
+    current_game_manager_->Rollback(settled_game_manager_);
 
-    for (short frame = static_cast<short>(confirmed_frame_ + 1);
+    for (short frame = static_cast<short>(settled_frame_ + 1);
         frame < current_frame_; frame++) {
         for (int player_id = 0; player_id < game::max_player;
             player_id++) {
@@ -93,6 +109,66 @@ void RollbackManager::SimulateUntilCurrentFrame() const noexcept {
     // received events from network.
 }
 
+void RollbackManager::SettleKnownFrames() noexcept {
+    // The local inputs of the frames before the current one are all set, the
+    // remote ones are known up to the last received.
+    const auto last_known_frame = std::min(last_remote_input_frame_,
+        static_cast<short>(current_frame_ - 1));
+    while (settled_frame_ < last_known_frame) {
+        settled_frame_++;
+        for (int player_id = 0; player_id < game::max_player;
+            player_id++) {
+            const auto input = inputs_[player_id][settled_frame_];
+            settled_game_manager_.SetPlayerInput(input, player_id);
+        }
+        settled_game_manager_.UpdateGameplay();
+    }
+}
+
+void RollbackManager::ApplyPendingRollback() noexcept {
+    // Settled every tick, the state a rollback restores stays within
+    // kMaxPredictionFrames of the current frame.
+    SettleKnownFrames();
+    if (rollback_frame_ == kNoRollback) {
+        return;
+    }
+
+    predictor_->stats.rollback_count++;
+    predictor_->stats.rollback_depth_sum += current_frame_ - settled_frame_ - 1;
+    predictor_->stats.misprediction_distance_sum +=
+        current_frame_ - rollback_frame_;
+
+    const auto& player_manager = current_game_manager_->player_manager;
+    RollbackOffsets predicted;
+    std::array<bool, PlayerManager::max_projectile_> was_projectile_active{};
+    for (int i = 0; i < game::max_player; i++) {
+        predicted.players[i] = player_manager.GetPlayerPosition(i);
+    }
+    for (int i = 0; i < PlayerManager::max_projectile_; i++) {
+        predicted.projectiles[i] = player_manager.GetProjectilePosition(i);
+        was_projectile_active[i] = player_manager.projectiles_[i].isActive;
+    }
+
+    // The settled state already holds every input received, only the frames
+    // predicted after it are simulated again.
+    SimulateUntilCurrentFrame();
+    rollback_frame_ = kNoRollback;
+
+    // Only what the rollback changed is shown sliding back, the entities it
+    // left in place do not move.
+    for (int i = 0; i < game::max_player; i++) {
+        rollback_offsets_.players[i] +=
+            predicted.players[i] - player_manager.GetPlayerPosition(i);
+    }
+    for (int i = 0; i < PlayerManager::max_projectile_; i++) {
+        if (was_projectile_active[i] &&
+            player_manager.projectiles_[i].isActive) {
+            rollback_offsets_.projectiles[i] += predicted.projectiles[i] -
+                player_manager.GetProjectilePosition(i);
+        }
+    }
+}
+
 int RollbackManager::ConfirmFrame() noexcept {
     for (int player_id = 0; player_id < game::max_player;
         player_id++) {
@@ -108,8 +184,3 @@ int RollbackManager::ConfirmFrame() noexcept {
 
     return checksum;
 }
-
-const Input::FrameInput& RollbackManager::GetLastPlayerConfirmedInput(
-    const int player_id) const noexcept {
-    return last_inputs_[player_id];
-}
@@ -0,0 +1,252 @@
+#include "SimulationThread.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "FixedTimestep.h"
+
+namespace {
+// The part of a rollback correction still shown a tick later, a tenth of it is
+// left after five ticks.
+constexpr float kCorrectionDecay = 0.6f;
+// A larger correction is a respawn rather than a misprediction, it snaps.
+constexpr float kMaxCorrection = 120.f;
+
+raylib::Vector2 ToVector2(Math::Vec2F vector) noexcept {
+  return raylib::Vector2{vector.X, vector.Y};
+}
+
+// Fades the correction of an entity by a tick, and adds the offset the
+// rollback of the tick moved it by.
+raylib::Vector2 FadeCorrection(raylib::Vector2 correction,
+                               Math::Vec2F rollback_offset) noexcept {
+  correction.x = correction.x * kCorrectionDecay + rollback_offset.X;
+  correction.y = correction.y * kCorrectionDecay + rollback_offset.Y;
+  if (std::abs(correction.x) > kMaxCorrection ||
+      std::abs(correction.y) > kMaxCorrection) {
+    return raylib::Vector2{0.f, 0.f};
+  }
+  return correction;
+}
+
+// Adds the outline of a collider, its rectangle moved by rectangle_offset and
+// its circle centered on the body.
+void AddDebugShape(RenderSnapshot& snapshot, const Physics::Collider& collider,
+                   Math::Vec2F rectangle_offset, Math::Vec2F body_position,
+                   raylib::Color color) noexcept {
+  if (snapshot.debug_shape_count == RenderSnapshot::kMaxDebugShapes) {
+    return;
+  }
+  auto& shape = snapshot.debug_shapes[snapshot.debug_shape_count];
+  switch (collider._shape) {
+    case Math::ShapeType::Rectangle:
+      shape.position =
+          ToVector2(rectangle_offset + collider.rectangleShape.MinBound());
+      shape.size = ToVector2(collider.rectangleShape.MaxBound() -
+                             collider.rectangleShape.MinBound());
+      break;
+    case Math::ShapeType::Circle:
+      shape.position = ToVector2(body_position);
+      shape.size = raylib::Vector2{collider.circleShape.Radius(), 0.f};
+      break;
+    default:
+      return;
+  }
+  shape.type = collider._shape;
+  shape.color = color;
+  snapshot.debug_shape_count++;
+}
+}  // namespace
+
+void SimulationThread::Start() {
+  is_stopping_.store(false, std::memory_order_relaxed);
+  thread_ = std::thread(&SimulationThread::Run, this);
+}
+
+void SimulationThread::Stop() noexcept {
+  if (!thread_.joinable()) {
+    return;
+  }
+  is_stopping_.store(true, std::memory_order_relaxed);
+  thread_.join();
+}
+
+float SimulationThread::InterpolationAlpha(
+    const RenderSnapshot& snapshot) noexcept {
+  const double elapsed = Now() - snapshot.tick_time;
+  return static_cast<float>(std::clamp(
+      elapsed / game::GameLogic::fixedUpdateFrenquency, 0.0, 1.0));
+}
+
+double SimulationThread::Now() noexcept {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void SimulationThread::Run() {
+  FixedTimestep timestep(game::GameLogic::fixedUpdateFrenquency,
+                         kMaxTicksPerWake);
+  double last_time = Now();
+  Publish();
+
+  while (!is_stopping_.load(std::memory_order_relaxed)) {
+    ExecuteCommands();
+
+    // The ticks stretch while the local player runs ahead of the remote one.
+    const double time_scale = game_logic_->time_sync.TimeScale();
+    const double now = Now();
+    const int tick_count = timestep.Advance((now - last_time) * time_scale);
+    last_time = now;
+    for (int tick = 0; tick < tick_count; tick++) {
+      const auto sampled_input = input_sampler_.Consume();
+      game_logic_->local_input = sampled_input.input;
+      game_logic_->input_delay_setting =
+          input_delay_setting_.load(std::memory_order_relaxed);
+      rollback_manager_->SetPredictor(
+          predictor_type_.load(std::memory_order_relaxed));
+      input_sample_time_ = sampled_input.sample_time;
+      game_logic_->Update();
+      Publish();
+    }
+
+    // Sleeps until the next tick is due.
+    std::this_thread::sleep_for(std::chrono::duration<double>(
+        (1.f - timestep.Alpha()) * timestep.Step() / time_scale));
+  }
+
+  // A last reset posted before the stop is still honoured.
+  ExecuteCommands();
+}
+
+void SimulationThread::ExecuteCommands() {
+  const auto commands =
+      pending_commands_.exchange(0, std::memory_order_acquire);
+  const auto has = [commands](SimulationCommand command) {
+    return (commands & static_cast<std::uint32_t>(command)) != 0;
+  };
+
+  if (has(SimulationCommand::kReturnToMenu)) {
+    rollback_manager_->Reset();
+    game_logic_->ResetState();
+    rollback_manager_->RegisterGameManager(game_logic_);
+    network_logic_->Post(NetworkCommand::kDisconnect);
+  }
+}
+
+void SimulationThread::Publish() noexcept {
+  auto& snapshot = snapshots_.WriteBuffer();
+  const auto& player_manager = game_logic_->player_manager;
+  const auto rollback_offsets = rollback_manager_->TakeRollbackOffsets();
+
+  snapshot.tick = ++tick_;
+  snapshot.tick_time = Now();
+  snapshot.input_sample_time = input_sample_time_;
+  snapshot.game_state = game_logic_->current_game_state;
+  snapshot.client_player_nbr = game_logic_->client_player_nbr;
+  snapshot.rollback_count = game_logic_->rollback_count;
+  snapshot.frame_advantage = game_logic_->time_sync.Advantage();
+  snapshot.input_delay = game_logic_->input_delay;
+  snapshot.stalled_tick_count = game_logic_->stalled_tick_count;
+  snapshot.prediction_stats = rollback_manager_->prediction_stats();
+  snapshot.is_connected =
+      network_logic_->is_connected.load(std::memory_order_relaxed);
+  snapshot.log_info =
+      network_logic_->currentLogInfo.load(std::memory_order_relaxed);
+
+  for (int i = 0; i < game::max_player; i++) {
+    snapshot.life_points[i] = player_manager.players[i].life_point;
+    snapshot.is_projectile_ready[i] =
+        player_manager.players[i].is_projectile_ready;
+  }
+
+  snapshot.debug_shape_count = 0;
+  if (snapshot.game_state != game::GameState::GameLaunch) {
+    has_published_positions_ = false;
+    snapshots_.Publish();
+    return;
+  }
+
+  // The first tick of a game has no tick before, it starts still.
+  const bool has_previous = has_published_positions_;
+  has_published_positions_ = true;
+  for (int i = 0; i < game::max_player; i++) {
+    const auto previous = players_[i];
+    auto& transform = players_[i];
+    transform.position = ToVector2(player_manager.GetPlayerPosition(i));
+    transform.correction =
+        has_previous
+            ? FadeCorrection(previous.correction, rollback_offsets.players[i])
+            : raylib::Vector2{0.f, 0.f};
+    snapshot.players[i] = transform;
+    snapshot.previous_players[i] = has_previous ? previous : transform;
+  }
+  for (int i = 0; i < PlayerManager::max_projectile_; i++) {
+    const bool is_active = player_manager.projectiles_[i].isActive;
+    // A new projectile appears where it is, not sliding from its last use.
+    const bool is_new =
+        !has_previous || (is_active && !is_projectile_active_[i]);
+    const auto previous = projectiles_[i];
+    auto& transform = projectiles_[i];
+    transform.position = ToVector2(player_manager.GetProjectilePosition(i));
+    transform.correction =
+        is_new ? raylib::Vector2{0.f, 0.f}
+               : FadeCorrection(previous.correction,
+                                rollback_offsets.projectiles[i]);
+    snapshot.projectiles[i] = transform;
+    snapshot.previous_projectiles[i] = is_new ? transform : previous;
+    snapshot.is_projectile_active[i] = is_active;
+    is_projectile_active_[i] = is_active;
+  }
+  if (are_debug_shapes_visible_.load(std::memory_order_relaxed)) {
+    CollectDebugShapes(snapshot);
+  }
+  snapshots_.Publish();
+}
+
+void SimulationThread::CollectDebugShapes(
+    RenderSnapshot& snapshot) const noexcept {
+  auto& world = game_logic_->world_;
+  const auto& player_manager = game_logic_->player_manager;
+  const Math::Vec2F no_offset(0.f, 0.f);
+
+  for (int i = 0; i < game::max_player; i++) {
+    const auto position =
+        world.GetBody(player_manager.players_BodyRefs_[i]).Position();
+    AddDebugShape(snapshot,
+                  world.GetCollider(player_manager.players_CollidersRefs_[i]),
+                  position, position, raylib::PURPLE);
+
+    // The bounds of the grounded trigger follow the player already.
+    const auto& grounded_collider =
+        world.GetCollider(player_manager.players_grounded_CollidersRefs_[i]);
+    AddDebugShape(snapshot, grounded_collider, no_offset, position,
+                  grounded_collider.isTrigger ? raylib::BLUE : raylib::PURPLE);
+  }
+
+  for (const auto& projectile : player_manager.projectiles_) {
+    const auto position = world.GetBody(projectile.projectile_body).Position();
+    AddDebugShape(snapshot, world.GetCollider(projectile.projectile_collider),
+                  position, position, raylib::PURPLE);
+  }
+
+  for (const auto& collider : game_logic_->colliders_) {
+    const auto& physics_collider = world.GetCollider(collider.colliderRef);
+    const auto& body = world.GetBody(collider.bodyRef);
+
+    auto color = raylib::WHITE;
+    switch (body.type) {
+      case Physics::BodyType::DYNAMIC:
+        color = physics_collider.isTrigger ? raylib::BLUE : raylib::RED;
+        break;
+      case Physics::BodyType::STATIC:
+        color = physics_collider.isTrigger ? raylib::ORANGE : raylib::YELLOW;
+        break;
+      default:
+        break;
+    }
+    AddDebugShape(snapshot, physics_collider, no_offset, body.Position(),
+                  color);
+  }
+}
@@ -0,0 +1,35 @@
+#include "SpriteBatch.h"
+
+#include <algorithm>
+
+void SpriteBatch::Add(const ImageCustom& image, raylib::Vector2 position,
+                      float scale, int layer) {
+  Quad quad;
+  if (!image.ComputeQuad(position, scale, quad.source, quad.dest)) {
+    return;
+  }
+  quad.texture = image.cache->Texture(image.texture);
+  quad.layer = layer;
+  quad.order = static_cast<std::uint32_t>(quads_.size());
+  quads_.push_back(quad);
+}
+
+void SpriteBatch::Flush() noexcept {
+  // The order of addition breaks the ties, std::sort then gives the result of
+  // a stable sort without its temporary buffer.
+  std::sort(quads_.begin(), quads_.end(), [](const Quad& a, const Quad& b) {
+    if (a.layer != b.layer) {
+      return a.layer < b.layer;
+    }
+    if (a.texture.id != b.texture.id) {
+      return a.texture.id < b.texture.id;
+    }
+    return a.order < b.order;
+  });
+
+  for (const auto& quad : quads_) {
+    raylib::DrawTexturePro(quad.texture, quad.source, quad.dest,
+                           raylib::Vector2{0, 0}, 0.f, raylib::WHITE);
+  }
+  quads_.clear();
+}
@@ -6,7 +6,10 @@ int main() {
   GameApp game_app;
 
   game_app.Init();
-  raylib::SetTargetFPS(60);
+  // The simulation runs at its own fixed rate, the frames follow the monitor.
+  const int refresh_rate =
+      raylib::GetMonitorRefreshRate(raylib::GetCurrentMonitor());
+  raylib::SetTargetFPS(refresh_rate > 0 ? refresh_rate : 60);
   while (!raylib::WindowShouldClose()) {
     game_app.Loop();
   }
@@ -2,6 +2,8 @@
 
 #include "Vec2.h"
 
+#include <cstdint>
+
 
 namespace Physics
 {
@@ -24,16 +26,21 @@ namespace Physics
     /**
      * @struct BodyRef
      * @brief Represents a reference to a physics body in a simulation.
-     * The BodyRef struct consists of two members:
-     * - `index`: An index value identifying the body.
-     * - `genIdx`: A generation index used for tracking changes in the body.
+     * The BodyRef struct consists of two members packed in 32 bits:
+     * - `index`: An index value identifying the body, on IndexBits bits.
+     * - `genIdx`: A generation index used for tracking changes in the body, on GenerationBits bits, wrapping around.
+     * - `MaxIndex`: The highest index a body can get, the World never creates more bodies than MaxIndex + 1.
      *
      * The equality operator (`==`) is overridden to compare two BodyRef instances for equality based on both index and genIdx.
      */
     struct BodyRef
     {
-        std::size_t index;
-        std::size_t genIdx;
+        static constexpr std::uint32_t IndexBits = 24;
+        static constexpr std::uint32_t GenerationBits = 8;
+        static constexpr std::size_t MaxIndex = (std::size_t{1} << IndexBits) - 1;
+
+        std::uint32_t index : IndexBits;
+        std::uint32_t genIdx : GenerationBits;
 
         constexpr bool operator==(const BodyRef& other) const
         {
@@ -41,6 +48,8 @@ namespace Physics
         }
     };
 
+    static_assert(sizeof(BodyRef) == sizeof(std::uint32_t), "BodyRef must stay a 32-bit handle");
+
 
     /**
      * @class Body
@@ -52,14 +61,18 @@ namespace Physics
      * The class has the following public methods:
      * - `float Mass() const noexcept`: Returns the mass of the body.
      * - `void SetMass(float mass) noexcept`: Sets the mass of the body.
-     * - `Math::Vec2F Velocity() noexcept`: Returns the velocity of the body.
+     * - `Math::Vec2F Velocity() const noexcept`: Returns the velocity of the body.
      * - `void SetVelocity(Math::Vec2F velocity) noexcept`: Sets the velocity of the body.
-     * - `Math::Vec2F Position() noexcept`: Returns the position of the body.
+     * - `Math::Vec2F Position() const noexcept`: Returns the position of the body.
      * - `void SetPosition(Math::Vec2F position) noexcept`: Sets the position of the body.
-     * - `Math::Vec2F Force() noexcept`: Returns the total force applied to the body.
+     * - `Math::Vec2F Force() const noexcept`: Returns the total force applied to the body.
      * - `void SetForce(Math::Vec2F force) noexcept`: Sets the force applied to the body.
      * - `void AddForce(Math::Vec2F force) noexcept`: Adds a force to the total forces applied to the body.
      * - `bool IsValid() const noexcept`: Checks if the body is valid -> if it has a positive mass.
+     * - `bool IsAwake() const noexcept`: Checks if the body is awake, a sleeping body is not integrated by the World.
+     * - `void SetAwake(bool isAwake) noexcept`: Wakes up the body or puts it to sleep.
+     *
+     * Setting a non-zero velocity or adding a non-zero force wakes the body up.
      */
     class Body
     {
@@ -69,6 +82,9 @@ namespace Physics
         Math::Vec2F _position = Math::Vec2F(0, 0);
         Math::Vec2F _totalForce = Math::Vec2F(0,
                                               0); /** @Note total amout of force applied to the body during a frame **/
+        bool _isAwake = true;
+
+        friend class WorldBatch;
 
     public :
         BodyType type = BodyType::DYNAMIC;
@@ -95,21 +111,21 @@ namespace Physics
         /**
         * @brief Return the velocity
         */
-        [[nodiscard]] Math::Vec2F Velocity() noexcept;
+        [[nodiscard]] Math::Vec2F Velocity() const noexcept;
 
         void SetVelocity(Math::Vec2F velocity) noexcept;
 
         /**
         * @brief Return the Position
         */
-        [[nodiscard]] Math::Vec2F Position() noexcept;
+        [[nodiscard]] Math::Vec2F Position() const noexcept;
 
         void SetPosition(Math::Vec2F position) noexcept;
 
         /**
         * @brief Return the addition of all the forces that will be applied
         */
-        [[nodiscard]] Math::Vec2F Force() noexcept;
+        [[nodiscard]] Math::Vec2F Force() const noexcept;
 
         void SetForce(Math::Vec2F force) noexcept;
 
@@ -128,5 +144,15 @@ namespace Physics
             return _mass > 0.;
         };
 
+        /**
+        * @brief Return true if the body is awake, the World only integrates the awake dynamic bodies
+        */
+        [[nodiscard]] constexpr bool IsAwake() const noexcept
+        {
+            return _isAwake;
+        };
+
+        void SetAwake(bool isAwake) noexcept;
+
     };
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include "Shape.h"
 #include "Body.h"
+#include <algorithm>
+#include <cstdint>
 #include <unordered_set>
 
 namespace Physics
@@ -9,16 +11,21 @@ namespace Physics
      * @struct ColliderRef
      * @brief Represents a reference to a collider in a physics simulation.
      *
-     * The ColliderRef struct consists of two members:
-     * - `index`: An index value identifying the collider.
-     * - `genIdx`: A generation index used for tracking generation of the collider.
+     * The ColliderRef struct consists of two members packed in 32 bits:
+     * - `index`: An index value identifying the collider, on IndexBits bits.
+     * - `genIdx`: A generation index used for tracking generation of the collider, on GenerationBits bits, wrapping around.
+     * - `MaxIndex`: The highest index a collider can get, the World never creates more colliders than MaxIndex + 1.
      *
      * The equality and inequality operators (`==` and `!=`) are overridden to compare two ColliderRef instances for equality based on both index and genIdx.
      */
     struct ColliderRef
     {
-        std::size_t index;
-        std::size_t genIdx;
+        static constexpr std::uint32_t IndexBits = 24;
+        static constexpr std::uint32_t GenerationBits = 8;
+        static constexpr std::size_t MaxIndex = (std::size_t{1} << IndexBits) - 1;
+
+        std::uint32_t index : IndexBits;
+        std::uint32_t genIdx : GenerationBits;
 
         constexpr bool operator==(const ColliderRef& other) const noexcept
         {
@@ -27,11 +34,13 @@ namespace Physics
 
         constexpr bool operator!=(const ColliderRef& other) const noexcept
         {
-            return index != other . index;
+            return !(*this == other);
         }
 
     };
 
+    static_assert(sizeof(ColliderRef) == sizeof(std::uint32_t), "ColliderRef must stay a 32-bit handle");
+
 
     /**
      * @class Collider
@@ -113,14 +122,17 @@ namespace Physics
 
     /**
     * @brief Hash function for colliderPair, needed to create an unordered_set of colliderPair
+    * \n Note : The pair is ordered by index before being mixed, so both orders of a pair hash the same, and the
+    * Fibonacci multiply spreads consecutive indices over the high bits used by open addressing tables.
     **/
     struct ColliderPairHash
     {
         std::size_t operator()(const ColliderPair& pair) const
         {
-            std::size_t hashA = std::hash<int>{}(static_cast<int>(pair . colliderA . index));
-            std::size_t hashB = std::hash<int>{}(static_cast<int>(pair . colliderB . index));
-            return hashA + hashB;
+            const auto indexA = static_cast<std::uint64_t>(pair . colliderA . index);
+            const auto indexB = static_cast<std::uint64_t>(pair . colliderB . index);
+            const auto key = std::min(indexA, indexB) << 32 | std::max(indexA, indexB);
+            return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 32);
         }
     };
-}
\ No newline at end of file
+}
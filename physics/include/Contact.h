@@ -18,13 +18,35 @@ namespace Physics
         Collider* collider = nullptr;
     };
 
+    /**
+     * @struct ContactManifold
+     * @brief Represents the persistent state of a contact between two colliders, kept from one step to the next.
+     *
+     * The ContactManifold struct stores the contact geometry and the impulse accumulated by the solver for a pair of
+     * colliders, so the next step can start from the previous impulse instead of zero (warm starting).
+     *
+     * The struct has the following members:
+     * - `Math::Vec2F point`: The contact point.
+     * - `Math::Vec2F normal`: The contact normal, from the second body to the first one.
+     * - `float penetration`: The penetration depth along the normal.
+     * - `float normalImpulse`: The impulse accumulated along the normal, never negative.
+     */
+    struct ContactManifold
+    {
+        Math::Vec2F point{};
+        Math::Vec2F normal{};
+        float penetration = 0.0f;
+        float normalImpulse = 0.0f;
+    };
+
     /**
      * @class Contact
      * @brief Represents a contact point between two colliding bodies.
      *
      * The Contact class encapsulates information about a contact point between two bodies, including colliding bodies,
      * contact normal, contact position, penetration depth, and restitution.
-     * It includes methods to calculate relative velocity, resolve velocity, resolve interpenetration, and resolve the collision.
+     * The velocity is solved with sequential impulses: the impulse accumulated along the normal is clamped to stay
+     * positive, so the solver can be iterated over several contacts and warm started from the previous step.
      *
      * The class has the following public properties and methods:
      * - `std::array<CollidingBody, 2> collidingBodies`: An array of two CollidingBody instances representing the bodies involved in the collision.
@@ -32,10 +54,15 @@ namespace Physics
      * - `Math::Vec2F contactPosition`: The position of the contact point.
      * - `float penetration`: The penetration depth indicating how much the bodies overlap.
      * - `float restitution`: The restitution coefficient for the collision.
+     * - `float normalImpulse`: The impulse accumulated along the normal during this step.
      * - `float CalculateSeparateVelocity() const noexcept`: Calculates the relative velocity of colliding bodies along the contact normal.
-     * - `void ResolveVelocity() const noexcept`: Resolves the velocity of colliding bodies based on their relative velocity and restitution.
+     * - `void ComputeManifold() noexcept`: Computes the contact normal, position and penetration of the colliding bodies.
+     * - `void PrepareVelocity() noexcept`: Computes the restitution, the inverse masses and the target separating velocity.
+     * - `void WarmStart(const ContactManifold &previous) noexcept`: Applies the impulse of the previous step if the contact did not turn.
+     * - `void ResolveVelocity() noexcept`: Runs one sequential impulse iteration on the velocity of colliding bodies.
      * - `void ResolveInterpenetration() const noexcept`: Resolves interpenetration of colliding bodies by adjusting their positions.
      * - `void Resolve()`: Resolves the collision by determining the contact normal, penetration, and applying velocity and position corrections.
+     * - `ContactManifold Manifold() const noexcept`: Returns the manifold to keep for the next step.
      *
      * This class is crucial for handling collision responses, ensuring realistic physics interactions between bodies.
      */
@@ -47,6 +74,12 @@ namespace Physics
         Math::Vec2F contactPosition{};
         float penetration = 0.0f;
         float restitution = 0.0f;
+        float normalImpulse = 0.0f;
+
+        /**
+         * @brief Minimum cosine between the previous and the current normal to reuse the previous impulse.
+         */
+        static constexpr float WarmStartNormalTolerance = 0.95f;
 
         /**
          * @brief Calculates the relative velocity of colliding bodies along the contact normal.
@@ -55,9 +88,27 @@ namespace Physics
         float CalculateSeparateVelocity() const noexcept;
 
         /**
-         * @brief Resolves the velocity of colliding bodies based on their relative velocity and restitution.
+         * @brief Computes the contact normal, position and penetration from the shapes of the colliding bodies.
+         * \n Note : A rectangle against a circle swaps the colliding bodies, so the circle is always the first one.
+         */
+        void ComputeManifold() noexcept;
+
+        /**
+         * @brief Computes the restitution, the inverse masses and the separating velocity the solver aims for.
+         * \n Note : Must be called after ComputeManifold and before WarmStart, a static body has an inverse mass of 0.
          */
-        void ResolveVelocity() const noexcept;
+        void PrepareVelocity() noexcept;
+
+        /**
+         * @brief Applies the impulse accumulated by the previous step, if the contact normal did not turn too much.
+         * @param previous The manifold kept from the previous step.
+         */
+        void WarmStart(const ContactManifold& previous) noexcept;
+
+        /**
+         * @brief Runs one sequential impulse iteration on the velocity of colliding bodies.
+         */
+        void ResolveVelocity() noexcept;
 
         /**
          * @brief Resolves interpenetration of colliding bodies by adjusting their positions.
@@ -68,5 +119,19 @@ namespace Physics
          * @brief Resolves the collision by determining the contact normal, penetration, and applying velocity and position corrections.
          */
         void Resolve();
+
+        /**
+         * @return The manifold of the contact, to warm start the next step.
+         */
+        [[nodiscard]] ContactManifold Manifold() const noexcept;
+
+    private:
+        std::array<float, 2> _inverseMasses{};
+        float _targetSeparateVelocity = 0.0f;
+
+        /**
+         * @brief Applies an impulse along the contact normal, pushing the first body and pulling the second one.
+         */
+        void ApplyImpulse(float impulse) const noexcept;
     };
 }
\ No newline at end of file
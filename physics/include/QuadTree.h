@@ -3,9 +3,12 @@
 #include "Shape.h"
 #include "Collider.h"
 #include "Metrics.h"
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include "Allocator.h"
+#include "SimulationArena.h"
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
 #include <TracyC.h>
@@ -40,23 +43,26 @@ namespace Physics
      *
      * The struct has the following members:
      * - `Math::RectangleF bounds`: The bounding rectangle defining the region covered by the quad node.
-     * - `std::array<QuadNode*, 4> children`: An array of pointers to the quad node's four children.
-     * - `AllocatedVector<SimplifedCollider> colliders`: A vector of simplified colliders contained within the quad node.
+     * - `std::array<std::uint32_t, 4> children`: The indices of the quad node's four children in the nodes of the QuadTree, NoChild if it is a leaf.
+     * - `ArenaVector<SimplifedCollider> colliders`: The simplified colliders contained within the quad node, stored in the simulation arena.
      *
+     * \n Note : A node holds indices and offsets only, so the nodes can be copied with the arena they live in.
      *
      * This struct facilitates the creation and management of a quadtree for spatial partitioning.
      */
     struct QuadNode
     {
-        Math::RectangleF bounds{Math::Vec2F::Zero(), Math::Vec2F::Zero()};
-        std::array<QuadNode*, 4> children{nullptr, nullptr, nullptr, nullptr};
-        AllocatedVector <SimplifedCollider> colliders{};
+        // The root is never a child, index 0 marks a leaf.
+        static constexpr std::uint32_t NoChild = 0;
 
-        QuadNode() noexcept = default;
+        Math::RectangleF bounds{Math::Vec2F::Zero(), Math::Vec2F::Zero()};
+        std::array<std::uint32_t, 4> children{NoChild, NoChild, NoChild, NoChild};
+        ArenaVector<SimplifedCollider> colliders{};
 
-        explicit QuadNode(Allocator& allocator) noexcept:
-                colliders{StandardAllocator < Collider > {allocator}}
-        {};
+        [[nodiscard]] bool HasChildren() const noexcept
+        {
+            return children[0] != NoChild;
+        }
     };
 
 /**
@@ -65,39 +71,37 @@ namespace Physics
      *
      * The QuadTree class represents a quadtree, a tree data structure used for spatial partitioning in applications
      * such as collision detection. The quadtree divides space into quadrants, allowing for efficient spatial queries.
+     * Its nodes live in the simulation arena of the World, every method takes that arena.
      *
      * The class has the following members:
-     * - `HeapAllocator heapAllocator`: An allocator for managing memory used by the quadtree.
-     * - `AllocatedVector<QuadNode> nodes{StandardAllocator<QuadNode>{heapAllocator}}` : represent the nodes created in the quad tree
-     * - `int nodeIndex`: index used to navigate through the nodes.
-     * - `AllocatedVector <ColliderPair> nodeColliderPairs{StandardAllocator <ColliderPair > {heapAllocator}}`: An allocated vector to store collider pairs within the quadtree.
+     * - `ArenaVector<QuadNode> nodes` : represent the nodes created in the quad tree, the root first.
+     * - `std::uint32_t nodeIndex`: index of the next free node.
      * - `static const auto MaxColliderInNode`: A constant defining the maximum number of colliders allowed in a single quadtree node.
      * - `static const auto MaxDepth`: A constant defining the maximum depth of the quadtree.
      *
      * The class provides the following methods:
-     * - `void Init()`: pre allocating memory for nodes and collider pairs.
-     * - `void Subdivide(QuadNode& node)`: Subdivides the quad node into four children, splitting the space into quadrants.
-     * - `void InsertInRootNode(const SimplifiedCollider &simplifiedCollider) noexcept`: Inserts a simplified collider into the root QuadNode of the QuadTree.
-     * - `void SubdivideNodeRecursively(QuadNode &node, int depth) noexcept`: Recursively subdivides a QuadNode if it contains more colliders than the maximum allowed or if the depth limit is not reached.
-     * - `void FindPossiblePairs(QuadNode &node) noexcept`: Finds possible collider pairs within a QuadNode and its children.
-     * - `void FindInChildrenNodePossiblePairs(QuadNode &node, Engine::ColliderRef &colliderRef) noexcept`: Finds possible collider pairs between a specific collider and the colliders within a QuadNode and its children.
-     * - `void Clear() noexcept`: Clears the QuadTree, resetting it to an empty state.
+     * - `void Init(SimulationArena& arena)`: pre allocating memory for nodes and collider pairs.
+     * - `void Subdivide(SimulationArena& arena, std::uint32_t node)`: Subdivides the quad node into four children, splitting the space into quadrants.
+     * - `void InsertInRootNode(SimulationArena& arena, const SimplifiedCollider &simplifiedCollider) noexcept`: Inserts a simplified collider into the root QuadNode of the QuadTree.
+     * - `void SubdivideNodeRecursively(SimulationArena& arena, std::uint32_t node, int depth) noexcept`: Recursively subdivides a QuadNode if it contains more colliders than the maximum allowed or if the depth limit is not reached.
+     * - `void FindPossiblePairs(const SimulationArena& arena, const QuadNode &node, AllocatedVector<ColliderPair> &pairs)`: Finds possible collider pairs within a QuadNode and its children.
+     * - `void FindInChildrenNodePossiblePairs(const SimulationArena& arena, const QuadNode &node, Physics::ColliderRef colliderRef, AllocatedVector<ColliderPair> &pairs)`: Finds possible collider pairs between a specific collider and the colliders within a QuadNode and its children.
+     * - `void Clear(SimulationArena& arena) noexcept`: Clears the QuadTree, resetting it to an empty state.
+     * - `bool QueryAABB(const SimulationArena& arena, const QuadNode &node, const Math::RectangleF &aabb, Visitor &visitor) const`: Visits the colliders whose AABB overlaps an AABB.
+     * - `bool RayCast(const SimulationArena& arena, const QuadNode &node, Math::Vec2F origin, Math::Vec2F delta, Visitor &visitor) const`: Visits the colliders whose AABB is crossed by a segment.
+     * - `static bool SegmentIntersect(const Math::RectangleF &rectangle, Math::Vec2F origin, Math::Vec2F delta) noexcept`: Checks if a segment crosses a rectangle.
+     * - `static bool IsParallelToSlab(float delta) noexcept`: Checks if a segment is parallel to the slabs of an axis.
      *
      * This class facilitates the creation and management of a quadtree for spatial partitioning of colliders.
      */
     class QuadTree
     {
     public:
-        HeapAllocator heapAllocator;
-        AllocatedVector <QuadNode> nodes{StandardAllocator < QuadNode > {heapAllocator}};
-        int nodeIndex = 1;
-        AllocatedVector <ColliderPair> nodeColliderPairs{
-                StandardAllocator < ColliderPair > {heapAllocator}};
-
-        static const auto MaxColliderInNode = 4;
-        static const auto MaxDepth = 6;
+        ArenaVector<QuadNode> nodes{};
+        std::uint32_t nodeIndex = 1;
 
-        QuadTree() noexcept = default;
+        static constexpr auto MaxColliderInNode = 4;
+        static constexpr auto MaxDepth = 6;
 
         /**
          * @brief Initializes the QuadTree by preallocating memory for nodes and collider pairs.
@@ -106,49 +110,154 @@ namespace Physics
          * 1. Calculates the maximum possible number of children nodes based on the maximum depth.
          * 2. Resizes the nodes vector to allocate memory for the calculated maximum number of nodes.
          * 3. Iterates over each node and reserves space for colliders within the node.
-         * 4. Reserves space for collider pairs based on the calculated maximum number of children nodes and a Ratio.
          *
          * This initialization ensures that the QuadTree has sufficient memory to accommodate its structure
          * and allows for efficient insertion and retrieval of colliders during collision detection.
          */
-        void Init() noexcept;
+        void Init(SimulationArena& arena);
 
         /**
          * @brief Subdivides the current Node into four quadNodes.
          */
-        void Subdivide(QuadNode& node);
+        void Subdivide(SimulationArena& arena, std::uint32_t node) noexcept;
 
         /**
          * @brief Inserts a simplified collider into the root QuadNode of the QuadTree.
          * \n Note : RootNode dimension are set with the position of the collider inserted.
          * @param simplifedCollider The simplified collider to be inserted.
          */
-        void InsertInRootNode(const SimplifedCollider& simplifedCollider) noexcept;
+        void InsertInRootNode(SimulationArena& arena, const SimplifedCollider& simplifedCollider);
 
         /**
          * @brief Recursively subdivides a QuadNode if it contains more colliders than the maximum allowed or if the depth limit is not reached.
-         * @param node The QuadNode to be subdivided.
+         * \n Note : The colliders staying in the node are compacted in place, no scratch memory is needed. The node is
+         * taken by index: growing the colliders of a child may move the arena.
+         * @param node The index of the QuadNode to be subdivided.
          * @param depth The current depth of the recursion.
          */
-        void SubdivideNodeRecursively(QuadNode& node, int depth) noexcept;
+        void SubdivideNodeRecursively(SimulationArena& arena, std::uint32_t node, int depth);
 
         /**
          * @brief Finds possible collider pairs within a QuadNode and its children.
          * @param node The QuadNode to search for possible pairs.
+         * @param pairs The vector the possible pairs are added to, usually backed by the frame allocator of the World.
          */
-        void FindPossiblePairs(QuadNode& node) noexcept;
+        void FindPossiblePairs(const SimulationArena& arena, const QuadNode& node,
+                               AllocatedVector<ColliderPair>& pairs) const;
 
         /**
          * @brief Finds possible collider pairs between a specific collider and the colliders within a QuadNode and its children.
          *
          * @param node The QuadNode to search for possible pairs.
          * @param colliderRef Reference to the collider to compare with.
+         * @param pairs The vector the possible pairs are added to.
          */
-        void FindInChildrenNodePossiblePairs(QuadNode& node, Physics::ColliderRef& colliderRef) noexcept;
+        void FindInChildrenNodePossiblePairs(const SimulationArena& arena, const QuadNode& node,
+                                             Physics::ColliderRef colliderRef,
+                                             AllocatedVector<ColliderPair>& pairs) const;
 
         /**
          * @brief Clears the QuadTree, resetting it to an empty state.
          */
-        void Clear() noexcept;
+        void Clear(SimulationArena& arena) noexcept;
+
+        /**
+         * @return The root node of the tree.
+         */
+        [[nodiscard]] const QuadNode& Root(const SimulationArena& arena) const noexcept
+        {
+            return arena.View(nodes)[0];
+        }
+
+        /**
+         * @brief Visits the colliders of a QuadNode and its children whose AABB overlaps the given AABB.
+         * \n Note : Only the children overlapping the AABB are visited, nothing is allocated.
+         * @param node The QuadNode to start the query from.
+         * @param aabb The AABB to query.
+         * @param visitor Called with each overlapping SimplifedCollider, returns false to stop the query.
+         * @return false if the visitor stopped the query, true otherwise.
+         */
+        template<typename Visitor>
+        bool QueryAABB(const SimulationArena& arena, const QuadNode& node, const Math::RectangleF& aabb,
+                       Visitor& visitor) const
+        {
+            for (const auto& collider: arena.View(node.colliders))
+            {
+                if (Math::Intersect(collider.aabb, aabb) && !visitor(collider))
+                {
+                    return false;
+                }
+            }
+
+            if (node.HasChildren())
+            {
+                const auto treeNodes = arena.View(nodes);
+                for (const auto child: node.children)
+                {
+                    if (Math::Intersect(treeNodes[child].bounds, aabb) &&
+                        !QueryAABB(arena, treeNodes[child], aabb, visitor))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Visits the colliders of a QuadNode and its children whose AABB is crossed by a segment.
+         * \n Note : Only the children crossed by the segment are visited, nothing is allocated.
+         * @param node The QuadNode to start the ray cast from.
+         * @param origin The start of the segment.
+         * @param delta The segment, from its start to its end.
+         * @param visitor Called with each crossed SimplifedCollider, returns false to stop the ray cast.
+         * @return false if the visitor stopped the ray cast, true otherwise.
+         */
+        template<typename Visitor>
+        bool RayCast(const SimulationArena& arena, const QuadNode& node, Math::Vec2F origin, Math::Vec2F delta,
+                     Visitor& visitor) const
+        {
+            for (const auto& collider: arena.View(node.colliders))
+            {
+                if (SegmentIntersect(collider.aabb, origin, delta) && !visitor(collider))
+                {
+                    return false;
+                }
+            }
+
+            if (node.HasChildren())
+            {
+                const auto treeNodes = arena.View(nodes);
+                for (const auto child: node.children)
+                {
+                    if (SegmentIntersect(treeNodes[child].bounds, origin, delta) &&
+                        !RayCast(arena, treeNodes[child], origin, delta, visitor))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Checks if a segment crosses or touches a rectangle (slab test).
+         * @param rectangle The rectangle to test.
+         * @param origin The start of the segment.
+         * @param delta The segment, from its start to its end.
+         * @return True if the segment crosses the rectangle, false otherwise.
+         */
+        [[nodiscard]] static bool SegmentIntersect(const Math::RectangleF& rectangle, Math::Vec2F origin,
+                                                   Math::Vec2F delta) noexcept;
+
+        /**
+         * @brief Checks if a segment is parallel to the slabs of an axis, from its delta on that axis.
+         * \n Note : Shared by the tree and the collider ray casts, so a node is never culled for a segment a collider
+         * of it would be hit by. Only an exact zero is parallel, a tiny delta still gives a finite inverse.
+         */
+        [[nodiscard]] static constexpr bool IsParallelToSlab(float delta) noexcept
+        {
+            return delta == 0.0f;
+        }
     };
 }
@@ -5,16 +5,115 @@
 #include "Collider.h"
 #include "ContactListener.h"
 #include "Contact.h"
+#include "SimulationArena.h"
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
 #include <TracyC.h>
 #endif
 
+#include <cstdint>
 #include <cstdlib>
 #include <vector>
 
 namespace Physics
 {
+    /**
+     * @struct RayCastHit
+     * @brief Represents a collider crossed by a ray cast.
+     *
+     * The struct has the following members:
+     * - `ColliderRef colliderRef`: The reference to the crossed collider.
+     * - `Math::Vec2F point`: The point where the ray enters the collider.
+     * - `Math::Vec2F normal`: The normal of the collider surface at the entry point.
+     * - `float fraction`: The fraction of the ray, from 0 at its start to 1 at its end, where the entry point is.
+     */
+    struct RayCastHit
+    {
+        ColliderRef colliderRef;
+        Math::Vec2F point;
+        Math::Vec2F normal;
+        float fraction;
+    };
+
+    /**
+     * @struct ContactSlot
+     * @brief Represents a slot of the open addressing table caching the manifolds of the collider pairs in contact.
+     *
+     * The struct has the following members:
+     * - `ColliderPair pair`: The collider pair in contact.
+     * - `ContactManifold manifold`: The manifold kept from the last step, used to warm start the pair.
+     * - `bool isUsed`: Whether the slot holds a pair.
+     */
+    struct ContactSlot
+    {
+        ColliderPair pair{};
+        ContactManifold manifold{};
+        bool isUsed = false;
+    };
+
+    /**
+     * @enum BodyList
+     * @brief Enumerates the lists of a World a body can be in.
+     * - NONE: In no list: a free slot, a destroyed body or a static body.
+     * - AWAKE: In the awake list, integrated each step.
+     * - SLEEPING: In the sleeping list, asleep or not valid yet, checked each step for a wake up.
+     */
+    enum class BodyList : std::uint8_t
+    {
+        NONE,
+        AWAKE,
+        SLEEPING
+    };
+
+    /**
+     * @struct BodyListEntry
+     * @brief Represents where a body is listed, so it is moved from one list to another in constant time.
+     *
+     * The struct has the following members:
+     * - `BodyList list`: The list holding the body.
+     * - `std::uint32_t position`: The position of the body in that list.
+     */
+    struct BodyListEntry
+    {
+        BodyList list = BodyList::NONE;
+        std::uint32_t position = 0;
+    };
+
+    /**
+     * @struct WorldState
+     * @brief Represents the handles of the arrays holding the state of a World in its simulation arena.
+     *
+     * The struct has the following members:
+     * - `ArenaVector<Body> bodies`: The bodies in the world.
+     * - `ArenaVector<std::uint8_t> genIndices`: The generation indices of the bodies.
+     * - `ArenaVector<Collider> colliders`: The colliders in the world.
+     * - `ArenaVector<std::uint8_t> collidersGenIndices`: The generation indices of the colliders.
+     * - `ArenaVector<std::uint32_t> awakeBodies`: Indices of the created bodies integrated each step.
+     * - `ArenaVector<std::uint32_t> sleepingBodies`: Indices of the created dynamic bodies that are asleep or not valid yet.
+     * - `ArenaVector<BodyListEntry> bodyListEntries`: The list of each body and its position in it, static bodies are in none.
+     * - `ArenaVector<std::uint16_t> idleFrames`: Number of steps each body has stayed under the sleep tolerances.
+     * - `ArenaVector<ContactSlot> contactSlots`: Open addressing table of the collider pairs in contact, a power of two in size.
+     * - `std::uint32_t contactCount`: Number of used slots in the table, at most half of them.
+     *
+     * \n Note : The handles are offsets, the struct is copied as is with the arena to save or restore a World.
+     */
+    struct WorldState
+    {
+        ArenaVector<Body> bodies{};
+        ArenaVector<std::uint8_t> genIndices{};
+
+        ArenaVector<Collider> colliders{};
+        ArenaVector<std::uint8_t> collidersGenIndices{};
+
+        ArenaVector<std::uint32_t> awakeBodies{};
+        ArenaVector<std::uint32_t> sleepingBodies{};
+        ArenaVector<BodyListEntry> bodyListEntries{};
+        ArenaVector<std::uint16_t> idleFrames{};
+
+        ArenaVector<ContactSlot> contactSlots{};
+        std::uint32_t contactCount = 0;
+    };
+
     /**
      * @class World
      * @brief Represents the simulation world containing bodies, colliders, and managing collision detection.
@@ -23,54 +122,172 @@ namespace Physics
      * including collision detection and resolution. It uses a QuadTree for spatial partitioning to optimize collision detection.
      *
      * The class has the following private members:
-     * - `std::vector<Body> _bodies`: Vector storing the bodies in the world.
-     * - `std::vector<std::size_t> _genIndices`: Vector storing the generation indices of bodies.
-     * - `std::vector<Collider> _colliders`: Vector storing the colliders in the world.
-     * - `std::vector<std::size_t> _collidersGenIndices`: Vector storing the generation indices of colliders.
-     * - `std::unordered_set<ColliderPair, ColliderPairHash> _colliderPairs`: Unordered set storing collider pairs.
+     * - `SimulationArena _arena`: Contiguous memory holding the whole simulation state: bodies, colliders, sleep lists, contact cache and QuadTree nodes.
+     * - `WorldState _state`: Handles of the arrays of the World in the arena.
+     * - `static constexpr std::size_t arenaSize`: Initial capacity of the arena, enough for the vectors made by Init.
+     * - `FrameAllocator _frameAllocator`: Scratch arena of the step, reset before each collision pass. Possible pairs and contact batches come from it.
+     * - `static constexpr std::size_t frameAllocatorSize`: Initial capacity of the frame allocator, grown to the high-water mark if a step needs more.
      * - `static constexpr std::size_t initSizeForVector = 500`: Constant defining the initial size for vectors.
      *
      * The class also has the following public members:
      * - `ContactListener* contactListener`: Pointer to a contact listener for handling collision events.
      * - `QuadTree tree`: QuadTree for spatial partitioning.
+     * - `int velocityIterations`: Number of sequential impulse iterations run over all the contacts each step.
+     * - `float sleepVelocityTolerance`: Speed under which a dynamic body counts as idle.
+     * - `float sleepForceTolerance`: Force over which a dynamic body never counts as idle.
+     * - `int framesToSleep`: Number of idle steps before a dynamic body goes to sleep.
      *
      * The class provides the following methods:
      * - `void Init() noexcept`: Initializes the World vector size bodies, colliders, and related data structures.
      * - `void Clear() noexcept`: Clear the World vector bodies, colliders, and related data structures.
      * - `void Update(float deltaTime) noexcept`: Updates the state of the World, including body physics and collision resolution.
-     * - `BodyRef CreateBody() noexcept`: Creates a new body in the World and returns its reference.
+     * - `void Integrate(float deltaTime) noexcept`: Integrates forces and velocities of every valid body.
+     * - `void ResolveCollisions() noexcept`: Runs the broad and narrow phases on the integrated bodies.
+     * - `BodyRef CreateBody()`: Creates a new body in the World and returns its reference.
      * - `void DestroyBody(BodyRef bodyRef) noexcept`: Destroys the specified body in the World.
      * - `Body& GetBody(BodyRef bodyRef)`: Retrieves the reference to a specific body in the World.
      * - `std::size_t CurrentBodyCount() const noexcept`: Returns the current number of bodies in the World.
-     * - `ColliderRef CreateCollider(BodyRef bodyRef) noexcept`: Creates a new collider associated with a given body and returns its reference.
+     * - `std::size_t AwakeBodyCount() const noexcept`: Returns the number of bodies integrated each step.
+     * - `ColliderRef CreateCollider(BodyRef bodyRef)`: Creates a new collider associated with a given body and returns its reference.
      * - `Collider& GetCollider(ColliderRef colliderRef)`: Retrieves the reference to a specific collider in the World.
      * - `void DestroyCollider(ColliderRef colliderRef) noexcept`: Destroys the specified collider in the World.
      * - `static bool IsContact(const Engine::Collider& colliderA, const Engine::Collider& colliderB) noexcept`: Checks if there is a contact/overlap between two colliders.
      * - `void ResolveBroadPhase() noexcept`: Resolves broad-phase collision detection using a QuadTree.
      * - `void ResolveNarrowPhase() noexcept`: Resolves narrow-phase collision detection and applies it if necessary using a QuadTree.
+     * - `void SolveContacts(AllocatedVector<Contact> &contacts, const AllocatedVector<ColliderPair> &contactPairs) noexcept`: Solves the contacts found by the narrow phase, warm started from their cached manifolds.
+     * - `void SaveSnapshot(std::vector<std::byte> &snapshot) const`: Copies the whole simulation state into a buffer.
+     * - `void LoadSnapshot(const std::vector<std::byte> &snapshot)`: Restores the simulation state saved by SaveSnapshot.
+     * - `void QueryAABB(const Math::RectangleF &aabb, Visitor &&visitor) const`: Visits the colliders overlapping an AABB.
+     * - `void QueryPoint(Math::Vec2F point, Visitor &&visitor) const`: Visits the colliders containing a point.
+     * - `void RayCast(Math::Vec2F origin, Math::Vec2F end, Visitor &&visitor) const`: Visits the colliders crossed by a segment.
+     *
+     * The spatial queries run against the QuadTree built by the last broad phase, so they see the colliders as they were
+     * at the end of the last Update and never allocate. The broad phase runs every Update, with or without a contact
+     * listener, while the narrow phase needs a listener to report the contacts to.
+     *
+     * The simulation state lives in one SimulationArena and is referred to by offsets, so copying a World, or saving it
+     * to a snapshot, copies the used prefix of the arena in a single memcpy.
      *
      * This class encapsulates the functionality of a physics simulation world with collision detection and resolution.
      */
     class World
     {
     private :
-        std::vector<Body> _bodies;
-        std::vector<std::size_t> _genIndices;
-
-        std::vector<Collider> _colliders;
-        std::vector<std::size_t> _collidersGenIndices;
+        static constexpr std::size_t arenaSize = 2 * 1024 * 1024;
+        SimulationArena _arena{arenaSize, "PhysicsArena"};
+        WorldState _state{};
 
-        HeapAllocator heapAlloc;
-        std::unordered_set<ColliderPair, ColliderPairHash, std::equal_to<ColliderPair>, StandardAllocator<ColliderPair>> _colliderPairs{
-                heapAlloc
-        };
+        static constexpr std::size_t frameAllocatorSize = 64 * 1024;
+        FrameAllocator _frameAllocator{frameAllocatorSize, "PhysicsFrame"};
 
         static constexpr std::size_t initSizeForVector = 500;
 
+        friend class WorldBatch;
+
+        /**
+         * @brief Checks if a body is integrated by the World: valid, dynamic and awake.
+         */
+        [[nodiscard]] static constexpr bool IsSimulated(const Body& body) noexcept
+        {
+            return body.IsValid() && body.type == BodyType::DYNAMIC && body.IsAwake();
+        }
+
+        /**
+         * @brief Checks if a body is valid and never integrated, so it is kept out of the awake and sleeping lists.
+         */
+        [[nodiscard]] static constexpr bool IsStatic(const Body& body) noexcept
+        {
+            return body.IsValid() && body.type != BodyType::DYNAMIC;
+        }
+
+        /**
+         * @brief Moves the bodies woken up since the last step to the awake list, and keeps the pushed ones awake.
+         * \n Note : Only reads the awake flag of the sleeping bodies.
+         */
+        void WakeBodies() noexcept;
+
+        /**
+         * @brief Puts to sleep the bodies idle for framesToSleep steps, and moves the static and unvalid bodies out of the awake list.
+         * \n Note : The static bodies leave both lists, so waking bodies up only walks the sleeping dynamic ones. A body
+         * turned dynamic again after its first step stays out of the lists, destroy it and create a new one instead.
+         */
+        void SleepBodies() noexcept;
+
+        /**
+         * @brief Moves a body to a list, or out of both lists with BodyList::NONE, in constant time.
+         * \n Note : The lists are reserved for every body slot, moving a body never grows the arena.
+         */
+        void ListBody(std::uint32_t index, BodyList list) noexcept;
+
+        /**
+         * @brief Queues a contact between the colliders of a pair, to be solved with its cached manifold.
+         */
+        void AddContact(const ColliderPair& pair, AllocatedVector<Contact>& contacts,
+                        AllocatedVector<ColliderPair>& contactPairs) noexcept;
+
+        /**
+         * @brief Grows the contact table so it holds count pairs at a load factor of at most one half.
+         * \n Note : Called before the narrow phase, which then inserts without allocating: its contacts point into the arena.
+         */
+        void ReserveContacts(std::size_t count);
+
+        /**
+         * @return The slot of a pair in the contact table, or the size of the table if the pair is not in contact.
+         */
+        [[nodiscard]] std::size_t FindContact(const ColliderPair& pair) const noexcept;
+
+        /**
+         * @brief Inserts a pair not in the table yet, the table must have been reserved for it.
+         * @return The manifold of the pair, empty.
+         */
+        ContactManifold& InsertContact(const ColliderPair& pair) noexcept;
+
+        /**
+         * @brief Removes the pair of a slot, shifting back the pairs probed after it so no tombstone is left.
+         */
+        void EraseContact(std::size_t slot) noexcept;
+
+        /**
+         * @brief Checks if a ColliderRef from the QuadTree still refers to a valid collider.
+         */
+        [[nodiscard]] bool IsQueryable(ColliderRef colliderRef) const noexcept;
+
+        /**
+         * @brief Computes the circle of a circle collider, centered on the position of its body.
+         */
+        [[nodiscard]] Math::CircleF ColliderCircle(const Collider& collider) const noexcept;
+
+        /**
+         * @brief Computes the axis-aligned bounding box (AABB) of a collider, as inserted in the QuadTree.
+         */
+        [[nodiscard]] Math::RectangleF ColliderAABB(const Collider& collider) const noexcept;
+
+        /**
+         * @brief Checks if the shape of a collider overlaps an AABB.
+         */
+        [[nodiscard]] bool OverlapAABB(ColliderRef colliderRef, const Math::RectangleF& aabb) const noexcept;
+
+        /**
+         * @brief Checks if the shape of a collider contains a point.
+         */
+        [[nodiscard]] bool ContainPoint(ColliderRef colliderRef, Math::Vec2F point) const noexcept;
+
+        /**
+         * @brief Intersects a segment with the shape of a collider.
+         * \n Note : A segment starting inside the shape does not hit it.
+         * @param hit Filled with the entry point of the segment if it hits the shape.
+         * @return True if the segment hits the shape, false otherwise.
+         */
+        [[nodiscard]] bool RayCastCollider(ColliderRef colliderRef, Math::Vec2F origin, Math::Vec2F delta,
+                                           RayCastHit& hit) const noexcept;
 
     public :
         ContactListener* contactListener = nullptr;
         QuadTree tree;
+        int velocityIterations = 4;
+        float sleepVelocityTolerance = 0.01f;
+        float sleepForceTolerance = 0.01f;
+        int framesToSleep = 25;
 
         World() noexcept = default;
 
@@ -91,6 +308,20 @@ namespace Physics
          */
         void Update(float deltaTime) noexcept;
 
+        /**
+         * @brief Integrates the forces and velocities of every awake dynamic body, then clears their forces.
+         * \n Note : First half of Update, exposed so a WorldBatch can run it for several worlds at once.
+         * @param deltaTime The time elapsed since the last update.
+         */
+        void Integrate(float deltaTime) noexcept;
+
+        /**
+         * @brief Detects and resolves the collisions of the integrated bodies, second half of Update.
+         * \n Note : Starts by resetting the frame allocator, the scratch memory of the previous step is given back.
+         * The QuadTree is always rebuilt for the queries, the collisions are only resolved with a contact listener.
+         */
+        void ResolveCollisions() noexcept;
+
         /**
         * @brief Return the first BodyRef in the vector bodies that is unvalid.
          * If there is no unvalid BodyRef resize the bodies by 2time his current size and return the first new one.
@@ -98,9 +329,10 @@ namespace Physics
         /**
          * @brief Creates a new body in the World and returns its reference.
          * \n Note : If there is no BodyRef to return it will resize the bodies vector by 2time his current size and return the first new Bodyref.
+         * The bodies never grow past BodyRef::MaxIndex + 1, a std::length_error is thrown when they are all used.
          * @return Reference to the newly created body.
          */
-        [[nodiscard]] BodyRef CreateBody() noexcept;
+        [[nodiscard]] BodyRef CreateBody();
 
         /**
          * @brief Destroys the specified body in the World.
@@ -111,6 +343,9 @@ namespace Physics
 
         /**
          * @brief Retrieves the reference to a specific body in the World.
+         * \n Note : A stale BodyRef throws only in debug builds, the generation check is compiled out with NDEBUG.
+         * The body lives in the simulation arena: the reference is invalidated by a call growing it (CreateBody,
+         * CreateCollider, Update), keep the BodyRef instead.
          *
          * @param bodyRef Reference(BodyRef) to the body to be retrieved.
          * @return The specified body.
@@ -122,15 +357,23 @@ namespace Physics
          */
         [[nodiscard]] std::size_t CurrentBodyCount() const noexcept;
 
+        /**
+         * @return The number of bodies in the awake list, integrated each step.
+         */
+        [[nodiscard]] std::size_t AwakeBodyCount() const noexcept;
+
         /**
          * @brief Creates a new collider associated with a given body and returns its reference.
+         * \n Note : The colliders never grow past ColliderRef::MaxIndex + 1, a std::length_error is thrown when they are all used.
          * @param bodyRef Reference(BodyRef) to the associated body.
          * @return Reference(ColliderRef) to the newly created collider.
          */
-        [[nodiscard]] ColliderRef CreateCollider(BodyRef bodyRef) noexcept;
+        [[nodiscard]] ColliderRef CreateCollider(BodyRef bodyRef);
 
         /**
          * @brief Retrieves the reference to a specific collider in the World.
+         * \n Note : A stale ColliderRef throws only in debug builds, the generation check is compiled out with NDEBUG.
+         * Like a body, the collider lives in the simulation arena and its reference is invalidated when the arena grows.
          *
          * @param colliderRef Reference(ColliderRef) to the collider to be retrieved.
          * @return The specified collider.
@@ -163,6 +406,102 @@ namespace Physics
          */
         void ResolveNarrowPhase() noexcept;
 
+        /**
+         * @brief Solves the contacts found by the narrow phase and stores their manifolds for the next step.
+         * \n Note : Each contact is warm started from its cached impulse, then the velocities of all the contacts are
+         * iterated velocityIterations times before the interpenetrations are resolved.
+         */
+        void SolveContacts(AllocatedVector<Contact>& contacts,
+                           const AllocatedVector<ColliderPair>& contactPairs) noexcept;
+
         const std::size_t GetInitSizeForVector() noexcept;
+
+        /**
+         * @brief Copies the whole simulation state into a buffer: the arena handles, then the used prefix of the arena.
+         * \n Note : The settings, like velocityIterations or contactListener, are not part of the snapshot.
+         * @param snapshot The buffer, resized to fit the snapshot and reused from one call to the next.
+         */
+        void SaveSnapshot(std::vector<std::byte>& snapshot) const;
+
+        /**
+         * @brief Restores the simulation state saved by SaveSnapshot, in this World or in another one.
+         * \n Note : The references to bodies and colliders are invalidated, the BodyRef and ColliderRef stay valid.
+         * @param snapshot The buffer filled by SaveSnapshot.
+         */
+        void LoadSnapshot(const std::vector<std::byte>& snapshot);
+
+        /**
+         * @brief Visits every collider whose shape overlaps an AABB.
+         *
+         * @param aabb The AABB to query.
+         * @param visitor Called with the ColliderRef of each overlapping collider, returns false to stop the query.
+         */
+        template<typename Visitor>
+        void QueryAABB(const Math::RectangleF& aabb, Visitor&& visitor) const
+        {
+#ifdef TRACY_ENABLE
+            //ZoneScoped;
+#endif
+            auto treeVisitor = [this, &aabb, &visitor](const SimplifedCollider& simplifedCollider)
+            {
+                if (!OverlapAABB(simplifedCollider.colliderRef, aabb))
+                {
+                    return true;
+                }
+                return static_cast<bool>(visitor(simplifedCollider.colliderRef));
+            };
+            tree.QueryAABB(_arena, tree.Root(_arena), aabb, treeVisitor);
+        }
+
+        /**
+         * @brief Visits every collider whose shape contains a point.
+         *
+         * @param point The point to query.
+         * @param visitor Called with the ColliderRef of each collider containing the point, returns false to stop the query.
+         */
+        template<typename Visitor>
+        void QueryPoint(Math::Vec2F point, Visitor&& visitor) const
+        {
+#ifdef TRACY_ENABLE
+            //ZoneScoped;
+#endif
+            const Math::RectangleF pointAABB(point, point);
+            auto treeVisitor = [this, point, &visitor](const SimplifedCollider& simplifedCollider)
+            {
+                if (!ContainPoint(simplifedCollider.colliderRef, point))
+                {
+                    return true;
+                }
+                return static_cast<bool>(visitor(simplifedCollider.colliderRef));
+            };
+            tree.QueryAABB(_arena, tree.Root(_arena), pointAABB, treeVisitor);
+        }
+
+        /**
+         * @brief Visits every collider crossed by a segment.
+         * \n Note : The hits are visited in QuadTree order, not sorted by fraction. Keep the smallest fraction
+         * to get the closest hit. A segment starting inside a collider does not hit it.
+         * @param origin The start of the segment.
+         * @param end The end of the segment.
+         * @param visitor Called with the RayCastHit of each crossed collider, returns false to stop the ray cast.
+         */
+        template<typename Visitor>
+        void RayCast(Math::Vec2F origin, Math::Vec2F end, Visitor&& visitor) const
+        {
+#ifdef TRACY_ENABLE
+            //ZoneScoped;
+#endif
+            const auto delta = end - origin;
+            auto treeVisitor = [this, origin, delta, &visitor](const SimplifedCollider& simplifedCollider)
+            {
+                RayCastHit hit{};
+                if (!RayCastCollider(simplifedCollider.colliderRef, origin, delta, hit))
+                {
+                    return true;
+                }
+                return static_cast<bool>(visitor(static_cast<const RayCastHit&>(hit)));
+            };
+            tree.RayCast(_arena, tree.Root(_arena), origin, delta, treeVisitor);
+        }
     };
 }
\ No newline at end of file
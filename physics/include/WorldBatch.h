@@ -0,0 +1,102 @@
+#pragma once
+
+#include "World.h"
+#include "NVec2.h"
+#include "Allocator.h"
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#include <TracyC.h>
+#endif
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace Physics
+{
+    /**
+     * @class WorldBatch
+     * @brief Steps several independent Worlds in lockstep, integrating them with one SIMD lane per World.
+     *
+     * The WorldBatch class groups `LaneCount` Worlds (match hosting, speculative input branches, AI lookahead)
+     * and lays the n-th awake body of every World side by side in FourVec2F blocks, so the integration of a block
+     * is done for all the Worlds with a single SIMD operation. Collision detection and resolution then run for each
+     * World in turn, so each World still sends its own events to its own contact listener.
+     *
+     * The class has the following public members:
+     * - `static constexpr std::size_t LaneCount`: Number of Worlds stepped together, one per SIMD lane.
+     * - `std::array<World, LaneCount> worlds`: The Worlds of the batch.
+     *
+     * The class has the following private members:
+     * - `HeapAllocator _heapAllocator`: An allocator for the lane blocks.
+     * - `static constexpr std::uint32_t EmptyLane`: Body index of a lane holding no body in a block.
+     * - `AllocatedVector<Math::FourVec2F> _positions`: Positions of the bodies of a block, one per lane.
+     * - `AllocatedVector<Math::FourVec2F> _velocities`: Velocities of the bodies of a block, one per lane.
+     * - `AllocatedVector<Math::FourVec2F> _forces`: Forces of the bodies of a block, one per lane.
+     * - `AllocatedVector<Math::FourVec2F> _masses`: Masses of the bodies of a block, 1 for an empty lane.
+     * - `AllocatedVector<std::array<std::uint32_t, LaneCount>> _laneBodies`: Index of the body of each lane of a block, or EmptyLane.
+     *
+     * The class provides the following methods:
+     * - `void Init() noexcept`: Initializes every World of the batch.
+     * - `void Clear() noexcept`: Clears every World of the batch.
+     * - `void Update(float deltaTime) noexcept`: Steps every World of the batch.
+     * - `World& operator[](std::size_t lane) noexcept`: Access to the World of a lane.
+     *
+     * Only the awake lists are gathered, so the cost of a step follows the number of awake bodies, not the capacity
+     * of the Worlds. Stepping a WorldBatch gives the same bodies state as calling Update on each World.
+     */
+    class WorldBatch
+    {
+    public:
+        static constexpr std::size_t LaneCount = 4;
+        std::array<World, LaneCount> worlds;
+
+        WorldBatch() noexcept = default;
+
+        /**
+         * @brief Initializes every World of the batch and preallocates the lane blocks for their bodies.
+         */
+        void Init() noexcept;
+
+        /**
+         * @brief Clears every World of the batch.
+         */
+        void Clear() noexcept;
+
+        /**
+         * @brief Steps every World of the batch: SIMD integration of all lanes, then collisions World by World.
+         *
+         * @param deltaTime The time elapsed since the last update.
+         */
+        void Update(float deltaTime) noexcept;
+
+        [[nodiscard]] World& operator[](std::size_t lane) noexcept
+        { return worlds[lane]; }
+
+    private:
+        HeapAllocator _heapAllocator{"WorldBatch"};
+        AllocatedVector<Math::FourVec2F> _positions{StandardAllocator<Math::FourVec2F>{_heapAllocator}};
+        AllocatedVector<Math::FourVec2F> _velocities{StandardAllocator<Math::FourVec2F>{_heapAllocator}};
+        AllocatedVector<Math::FourVec2F> _forces{StandardAllocator<Math::FourVec2F>{_heapAllocator}};
+        AllocatedVector<Math::FourVec2F> _masses{StandardAllocator<Math::FourVec2F>{_heapAllocator}};
+        static constexpr std::uint32_t EmptyLane = std::numeric_limits<std::uint32_t>::max();
+        AllocatedVector<std::array<std::uint32_t, LaneCount>> _laneBodies{
+                StandardAllocator<std::array<std::uint32_t, LaneCount>>{_heapAllocator}};
+
+        /**
+         * @brief Gathers the awake dynamic bodies of every World into the lane blocks, the n-th of each World in the n-th block.
+         * @return The number of blocks gathered.
+         */
+        std::size_t GatherLanes() noexcept;
+
+        /**
+         * @brief Integrates every lane block at once.
+         */
+        void IntegrateLanes(std::size_t blockCount, float deltaTime) noexcept;
+
+        /**
+         * @brief Writes the integrated lane blocks back into the bodies of every World.
+         */
+        void ScatterLanes(std::size_t blockCount) noexcept;
+    };
+}
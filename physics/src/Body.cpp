@@ -5,7 +5,7 @@ void Physics::Body::SetMass(float mass) noexcept
     _mass = mass;
 }
 
-[[nodiscard]] Math::Vec2F Physics::Body::Velocity() noexcept
+[[nodiscard]] Math::Vec2F Physics::Body::Velocity() const noexcept
 {
     return _velocity;
 }
@@ -13,9 +13,13 @@ void Physics::Body::SetMass(float mass) noexcept
 void Physics::Body::SetVelocity(Math::Vec2F velocity) noexcept
 {
     _velocity = velocity;
+    if (velocity.X != 0 || velocity.Y != 0)
+    {
+        _isAwake = true;
+    }
 }
 
-[[nodiscard]] Math::Vec2F Physics::Body::Position() noexcept
+[[nodiscard]] Math::Vec2F Physics::Body::Position() const noexcept
 {
     return _position;
 }
@@ -25,7 +29,7 @@ void Physics::Body::SetPosition(Math::Vec2F position) noexcept
     _position = position;
 }
 
-[[nodiscard]] Math::Vec2F Physics::Body::Force() noexcept
+[[nodiscard]] Math::Vec2F Physics::Body::Force() const noexcept
 {
     return _totalForce;
 }
@@ -38,4 +42,13 @@ void Physics::Body::SetForce(Math::Vec2F force) noexcept
 void Physics::Body::AddForce(Math::Vec2F force) noexcept
 {
     _totalForce += force;
-};
\ No newline at end of file
+    if (force.X != 0 || force.Y != 0)
+    {
+        _isAwake = true;
+    }
+}
+
+void Physics::Body::SetAwake(bool isAwake) noexcept
+{
+    _isAwake = isAwake;
+}
\ No newline at end of file
@@ -1,50 +1,66 @@
 #include "Contact.h"
 
+#include <algorithm>
+
 float Physics::Contact::CalculateSeparateVelocity() const noexcept
 {
     const auto relativeVelocity = collidingBodies[0] . body -> Velocity() - collidingBodies[1] . body -> Velocity();
     return relativeVelocity . Dot(contactNormal);
 }
 
-void Physics::Contact::ResolveVelocity() const noexcept
+void Physics::Contact::PrepareVelocity() noexcept
 {
-    const auto separatingVelocity = CalculateSeparateVelocity();
-    if (separatingVelocity > 0)
-    {
-        return;
-    }
-    //Restitution Implementation
-    const auto newSeparateVelocity = -separatingVelocity * restitution;
-    const auto deltaVelocity = newSeparateVelocity - separatingVelocity;
-
-    const auto inverseMassBody1 = 1 / collidingBodies[0] . body -> Mass();
-    const auto inverseMassBody2 = 1 / collidingBodies[1] . body -> Mass();
-    const auto totalInverseMass = inverseMassBody1 + inverseMassBody2;
+    const auto mass1 = collidingBodies[0] . body -> Mass(), mass2 = collidingBodies[1] . body -> Mass();
+    const auto rest1 = collidingBodies[0] . collider -> restitution, rest2 = collidingBodies[1] . collider -> restitution;
 
-    const auto impulse = deltaVelocity / totalInverseMass;
-    const auto impulsePerIMass = contactNormal * impulse;
+    restitution = (mass1 * rest1 + mass2 * rest2) / (mass1 + mass2);
 
-    if (collidingBodies[0] . body -> type == BodyType::DYNAMIC)
-    {
-        collidingBodies[0] . body -> SetVelocity(
-                collidingBodies[0] . body -> Velocity() + impulsePerIMass * inverseMassBody1);
-    }
-    else if (collidingBodies[0] . body -> type == BodyType::STATIC)
+    for (std::size_t i = 0; i < collidingBodies . size(); i++)
     {
-        collidingBodies[1] . body -> SetVelocity(
-                collidingBodies[1] . body -> Velocity() - impulsePerIMass * inverseMassBody1);
+        const auto* body = collidingBodies[i] . body;
+        _inverseMasses[i] = body -> type == BodyType::DYNAMIC ? 1 / body -> Mass() : 0.0f;
     }
 
-    if (collidingBodies[1] . body -> type == BodyType::DYNAMIC)
+    //Restitution Implementation, only when the bodies are closing in
+    const auto separatingVelocity = CalculateSeparateVelocity();
+    _targetSeparateVelocity = separatingVelocity < 0 ? -separatingVelocity * restitution : 0.0f;
+    normalImpulse = 0.0f;
+}
+
+void Physics::Contact::WarmStart(const ContactManifold& previous) noexcept
+{
+    if (previous . normalImpulse <= 0 || previous . normal . Dot(contactNormal) < WarmStartNormalTolerance)
     {
-        collidingBodies[1] . body -> SetVelocity(
-                collidingBodies[1] . body -> Velocity() - impulsePerIMass * inverseMassBody2);
+        return;
     }
-    else if (collidingBodies[1] . body -> type == BodyType::STATIC)
+
+    normalImpulse = previous . normalImpulse;
+    ApplyImpulse(normalImpulse);
+}
+
+void Physics::Contact::ResolveVelocity() noexcept
+{
+    const auto totalInverseMass = _inverseMasses[0] + _inverseMasses[1];
+    if (totalInverseMass <= 0)
     {
-        collidingBodies[0] . body -> SetVelocity(
-                collidingBodies[0] . body -> Velocity() + impulsePerIMass * inverseMassBody2);
+        return;
     }
+
+    const auto deltaImpulse = (_targetSeparateVelocity - CalculateSeparateVelocity()) / totalInverseMass;
+
+    // The accumulated impulse can only push the bodies apart, but one iteration may take back what a previous one gave.
+    const auto newImpulse = std::max(normalImpulse + deltaImpulse, 0.0f);
+    ApplyImpulse(newImpulse - normalImpulse);
+    normalImpulse = newImpulse;
+}
+
+void Physics::Contact::ApplyImpulse(float impulse) const noexcept
+{
+    const auto impulsePerIMass = contactNormal * impulse;
+    collidingBodies[0] . body -> SetVelocity(
+            collidingBodies[0] . body -> Velocity() + impulsePerIMass * _inverseMasses[0]);
+    collidingBodies[1] . body -> SetVelocity(
+            collidingBodies[1] . body -> Velocity() - impulsePerIMass * _inverseMasses[1]);
 }
 
 void Physics::Contact::ResolveInterpenetration() const noexcept
@@ -76,7 +92,7 @@ void Physics::Contact::ResolveInterpenetration() const noexcept
     }
 }
 
-void Physics::Contact::Resolve()
+void Physics::Contact::ComputeManifold() noexcept
 {
     const auto delta = collidingBodies[0] . body -> Position() - collidingBodies[1] . body -> Position();
     switch (collidingBodies[0] . collider -> _shape)
@@ -86,9 +102,11 @@ void Physics::Contact::Resolve()
             {
                 case (Math::ShapeType::Circle):
                 {
-                    contactNormal = delta . Normalized();
+                    contactNormal = delta . Length() <= Math::Epsilon ? Math::Vec2F(0.f, 1.f) : delta . Normalized();
                     penetration = collidingBodies[0] . collider -> circleShape . Radius() +
                                   collidingBodies[1] . collider -> circleShape . Radius() - delta . Length();
+                    contactPosition = collidingBodies[1] . body -> Position() +
+                                      contactNormal * collidingBodies[1] . collider -> circleShape . Radius();
                 }
                     break;
                 case Math::ShapeType::Rectangle:
@@ -116,7 +134,9 @@ void Physics::Contact::Resolve()
 
                     contactNormal = circleToRectClosestPoint . Normalized();
                     penetration = collidingBodies[0] . collider -> circleShape . Radius() - distance;
+                    contactPosition = closestPointOnRect;
                 }
+                    break;
 
 
                 default:
@@ -129,7 +149,7 @@ void Physics::Contact::Resolve()
                 case (Math::ShapeType::Circle):
                 {
                     std::swap(collidingBodies[0], collidingBodies[1]);
-                    Resolve();
+                    ComputeManifold();
                 }
                     break;
                 case (Math::ShapeType::Rectangle):
@@ -152,6 +172,14 @@ void Physics::Contact::Resolve()
 
                         penetration = penetrationVec2F . Normalized() . Y;
                     }
+
+                    const auto& rectangle1 = collidingBodies[0] . collider -> rectangleShape;
+                    const auto& rectangle2 = collidingBodies[1] . collider -> rectangleShape;
+                    const Math::Vec2F overlapMin(std::max(rectangle1 . MinBound() . X, rectangle2 . MinBound() . X),
+                                                 std::max(rectangle1 . MinBound() . Y, rectangle2 . MinBound() . Y));
+                    const Math::Vec2F overlapMax(std::min(rectangle1 . MaxBound() . X, rectangle2 . MaxBound() . X),
+                                                 std::min(rectangle1 . MaxBound() . Y, rectangle2 . MaxBound() . Y));
+                    contactPosition = (overlapMin + overlapMax) / 2;
                 }
                     break;
                 default:
@@ -163,10 +191,17 @@ void Physics::Contact::Resolve()
             break;
     }
 
-    const auto mass1 = collidingBodies[0] . body -> Mass(), mass2 = collidingBodies[1] . body -> Mass();
-    const auto rest1 = collidingBodies[0] . collider -> restitution, rest2 = collidingBodies[1] . collider -> restitution;
+}
 
-    restitution = (mass1 * rest1 + mass2 * rest2) / (mass1 + mass2);
+void Physics::Contact::Resolve()
+{
+    ComputeManifold();
+    PrepareVelocity();
     ResolveVelocity();
     ResolveInterpenetration();
 }
+
+Physics::ContactManifold Physics::Contact::Manifold() const noexcept
+{
+    return ContactManifold{contactPosition, contactNormal, penetration, normalImpulse};
+}
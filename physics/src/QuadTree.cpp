@@ -1,14 +1,19 @@
 #include "QuadTree.h"
 
+#include <algorithm>
+#include <array>
+
 namespace Physics
 {
-    void QuadTree::Subdivide(QuadNode& node)
+    void QuadTree::Subdivide(SimulationArena& arena, std::uint32_t node) noexcept
     {
 #ifdef TRACY_ENABLE
         //ZoneScoped;
 #endif
-        const auto center = node.bounds.Center();
-        const auto halfSize = node.bounds.Size() / 2;
+        auto treeNodes = arena.View(nodes);
+        auto& parent = treeNodes[node];
+        const auto center = parent.bounds.Center();
+        const auto halfSize = parent.bounds.Size() / 2;
 
         const auto topRightCorner = center + halfSize;
         const auto bottomLeftCorner = center - halfSize;
@@ -19,25 +24,22 @@ namespace Physics
         const auto topMiddle = Math::Vec2F(center.X, center.Y + halfSize.Y);
         const auto bottomMiddle = Math::Vec2F(center.X, center.Y - halfSize.Y);
 
-        node.children[0] = &nodes[nodeIndex];
-        node.children[0]->bounds = Math::RectangleF(leftMiddle, topMiddle);
-        node.children[1] = &nodes[nodeIndex + 1];
-        node.children[1]->bounds = Math::RectangleF(center, topRightCorner);
-        node.children[2] = &nodes[nodeIndex + 2];
-        node.children[2]->bounds = Math::RectangleF(bottomLeftCorner, center);
-        node.children[3] = &nodes[nodeIndex + 3];
-        node.children[3]->bounds = Math::RectangleF(bottomMiddle, rightMiddle);
+        parent.children = {nodeIndex, nodeIndex + 1, nodeIndex + 2, nodeIndex + 3};
+        treeNodes[nodeIndex].bounds = Math::RectangleF(leftMiddle, topMiddle);
+        treeNodes[nodeIndex + 1].bounds = Math::RectangleF(center, topRightCorner);
+        treeNodes[nodeIndex + 2].bounds = Math::RectangleF(bottomLeftCorner, center);
+        treeNodes[nodeIndex + 3].bounds = Math::RectangleF(bottomMiddle, rightMiddle);
 
         nodeIndex += 4;
     };
 
-    void QuadTree::InsertInRootNode(const SimplifedCollider& simplifedCollider) noexcept
+    void QuadTree::InsertInRootNode(SimulationArena& arena, const SimplifedCollider& simplifedCollider)
     {
 #ifdef TRACY_ENABLE
         //ZoneScoped;
 #endif
 
-        auto& node = nodes[0];
+        auto& node = arena.View(nodes)[0];
 
         const Math::RectangleF& nodeBounds = node.bounds;
         const Math::RectangleF& colliderBounds = simplifedCollider.aabb;
@@ -58,26 +60,29 @@ namespace Physics
         {
             node.bounds.SetMaxBound(Math::Vec2F(nodeBounds.MaxBound().X, colliderBounds.MaxBound().Y));
         }
-        node.colliders.push_back(simplifedCollider);
+        arena.PushBack(node.colliders, simplifedCollider);
     }
 
-    void QuadTree::SubdivideNodeRecursively(QuadNode& node, int depth) noexcept
+    void QuadTree::SubdivideNodeRecursively(SimulationArena& arena, std::uint32_t node, int depth)
     {
 #ifdef TRACY_ENABLE
         //ZoneScoped;
 #endif
-        if (node.colliders.size() > MaxColliderInNode && depth != MaxDepth)
+        if (arena.View(nodes)[node].colliders.size > MaxColliderInNode && depth != MaxDepth)
         {
-            Subdivide(node);
-            std::vector<SimplifedCollider> collidersStayInNodes;
+            Subdivide(arena, node);
+            const auto children = arena.View(nodes)[node].children;
+            std::size_t stayCount = 0;
 
-            for (const auto& col: node.colliders)
+            // Pushing to a child may move the arena: the nodes and colliders are looked up again each time.
+            for (std::size_t i = 0; i < arena.View(nodes)[node].colliders.size; i++)
             {
+                const auto col = arena.View(arena.View(nodes)[node].colliders)[i];
                 int childNodePossible = 0;
-                QuadNode* childNode = nullptr;
-                for (const auto& child: node.children)
+                std::uint32_t childNode = QuadNode::NoChild;
+                for (const auto child: children)
                 {
-                    if (Math::Intersect(child->bounds, col.aabb))
+                    if (Math::Intersect(arena.View(nodes)[child].bounds, col.aabb))
                     {
                         childNode = child;
                         childNodePossible++;
@@ -86,111 +91,155 @@ namespace Physics
 
                 if (childNodePossible == 1)
                 {
-                    childNode->colliders.push_back(col);
+                    arena.PushBack(arena.View(nodes)[childNode].colliders, col);
                 }
                 else
                 {
-                    collidersStayInNodes.push_back(col);
+                    // Never ahead of the read position, so the colliders staying keep their order in place.
+                    arena.View(arena.View(nodes)[node].colliders)[stayCount] = col;
+                    stayCount++;
                 }
             }
 
-            node.colliders.clear();
-            for (auto& colliders: collidersStayInNodes)
-            {
-                node.colliders.push_back(colliders);
-            }
+            arena.View(nodes)[node].colliders.size = static_cast<std::uint32_t>(stayCount);
 
-            for (const auto& child: node.children)
+            for (const auto child: children)
             {
-                if (child->colliders.size() > MaxColliderInNode)
+                if (arena.View(nodes)[child].colliders.size > MaxColliderInNode)
                 {
-                    SubdivideNodeRecursively(*child, depth + 1);
+                    SubdivideNodeRecursively(arena, child, depth + 1);
                 }
             }
         }
     }
 
-    void QuadTree::FindPossiblePairs(QuadNode& node) noexcept
+    void QuadTree::FindPossiblePairs(const SimulationArena& arena, const QuadNode& node,
+                                     AllocatedVector<ColliderPair>& pairs) const
     {
 #ifdef TRACY_ENABLE
         //ZoneScoped;
 #endif
-        for (std::size_t i = 0; i < node.colliders.size(); i++)
+        const auto treeNodes = arena.View(nodes);
+        const auto colliders = arena.View(node.colliders);
+        for (std::size_t i = 0; i < colliders.size(); i++)
         {
-            auto& colliderA = node.colliders[i];
+            auto& colliderA = colliders[i];
 
-            for (std::size_t j = i + 1; j < node.colliders.size(); j++)
+            for (std::size_t j = i + 1; j < colliders.size(); j++)
             {
-                auto& colliderB = node.colliders[j];
+                auto& colliderB = colliders[j];
 
-                nodeColliderPairs.push_back(
+                pairs.push_back(
                         Physics::ColliderPair{colliderA.colliderRef, colliderB.colliderRef}); // now i et j
             }
 
-            if (node.children[0] != nullptr)
+            if (node.HasChildren())
             {
-                for (const auto& child: node.children)
+                for (const auto child: node.children)
                 {
-                    FindInChildrenNodePossiblePairs(*child, colliderA.colliderRef);
+                    FindInChildrenNodePossiblePairs(arena, treeNodes[child], colliderA.colliderRef, pairs);
                 }
             }
         }
 
-        if (node.children[0] != nullptr)
+        if (node.HasChildren())
         {
-            for (const auto& child: node.children)
+            for (const auto child: node.children)
             {
-                FindPossiblePairs(*child);
+                FindPossiblePairs(arena, treeNodes[child], pairs);
             }
         }
     }
 
-    void QuadTree::FindInChildrenNodePossiblePairs(QuadNode& node, Physics::ColliderRef& colliderRef) noexcept
+    void QuadTree::FindInChildrenNodePossiblePairs(const SimulationArena& arena, const QuadNode& node,
+                                                   Physics::ColliderRef colliderRef,
+                                                   AllocatedVector<ColliderPair>& pairs) const
     {
 #ifdef TRACY_ENABLE
         //ZoneScoped;
 #endif
-        for (auto& nodeCollider: node.colliders)
+        for (auto& nodeCollider: arena.View(node.colliders))
         {
-            nodeColliderPairs.push_back(Physics::ColliderPair{colliderRef, nodeCollider.colliderRef});
+            pairs.push_back(Physics::ColliderPair{colliderRef, nodeCollider.colliderRef});
         }
 
-        if (node.children[0] != nullptr)
+        if (node.HasChildren())
         {
-            for (const auto& child: node.children)
+            const auto treeNodes = arena.View(nodes);
+            for (const auto child: node.children)
             {
-                FindInChildrenNodePossiblePairs(*child, colliderRef);
+                FindInChildrenNodePossiblePairs(arena, treeNodes[child], colliderRef, pairs);
             }
         }
     }
 
-    void QuadTree::Clear() noexcept
+    void QuadTree::Clear(SimulationArena& arena) noexcept
     {
-        nodeColliderPairs.clear();
-        for (auto& node: nodes)
+        auto treeNodes = arena.View(nodes);
+        for (auto& node: treeNodes)
         {
-            std::fill(node.children.begin(), node.children.end(), nullptr);
-            node.colliders.clear();
+            std::fill(node.children.begin(), node.children.end(), QuadNode::NoChild);
+            arena.Clear(node.colliders);
         }
         nodeIndex = 1;
 
-        nodes[0].bounds.SetMinBound(Math::Vec2F(Metrics::WIDTH, Metrics::HEIGHT));
-        nodes[0].bounds.SetMaxBound(Math::Vec2F(0.0f, 0.0f));
+        treeNodes[0].bounds.SetMinBound(Math::Vec2F(Metrics::WIDTH, Metrics::HEIGHT));
+        treeNodes[0].bounds.SetMaxBound(Math::Vec2F(0.0f, 0.0f));
+    }
+
+    bool QuadTree::SegmentIntersect(const Math::RectangleF& rectangle, Math::Vec2F origin,
+                                    Math::Vec2F delta) noexcept
+    {
+        float enter = 0.0f;
+        float exit = 1.0f;
+
+        const std::array<float, 2> origins{origin.X, origin.Y};
+        const std::array<float, 2> deltas{delta.X, delta.Y};
+        const std::array<float, 2> minBounds{rectangle.MinBound().X, rectangle.MinBound().Y};
+        const std::array<float, 2> maxBounds{rectangle.MaxBound().X, rectangle.MaxBound().Y};
+
+        for (std::size_t axis = 0; axis < 2; axis++)
+        {
+            if (IsParallelToSlab(deltas[axis]))
+            {
+                // Parallel to the slab: the segment must already be between its two planes.
+                if (origins[axis] < minBounds[axis] || origins[axis] > maxBounds[axis])
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            const float inverseDelta = 1.0f / deltas[axis];
+            float near = (minBounds[axis] - origins[axis]) * inverseDelta;
+            float far = (maxBounds[axis] - origins[axis]) * inverseDelta;
+            if (near > far)
+            {
+                std::swap(near, far);
+            }
+
+            enter = std::max(enter, near);
+            exit = std::min(exit, far);
+            if (enter > exit)
+            {
+                return false;
+            }
+        }
+        return true;
     }
 
-    void QuadTree::Init() noexcept
+    void QuadTree::Init(SimulationArena& arena)
     {
         std::size_t maxChildrenPossible = 0;
         for (int i = 0; i <= MaxDepth; i++)
         {
             maxChildrenPossible += Math::Pow(4, i);
         }
-        nodes.resize(maxChildrenPossible, QuadNode({heapAllocator}));
+        arena.Resize(nodes, maxChildrenPossible, QuadNode());
 
-        for (auto& node: nodes)
+        for (std::size_t i = 0; i < maxChildrenPossible; i++)
         {
-            node.colliders.reserve(MaxColliderInNode);
+            arena.Reserve(arena.View(nodes)[i].colliders, MaxColliderInNode);
         }
-        nodeColliderPairs.reserve(maxChildrenPossible * 4);
     }
-}
\ No newline at end of file
+}
@@ -1,19 +1,34 @@
 #include "World.h"
 #include "../../common/include/Metrics.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
 namespace Physics
 {
+    static_assert(std::is_trivially_copyable_v<WorldState> && std::is_trivially_copyable_v<QuadTree>,
+                  "The arena handles of a World are saved with a memcpy");
+
     void World::Init() noexcept
     {
 #ifdef TRACY_ENABLE
         //ZoneScoped;
 #endif
         Clear();
-        _bodies.resize(initSizeForVector);
-        _genIndices.resize(initSizeForVector, 0);
-        _colliders.resize(initSizeForVector);
-        _collidersGenIndices.resize(initSizeForVector, 0);
-        tree.Init();
+        _arena.Resize(_state.bodies, initSizeForVector, Body());
+        _arena.Resize(_state.genIndices, initSizeForVector, std::uint8_t(0));
+        _arena.Resize(_state.colliders, initSizeForVector, Collider());
+        _arena.Resize(_state.collidersGenIndices, initSizeForVector, std::uint8_t(0));
+        _arena.Resize(_state.idleFrames, initSizeForVector, std::uint16_t(0));
+        _arena.Resize(_state.bodyListEntries, initSizeForVector, BodyListEntry());
+        // A body is in one list at most, the lists never grow while they are walked.
+        _arena.Reserve(_state.awakeBodies, initSizeForVector);
+        _arena.Reserve(_state.sleepingBodies, initSizeForVector);
+        tree.Init(_arena);
     }
 
     void World::Clear() noexcept
@@ -21,11 +36,10 @@ namespace Physics
 #ifdef TRACY_ENABLE
         //ZoneScoped;
 #endif
-        _bodies.clear();
-        _genIndices.clear();
-        _colliders.clear();
-        _collidersGenIndices.clear();
-        _colliderPairs.clear();
+        _arena.Reset();
+        _state = WorldState{};
+        tree = QuadTree{};
+        _frameAllocator.Reset();
     }
 
     void World::Update(float deltaTime) noexcept
@@ -33,9 +47,23 @@ namespace Physics
 #ifdef TRACY_ENABLE
         //ZoneScoped;
 #endif
-        for (auto& body: _bodies)
+        Integrate(deltaTime);
+        ResolveCollisions();
+        SleepBodies();
+    }
+
+    void World::Integrate(float deltaTime) noexcept
+    {
+#ifdef TRACY_ENABLE
+        //ZoneScoped;
+#endif
+        WakeBodies();
+
+        const auto bodies = _arena.View(_state.bodies);
+        for (const auto index: _arena.View(_state.awakeBodies))
         {
-            if (body.IsValid())
+            auto& body = bodies[index];
+            if (IsSimulated(body))
             {
                 Math::Vec2F acceleration = body.Force() / body.Mass();
                 body.SetVelocity(body.Velocity() + acceleration * deltaTime);
@@ -43,66 +71,217 @@ namespace Physics
                 body.SetForce(Math::Vec2F(0., 0.));
             }
         }
+    }
 
-        if (contactListener != nullptr)
+    void World::WakeBodies() noexcept
+    {
+#ifdef TRACY_ENABLE
+        //ZoneScoped;
+#endif
+        const auto bodies = _arena.View(_state.bodies);
+        const auto idleFrames = _arena.View(_state.idleFrames);
+        // Moving a body out of the list puts the last one at its position, which is checked again.
+        for (std::size_t i = 0; i < _state.sleepingBodies.size;)
+        {
+            const auto index = _arena.View(_state.sleepingBodies)[i];
+            if (IsStatic(bodies[index]))
+            {
+                // Made static while it was not valid yet.
+                ListBody(index, BodyList::NONE);
+                continue;
+            }
+            if (!IsSimulated(bodies[index]))
+            {
+                i++;
+                continue;
+            }
+
+            idleFrames[index] = 0;
+            ListBody(index, BodyList::AWAKE);
+        }
+
+        const auto forceTolerance = sleepForceTolerance * sleepForceTolerance;
+        for (const auto index: _arena.View(_state.awakeBodies))
+        {
+            if (bodies[index].Force().SquareLength() > forceTolerance)
+            {
+                idleFrames[index] = 0;
+            }
+        }
+    }
+
+    void World::SleepBodies() noexcept
+    {
+#ifdef TRACY_ENABLE
+        //ZoneScoped;
+#endif
+        const auto velocityTolerance = sleepVelocityTolerance * sleepVelocityTolerance;
+        const auto bodies = _arena.View(_state.bodies);
+        const auto idleFrames = _arena.View(_state.idleFrames);
+        for (std::size_t i = 0; i < _state.awakeBodies.size;)
+        {
+            const auto index = _arena.View(_state.awakeBodies)[i];
+            auto& body = bodies[index];
+            if (!IsSimulated(body))
+            {
+                // A static body never wakes up, it is listed nowhere.
+                ListBody(index, IsStatic(body) ? BodyList::NONE : BodyList::SLEEPING);
+                continue;
+            }
+
+            if (body.Velocity().SquareLength() > velocityTolerance)
+            {
+                idleFrames[index] = 0;
+                i++;
+                continue;
+            }
+
+            idleFrames[index]++;
+            if (idleFrames[index] < framesToSleep)
+            {
+                i++;
+                continue;
+            }
+
+            body.SetAwake(false);
+            body.SetVelocity(Math::Vec2F(0., 0.));
+            ListBody(index, BodyList::SLEEPING);
+        }
+    }
+
+    void World::ListBody(std::uint32_t index, BodyList list) noexcept
+    {
+        auto listOf = [this](BodyList bodyList) -> ArenaVector<std::uint32_t>&
+        {
+            return bodyList == BodyList::AWAKE ? _state.awakeBodies : _state.sleepingBodies;
+        };
+
+        const auto entries = _arena.View(_state.bodyListEntries);
+        auto& entry = entries[index];
+        if (entry.list == list)
         {
-            ResolveBroadPhase();
+            return;
         }
 
-        ResolveNarrowPhase();
+        if (entry.list != BodyList::NONE)
+        {
+            auto& bodiesList = listOf(entry.list);
+            const auto listedBodies = _arena.View(bodiesList);
+            const auto lastIndex = listedBodies.back();
+            listedBodies[entry.position] = lastIndex;
+            entries[lastIndex].position = entry.position;
+            _arena.PopBack(bodiesList);
+        }
+
+        entry.list = list;
+        if (list != BodyList::NONE)
+        {
+            auto& bodiesList = listOf(list);
+            entry.position = static_cast<std::uint32_t>(bodiesList.size);
+            _arena.PushBack(bodiesList, index);
+        }
+    }
+
+    void World::ResolveCollisions() noexcept
+    {
+#ifdef TRACY_ENABLE
+        //ZoneScoped;
+#endif
+#ifdef TRACY_ENABLE
+        TracyPlot("Physics frame arena", static_cast<int64_t>(_frameAllocator.UsedSize()));
+        TracyPlot("Physics simulation arena", static_cast<int64_t>(_arena.UsedSize()));
+#endif
+        _frameAllocator.Reset();
+
+        // The tree is rebuilt even without a listener, the spatial queries read it.
+        ResolveBroadPhase();
+
+        if (contactListener != nullptr)
+        {
+            ResolveNarrowPhase();
+        }
     }
 
-    BodyRef World::CreateBody() noexcept
+    BodyRef World::CreateBody()
     {
-        auto it = std::find_if(_bodies.begin(), _bodies.end(), [](Body& body)
+        const auto bodies = _arena.View(_state.bodies);
+        auto it = std::find_if(bodies.begin(), bodies.end(), [](Body& body)
         {
             return !body.IsValid();
         });
 
-        if (it != _bodies.end())
+        if (it != bodies.end())
         {
-            std::size_t index = std::distance(_bodies.begin(), it);
-            return BodyRef{index, _genIndices[index]};
+            std::size_t index = std::distance(bodies.begin(), it);
+            // The slot may already be listed if it was created but not made valid yet.
+            if (_arena.View(_state.bodyListEntries)[index].list == BodyList::NONE)
+            {
+                ListBody(static_cast<std::uint32_t>(index), BodyList::AWAKE);
+            }
+            _arena.View(_state.idleFrames)[index] = 0;
+            return BodyRef{static_cast<std::uint32_t>(index), _arena.View(_state.genIndices)[index]};
         }
 
-        auto indexFirstNewBody = _bodies.size();
-        auto newBodiesSize = _bodies.size() * 2;
-        _bodies.resize(newBodiesSize, Body());
-        _genIndices.resize(newBodiesSize, 0);
-        return BodyRef{indexFirstNewBody, _genIndices[indexFirstNewBody]};
+        // Past MaxIndex a BodyRef would wrap to the first bodies, the growth stops there.
+        if (_state.bodies.size > BodyRef::MaxIndex)
+        {
+            throw std::length_error("World out of body indices");
+        }
+        auto indexFirstNewBody = _state.bodies.size;
+        auto newBodiesSize = std::min<std::size_t>(_state.bodies.size * 2, BodyRef::MaxIndex + 1);
+        _arena.Resize(_state.bodies, newBodiesSize, Body());
+        _arena.Resize(_state.genIndices, newBodiesSize, std::uint8_t(0));
+        _arena.Resize(_state.idleFrames, newBodiesSize, std::uint16_t(0));
+        _arena.Resize(_state.bodyListEntries, newBodiesSize, BodyListEntry());
+        _arena.Reserve(_state.awakeBodies, newBodiesSize);
+        _arena.Reserve(_state.sleepingBodies, newBodiesSize);
+        ListBody(static_cast<std::uint32_t>(indexFirstNewBody), BodyList::AWAKE);
+        return BodyRef{static_cast<std::uint32_t>(indexFirstNewBody),
+                       _arena.View(_state.genIndices)[indexFirstNewBody]};
     }
 
     void World::DestroyBody(BodyRef bodyRef) noexcept
     {
-        _bodies[bodyRef.index] = Body();
-        _genIndices[bodyRef.index]++;
+        _arena.View(_state.bodies)[bodyRef.index] = Body();
+        _arena.View(_state.genIndices)[bodyRef.index]++;
+
+        ListBody(bodyRef.index, BodyList::NONE);
     }
 
     Body& World::GetBody(BodyRef bodyRef)
     {
-        if (_genIndices[bodyRef.index] != bodyRef.genIdx)
+#ifndef NDEBUG
+        if (_arena.View(_state.genIndices)[bodyRef.index] != bodyRef.genIdx)
         {
             throw std::runtime_error("null");
         }
-        return _bodies[bodyRef.index];
+#endif
+        return _arena.View(_state.bodies)[bodyRef.index];
     }
 
     [[nodiscard]] std::size_t World::CurrentBodyCount() const noexcept
     {
-        return _bodies.size();
+        return _state.bodies.size;
     }
 
-    [[nodiscard]] ColliderRef World::CreateCollider(const BodyRef bodyRef) noexcept
+    [[nodiscard]] std::size_t World::AwakeBodyCount() const noexcept
     {
-        auto it = std::find_if(_colliders.begin(), _colliders.end(), [](Collider& collider)
+        return _state.awakeBodies.size;
+    }
+
+    [[nodiscard]] ColliderRef World::CreateCollider(const BodyRef bodyRef)
+    {
+        const auto colliders = _arena.View(_state.colliders);
+        auto it = std::find_if(colliders.begin(), colliders.end(), [](Collider& collider)
         {
             return !collider.IsValid();
         });
 
-        if (it != _colliders.end())
+        if (it != colliders.end())
         {
-            std::size_t index = std::distance(_colliders.begin(), it);
-            const auto colliderRef = ColliderRef{index, _genIndices[index]};
+            std::size_t index = std::distance(colliders.begin(), it);
+            const auto colliderRef = ColliderRef{static_cast<std::uint32_t>(index),
+                                                 _arena.View(_state.collidersGenIndices)[index]};
             auto& collider = GetCollider(colliderRef);
             collider.bodyRef = bodyRef;
             return colliderRef;
@@ -111,12 +290,18 @@ namespace Physics
 
         else
         {
-            std::size_t index = _colliders.size();
-            auto newCollidersSize = _colliders.size() * 2;
-            _colliders.resize(newCollidersSize);
-            _collidersGenIndices.resize(newCollidersSize, 0);
+            // Past MaxIndex a ColliderRef would wrap to the first colliders, the growth stops there.
+            if (_state.colliders.size > ColliderRef::MaxIndex)
+            {
+                throw std::length_error("World out of collider indices");
+            }
+            std::size_t index = _state.colliders.size;
+            auto newCollidersSize = std::min<std::size_t>(_state.colliders.size * 2, ColliderRef::MaxIndex + 1);
+            _arena.Resize(_state.colliders, newCollidersSize, Collider());
+            _arena.Resize(_state.collidersGenIndices, newCollidersSize, std::uint8_t(0));
 
-            const auto colliderRef = ColliderRef{index, _genIndices[index]};
+            const auto colliderRef = ColliderRef{static_cast<std::uint32_t>(index),
+                                                 _arena.View(_state.collidersGenIndices)[index]};
             auto& collider = GetCollider(colliderRef);
             collider.bodyRef = bodyRef;
             return colliderRef;
@@ -127,17 +312,19 @@ namespace Physics
 
     [[nodiscard]] Collider& World::GetCollider(ColliderRef colliderRef)
     {
-        if (_collidersGenIndices[colliderRef.index] != colliderRef.genIdx)
+#ifndef NDEBUG
+        if (_arena.View(_state.collidersGenIndices)[colliderRef.index] != colliderRef.genIdx)
         {
             throw std::runtime_error("null");
         }
-        return _colliders[colliderRef.index];
+#endif
+        return _arena.View(_state.colliders)[colliderRef.index];
     }
 
     void World::DestroyCollider(Physics::ColliderRef colliderRef) noexcept
     {
-        _colliders[colliderRef.index] = Collider();
-        _collidersGenIndices[colliderRef.index]++;
+        _arena.View(_state.colliders)[colliderRef.index] = Collider();
+        _arena.View(_state.collidersGenIndices)[colliderRef.index]++;
     }
 
     bool World::IsContact(const Collider& colliderA, const Collider& colliderB) noexcept
@@ -175,29 +362,19 @@ namespace Physics
 #ifdef TRACY_ENABLE
         //ZoneScoped;
 #endif
-        tree.Clear();
-        for (std::size_t i = 0; i < _colliders.size(); i++)
+        tree.Clear(_arena);
+        for (std::size_t i = 0; i < _state.colliders.size; i++)
         {
-            if (_colliders[i].IsValid())
+            // Inserting may grow the arena, the collider is looked up again each time.
+            const auto& collider = _arena.View(_state.colliders)[i];
+            if (collider.IsValid())
             {
-                if (_colliders[i]._shape == Math::ShapeType::Rectangle)
-                {
-                    tree.InsertInRootNode(
-                            SimplifedCollider{ColliderRef{i, _collidersGenIndices[i]}, _colliders[i].rectangleShape});
-                }
-                else if (_colliders[i]._shape == Math::ShapeType::Circle)
-                {
-                    const auto circleBodyPosition = GetBody(_colliders[i].bodyRef).Position();
-                    const auto circleRadius = _colliders[i].circleShape.Radius();
-                    const auto circleToAABB = Math::RectangleF(
-                            circleBodyPosition - Math::Vec2F(circleRadius, circleRadius),
-                            circleBodyPosition + Math::Vec2F(circleRadius, circleRadius));
-                    tree.InsertInRootNode(
-                            SimplifedCollider{ColliderRef{i, _collidersGenIndices[i]}, circleToAABB});
-                }
+                const auto colliderRef = ColliderRef{static_cast<std::uint32_t>(i),
+                                                     _arena.View(_state.collidersGenIndices)[i]};
+                tree.InsertInRootNode(_arena, SimplifedCollider{colliderRef, ColliderAABB(collider)});
             }
         }
-        tree.SubdivideNodeRecursively(tree.nodes[0], 0);
+        tree.SubdivideNodeRecursively(_arena, 0, 0);
     }
 
     void World::ResolveNarrowPhase() noexcept
@@ -205,23 +382,31 @@ namespace Physics
 #ifdef TRACY_ENABLE
         //ZoneScoped;
 #endif
-        tree.FindPossiblePairs(tree.nodes[0]);
-        for (auto& pair: tree.nodeColliderPairs)
+        AllocatedVector<ColliderPair> possiblePairs{StandardAllocator<ColliderPair>{_frameAllocator}};
+        tree.FindPossiblePairs(_arena, tree.Root(_arena), possiblePairs);
+
+        // Every pair may enter the table: once it is reserved, nothing below allocates in the arena and the contacts
+        // can point to its bodies and colliders.
+        ReserveContacts(_state.contactCount + possiblePairs.size());
+
+        AllocatedVector<Contact> contacts{StandardAllocator<Contact>{_frameAllocator}};
+        AllocatedVector<ColliderPair> contactPairs{StandardAllocator<ColliderPair>{_frameAllocator}};
+        contacts.reserve(possiblePairs.size());
+        contactPairs.reserve(possiblePairs.size());
+
+        for (auto& pair: possiblePairs)
         {
             auto& colliderA = GetCollider(pair.colliderA);
             auto& colliderB = GetCollider(pair.colliderB);
 
-            const auto pairIterator = _colliderPairs.find(pair);
-            if (pairIterator != _colliderPairs.end())
+            const auto slot = FindContact(pair);
+            if (slot != _state.contactSlots.size)
             {
                 if (IsContact(colliderA, colliderB))
                 {
                     if (!colliderA.isTrigger && !colliderB.isTrigger)
                     {
-                        Contact contact;
-                        contact.collidingBodies[0] = CollidingBody{&GetBody(colliderA.bodyRef), &colliderA};
-                        contact.collidingBodies[1] = CollidingBody{&GetBody(colliderB.bodyRef), &colliderB};
-                        contact.Resolve();
+                        AddContact(pair, contacts, contactPairs);
                         contactListener->OnCollisionEnter(colliderA, colliderB);
                     }
                 }
@@ -236,29 +421,342 @@ namespace Physics
                     {
                         contactListener->OnCollisionExit(colliderA, colliderB);
                     }
-                    _colliderPairs.erase(pairIterator);
+                    EraseContact(slot);
                 }
             }
             else
             {
                 if (IsContact(colliderA, colliderB))
                 {
+                    InsertContact(pair);
                     if (!colliderA.isTrigger && !colliderB.isTrigger)
                     {
-                        Contact contact;
-                        contact.collidingBodies[0] = {&GetBody(colliderA.bodyRef), &colliderA};
-                        contact.collidingBodies[1] = {&GetBody(colliderB.bodyRef), &colliderB};
-                        contact.Resolve();
+                        AddContact(pair, contacts, contactPairs);
                         contactListener->OnCollisionEnter(colliderA, colliderB);
                     }
                     else
                     {
                         contactListener->OnTriggerEnter(colliderA, colliderB);
                     }
-                    _colliderPairs.insert(pair);
                 }
             }
         }
+
+        SolveContacts(contacts, contactPairs);
+    }
+
+    void World::AddContact(const ColliderPair& pair, AllocatedVector<Contact>& contacts,
+                           AllocatedVector<ColliderPair>& contactPairs) noexcept
+    {
+        // Lowest index first, so the normal of a pair keeps its orientation from one step to the next.
+        const auto first = pair.colliderA.index < pair.colliderB.index ? pair.colliderA : pair.colliderB;
+        const auto second = pair.colliderA.index < pair.colliderB.index ? pair.colliderB : pair.colliderA;
+        const auto colliders = _arena.View(_state.colliders);
+        const auto idleFrames = _arena.View(_state.idleFrames);
+        auto& colliderA = colliders[first.index];
+        auto& colliderB = colliders[second.index];
+        auto& bodyA = GetBody(colliderA.bodyRef);
+        auto& bodyB = GetBody(colliderB.bodyRef);
+
+        // Nothing to solve between bodies that do not move, a moving body wakes up the sleeping body it touches.
+        const bool isBodyAMoving = IsSimulated(bodyA) && idleFrames[colliderA.bodyRef.index] == 0;
+        const bool isBodyBMoving = IsSimulated(bodyB) && idleFrames[colliderB.bodyRef.index] == 0;
+        if (!IsSimulated(bodyA) && !IsSimulated(bodyB))
+        {
+            return;
+        }
+        if (isBodyAMoving && bodyB.type == BodyType::DYNAMIC)
+        {
+            bodyB.SetAwake(true);
+        }
+        if (isBodyBMoving && bodyA.type == BodyType::DYNAMIC)
+        {
+            bodyA.SetAwake(true);
+        }
+
+        Contact contact;
+        contact.collidingBodies[0] = CollidingBody{&bodyA, &colliderA};
+        contact.collidingBodies[1] = CollidingBody{&bodyB, &colliderB};
+        contacts.push_back(contact);
+        contactPairs.push_back(pair);
+    }
+
+    void World::SolveContacts(AllocatedVector<Contact>& contacts,
+                              const AllocatedVector<ColliderPair>& contactPairs) noexcept
+    {
+#ifdef TRACY_ENABLE
+        //ZoneScoped;
+#endif
+        // A pair may have been moved in the table by the erase of another one, the manifolds are found by pair.
+        const auto slots = _arena.View(_state.contactSlots);
+        for (std::size_t i = 0; i < contacts.size(); i++)
+        {
+            auto& contact = contacts[i];
+            contact.ComputeManifold();
+            contact.PrepareVelocity();
+            contact.WarmStart(slots[FindContact(contactPairs[i])].manifold);
+        }
+
+        for (int iteration = 0; iteration < velocityIterations; iteration++)
+        {
+            for (auto& contact: contacts)
+            {
+                contact.ResolveVelocity();
+            }
+        }
+
+        for (std::size_t i = 0; i < contacts.size(); i++)
+        {
+            contacts[i].ResolveInterpenetration();
+            slots[FindContact(contactPairs[i])].manifold = contacts[i].Manifold();
+        }
+    }
+
+    void World::ReserveContacts(std::size_t count)
+    {
+        std::size_t slotCount = 16;
+        while (slotCount < 2 * count)
+        {
+            slotCount *= 2;
+        }
+        if (slotCount <= _state.contactSlots.size)
+        {
+            return;
+        }
+
+        ArenaVector<ContactSlot> newSlots{};
+        _arena.Resize(newSlots, slotCount, ContactSlot());
+        auto oldSlots = _state.contactSlots;
+        _state.contactSlots = newSlots;
+        _state.contactCount = 0;
+        for (const auto& slot: _arena.View(oldSlots))
+        {
+            if (slot.isUsed)
+            {
+                InsertContact(slot.pair) = slot.manifold;
+            }
+        }
+        _arena.Free(oldSlots);
+    }
+
+    std::size_t World::FindContact(const ColliderPair& pair) const noexcept
+    {
+        const auto slots = _arena.View(_state.contactSlots);
+        if (slots.empty())
+        {
+            return 0;
+        }
+
+        const auto mask = slots.size() - 1;
+        for (auto slot = ColliderPairHash{}(pair) & mask; slots[slot].isUsed; slot = (slot + 1) & mask)
+        {
+            if (slots[slot].pair == pair)
+            {
+                return slot;
+            }
+        }
+        return slots.size();
+    }
+
+    ContactManifold& World::InsertContact(const ColliderPair& pair) noexcept
+    {
+        const auto slots = _arena.View(_state.contactSlots);
+        const auto mask = slots.size() - 1;
+        auto slot = ColliderPairHash{}(pair) & mask;
+        while (slots[slot].isUsed)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        slots[slot] = ContactSlot{pair, ContactManifold{}, true};
+        _state.contactCount++;
+        return slots[slot].manifold;
+    }
+
+    void World::EraseContact(std::size_t slot) noexcept
+    {
+        const auto slots = _arena.View(_state.contactSlots);
+        const auto mask = slots.size() - 1;
+        auto hole = slot;
+        for (auto next = (slot + 1) & mask; slots[next].isUsed; next = (next + 1) & mask)
+        {
+            // A pair moves back to the hole unless its home slot lies between the hole and itself.
+            const auto home = ColliderPairHash{}(slots[next].pair) & mask;
+            if (((next - home) & mask) >= ((next - hole) & mask))
+            {
+                slots[hole] = slots[next];
+                hole = next;
+            }
+        }
+
+        slots[hole].isUsed = false;
+        _state.contactCount--;
+    }
+
+    void World::SaveSnapshot(std::vector<std::byte>& snapshot) const
+    {
+#ifdef TRACY_ENABLE
+        //ZoneScoped;
+#endif
+        snapshot.resize(sizeof(WorldState) + sizeof(QuadTree) + _arena.UsedSize());
+        std::memcpy(snapshot.data(), &_state, sizeof(WorldState));
+        std::memcpy(snapshot.data() + sizeof(WorldState), &tree, sizeof(QuadTree));
+        std::memcpy(snapshot.data() + sizeof(WorldState) + sizeof(QuadTree), _arena.Data(), _arena.UsedSize());
+    }
+
+    void World::LoadSnapshot(const std::vector<std::byte>& snapshot)
+    {
+#ifdef TRACY_ENABLE
+        //ZoneScoped;
+#endif
+        std::memcpy(&_state, snapshot.data(), sizeof(WorldState));
+        std::memcpy(&tree, snapshot.data() + sizeof(WorldState), sizeof(QuadTree));
+        _arena.Load(snapshot.data() + sizeof(WorldState) + sizeof(QuadTree),
+                    snapshot.size() - sizeof(WorldState) - sizeof(QuadTree));
+    }
+
+    bool World::IsQueryable(ColliderRef colliderRef) const noexcept
+    {
+        return colliderRef.index < _state.colliders.size &&
+               _arena.View(_state.collidersGenIndices)[colliderRef.index] == colliderRef.genIdx &&
+               _arena.View(_state.colliders)[colliderRef.index].IsValid();
+    }
+
+    Math::CircleF World::ColliderCircle(const Collider& collider) const noexcept
+    {
+        return Math::CircleF(_arena.View(_state.bodies)[collider.bodyRef.index].Position(), collider.circleShape.Radius());
+    }
+
+    Math::RectangleF World::ColliderAABB(const Collider& collider) const noexcept
+    {
+        if (collider._shape == Math::ShapeType::Circle)
+        {
+            const auto circle = ColliderCircle(collider);
+            const auto radius = Math::Vec2F(circle.Radius(), circle.Radius());
+            return Math::RectangleF(circle.Center() - radius, circle.Center() + radius);
+        }
+        return collider.rectangleShape;
+    }
+
+    bool World::OverlapAABB(ColliderRef colliderRef, const Math::RectangleF& aabb) const noexcept
+    {
+        if (!IsQueryable(colliderRef))
+        {
+            return false;
+        }
+
+        const auto& collider = _arena.View(_state.colliders)[colliderRef.index];
+        if (collider._shape == Math::ShapeType::Circle)
+        {
+            return Math::Intersect(aabb, ColliderCircle(collider));
+        }
+        return Math::Intersect(aabb, collider.rectangleShape);
+    }
+
+    bool World::ContainPoint(ColliderRef colliderRef, Math::Vec2F point) const noexcept
+    {
+        if (!IsQueryable(colliderRef))
+        {
+            return false;
+        }
+
+        const auto& collider = _arena.View(_state.colliders)[colliderRef.index];
+        if (collider._shape == Math::ShapeType::Circle)
+        {
+            return ColliderCircle(collider).Contains(point);
+        }
+        return collider.rectangleShape.Contains(point);
+    }
+
+    bool World::RayCastCollider(ColliderRef colliderRef, Math::Vec2F origin, Math::Vec2F delta,
+                                RayCastHit& hit) const noexcept
+    {
+        if (!IsQueryable(colliderRef) || delta.SquareLength() <= 0.f)
+        {
+            return false;
+        }
+
+        const auto& collider = _arena.View(_state.colliders)[colliderRef.index];
+        if (collider._shape == Math::ShapeType::Circle)
+        {
+            // Solves |origin + fraction * delta - center|² = radius² for the smallest fraction.
+            const auto circle = ColliderCircle(collider);
+            const auto centerToOrigin = origin - circle.Center();
+            const float a = delta.Dot(delta);
+            const float b = centerToOrigin.Dot(delta);
+            const float c = centerToOrigin.Dot(centerToOrigin) - circle.Radius() * circle.Radius();
+            const float discriminant = b * b - a * c;
+            if (c < 0.f || discriminant < 0.f)
+            {
+                return false;
+            }
+
+            const float fraction = (-b - std::sqrt(discriminant)) / a;
+            if (fraction < 0.f || fraction > 1.f)
+            {
+                return false;
+            }
+
+            hit.colliderRef = colliderRef;
+            hit.fraction = fraction;
+            hit.point = origin + delta * fraction;
+            hit.normal = circle.Radius() > 0.f ? (hit.point - circle.Center()) / circle.Radius() : Math::Vec2F(0.f, 0.f);
+            return true;
+        }
+
+        // Slab test on the rectangle, keeping the axis of the entry fraction for the normal.
+        const auto& rectangle = collider.rectangleShape;
+        if (rectangle.Contains(origin))
+        {
+            return false;
+        }
+
+        const std::array<float, 2> origins{origin.X, origin.Y};
+        const std::array<float, 2> deltas{delta.X, delta.Y};
+        const std::array<float, 2> minBounds{rectangle.MinBound().X, rectangle.MinBound().Y};
+        const std::array<float, 2> maxBounds{rectangle.MaxBound().X, rectangle.MaxBound().Y};
+
+        float enter = 0.f;
+        float exit = 1.f;
+        Math::Vec2F normal(0.f, 0.f);
+        for (std::size_t axis = 0; axis < 2; axis++)
+        {
+            if (QuadTree::IsParallelToSlab(deltas[axis]))
+            {
+                if (origins[axis] < minBounds[axis] || origins[axis] > maxBounds[axis])
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            const float inverseDelta = 1.f / deltas[axis];
+            float near = (minBounds[axis] - origins[axis]) * inverseDelta;
+            float far = (maxBounds[axis] - origins[axis]) * inverseDelta;
+            float side = -1.f;
+            if (near > far)
+            {
+                std::swap(near, far);
+                side = 1.f;
+            }
+
+            if (near > enter)
+            {
+                enter = near;
+                normal = axis == 0 ? Math::Vec2F(side, 0.f) : Math::Vec2F(0.f, side);
+            }
+            exit = std::min(exit, far);
+            if (enter > exit)
+            {
+                return false;
+            }
+        }
+
+        hit.colliderRef = colliderRef;
+        hit.fraction = enter;
+        hit.point = origin + delta * enter;
+        hit.normal = normal;
+        return true;
     }
 
     const std::size_t World::GetInitSizeForVector() noexcept
@@ -0,0 +1,163 @@
+#include "WorldBatch.h"
+
+namespace Physics
+{
+    void WorldBatch::Init() noexcept
+    {
+        for (auto& world: worlds)
+        {
+            world.Init();
+        }
+
+        const auto blockCount = World::initSizeForVector;
+        _positions.reserve(blockCount);
+        _velocities.reserve(blockCount);
+        _forces.reserve(blockCount);
+        _masses.reserve(blockCount);
+        _laneBodies.reserve(blockCount);
+    }
+
+    void WorldBatch::Clear() noexcept
+    {
+        for (auto& world: worlds)
+        {
+            world.Clear();
+        }
+
+        _positions.clear();
+        _velocities.clear();
+        _forces.clear();
+        _masses.clear();
+        _laneBodies.clear();
+    }
+
+    void WorldBatch::Update(float deltaTime) noexcept
+    {
+#ifdef TRACY_ENABLE
+        //ZoneScoped;
+#endif
+        for (auto& world: worlds)
+        {
+            world.WakeBodies();
+        }
+
+        const auto blockCount = GatherLanes();
+        IntegrateLanes(blockCount, deltaTime);
+        ScatterLanes(blockCount);
+
+        for (auto& world: worlds)
+        {
+            world.ResolveCollisions();
+            world.SleepBodies();
+        }
+    }
+
+    std::size_t WorldBatch::GatherLanes() noexcept
+    {
+#ifdef TRACY_ENABLE
+        //ZoneScoped;
+#endif
+        // The Worlds do not allocate while gathering, their views stay valid for the whole pass.
+        std::array<ArenaSpan<const std::uint32_t>, LaneCount> awakeBodies{};
+        std::array<ArenaSpan<const Body>, LaneCount> bodies{};
+        std::size_t blockCount = 0;
+        for (std::size_t lane = 0; lane < LaneCount; lane++)
+        {
+            const auto& world = worlds[lane];
+            awakeBodies[lane] = world._arena.View(world._state.awakeBodies);
+            bodies[lane] = world._arena.View(world._state.bodies);
+            blockCount = std::max(blockCount, awakeBodies[lane].size());
+        }
+
+        _positions.resize(blockCount);
+        _velocities.resize(blockCount);
+        _forces.resize(blockCount);
+        _masses.resize(blockCount);
+        _laneBodies.resize(blockCount);
+
+        for (std::size_t block = 0; block < blockCount; block++)
+        {
+            std::array<Math::Vec2F, LaneCount> positions{};
+            std::array<Math::Vec2F, LaneCount> velocities{};
+            std::array<Math::Vec2F, LaneCount> forces{};
+            // An empty lane keeps a mass of 1 so the lane division never divides by zero.
+            std::array<Math::Vec2F, LaneCount> masses{};
+            masses.fill(Math::Vec2F(1.f, 1.f));
+
+            for (std::size_t lane = 0; lane < LaneCount; lane++)
+            {
+                // The awake list may still hold bodies not valid yet or made static, SleepBodies drops them.
+                _laneBodies[block][lane] = EmptyLane;
+                if (block >= awakeBodies[lane].size())
+                {
+                    continue;
+                }
+
+                const auto index = awakeBodies[lane][block];
+                const auto& body = bodies[lane][index];
+                if (!World::IsSimulated(body))
+                {
+                    continue;
+                }
+
+                _laneBodies[block][lane] = index;
+                positions[lane] = body._position;
+                velocities[lane] = body._velocity;
+                forces[lane] = body._totalForce;
+                masses[lane] = Math::Vec2F(body._mass, body._mass);
+            }
+
+            _positions[block] = Math::FourVec2F(positions);
+            _velocities[block] = Math::FourVec2F(velocities);
+            _forces[block] = Math::FourVec2F(forces);
+            _masses[block] = Math::FourVec2F(masses);
+        }
+
+        return blockCount;
+    }
+
+    void WorldBatch::IntegrateLanes(std::size_t blockCount, float deltaTime) noexcept
+    {
+#ifdef TRACY_ENABLE
+        //ZoneScoped;
+#endif
+        const Math::FourVec2F deltaTimes(Math::Vec2F(deltaTime, deltaTime));
+
+        // Same operations, in the same order, as World::Integrate so a lane ends bit-identical to a lone World.
+        for (std::size_t block = 0; block < blockCount; block++)
+        {
+            const auto acceleration = _forces[block] / _masses[block];
+            _velocities[block] = _velocities[block] + acceleration * deltaTimes;
+            _positions[block] = _positions[block] + _velocities[block] * deltaTimes;
+        }
+    }
+
+    void WorldBatch::ScatterLanes(std::size_t blockCount) noexcept
+    {
+#ifdef TRACY_ENABLE
+        //ZoneScoped;
+#endif
+        for (std::size_t block = 0; block < blockCount; block++)
+        {
+            const auto& positionsX = _positions[block].X();
+            const auto& positionsY = _positions[block].Y();
+            const auto& velocitiesX = _velocities[block].X();
+            const auto& velocitiesY = _velocities[block].Y();
+
+            for (std::size_t lane = 0; lane < LaneCount; lane++)
+            {
+                const auto index = _laneBodies[block][lane];
+                if (index == EmptyLane)
+                {
+                    continue;
+                }
+
+                auto& body = worlds[lane]._arena.View(worlds[lane]._state.bodies)[index];
+                // The body is awake already, the fields are written without the wake up test of the setters.
+                body._velocity = Math::Vec2F(velocitiesX[lane], velocitiesY[lane]);
+                body._position = Math::Vec2F(positionsX[lane], positionsY[lane]);
+                body._totalForce = Math::Vec2F(0., 0.);
+            }
+        }
+    }
+}
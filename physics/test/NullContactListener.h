@@ -0,0 +1,22 @@
+#pragma once
+
+#include "ContactListener.h"
+
+/**
+ * @brief Contact listener ignoring every event, for the tests that only need the World to run its narrow phase.
+ */
+class NullContactListener final : public Physics::ContactListener
+{
+public:
+    void OnTriggerEnter(Physics::Collider, Physics::Collider) noexcept override
+    {}
+
+    void OnTriggerExit(Physics::Collider, Physics::Collider) noexcept override
+    {}
+
+    void OnCollisionEnter(Physics::Collider, Physics::Collider) noexcept override
+    {}
+
+    void OnCollisionExit(Physics::Collider, Physics::Collider) noexcept override
+    {}
+};
@@ -0,0 +1,425 @@
+#include "Allocator.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(FrameAllocator, AllocateFromBuffer)
+{
+    FrameAllocator allocator(1024);
+    auto* first = allocator.Allocate<std::uint32_t>(3);
+    auto* second = allocator.Allocate<std::uint32_t>(3);
+
+    EXPECT_NE(first, second);
+    EXPECT_EQ(reinterpret_cast<std::uint32_t*>(second) - first, 3);
+    EXPECT_EQ(allocator.UsedSize(), 6 * sizeof(std::uint32_t));
+
+    allocator.Reset();
+    EXPECT_EQ(allocator.UsedSize(), 0);
+    EXPECT_EQ(allocator.Allocate<std::uint32_t>(3), first);
+}
+
+TEST(FrameAllocator, OverflowGrowsOnReset)
+{
+    FrameAllocator allocator(64);
+    auto* inBuffer = allocator.Allocate<char>(64);
+    auto* overflow = allocator.Allocate<char>(128);
+    ASSERT_NE(overflow, nullptr);
+    EXPECT_NE(inBuffer, overflow);
+    EXPECT_EQ(allocator.UsedSize(), 192);
+
+    allocator.Reset();
+    EXPECT_EQ(allocator.Capacity(), 192);
+    allocator.Allocate<char>(192);
+    allocator.Reset();
+    EXPECT_EQ(allocator.Capacity(), 192);
+}
+
+TEST(FrameAllocator, SeveralOverflowsAreReleased)
+{
+    FrameAllocator allocator(16);
+    std::vector<char*> overflows;
+    for (int i = 0; i < 8; i++)
+    {
+        auto* ptr = allocator.Allocate<char>(32);
+        std::fill(ptr, ptr + 32, static_cast<char>(i));
+        overflows.push_back(ptr);
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(overflows[i][31], static_cast<char>(i));
+    }
+
+    allocator.Reset();
+    EXPECT_EQ(allocator.Capacity(), 8 * (32 + alignof(char) - 1));
+}
+
+TEST(FrameAllocator, CopyIsEmpty)
+{
+    FrameAllocator allocator(256);
+    auto* ptr = allocator.Allocate<char>(32);
+
+    FrameAllocator copy(allocator);
+    EXPECT_EQ(copy.UsedSize(), 0);
+    EXPECT_EQ(copy.Capacity(), 256);
+    EXPECT_NE(copy.Allocate<char>(32), ptr);
+
+    FrameAllocator other(16);
+    other = allocator;
+    EXPECT_EQ(other.Capacity(), 16);
+}
+
+namespace
+{
+bool IsAligned(const void* ptr, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+void ExpectAlignedAllocations(Allocator& allocator)
+{
+    for (std::size_t alignment: {16, 32, 64})
+    {
+        // An odd-sized allocation first, so the next one needs padding.
+        allocator.Allocate(3, 1);
+        auto* ptr = allocator.Allocate(24, alignment);
+        EXPECT_TRUE(IsAligned(ptr, alignment)) << "alignment " << alignment;
+    }
+}
+}
+
+TEST(Allocator, LinearAlignment)
+{
+    LinearAllocator allocator(1024);
+    ExpectAlignedAllocations(allocator);
+}
+
+TEST(Allocator, StackAlignment)
+{
+    StackAllocator allocator(1024);
+    auto* first = allocator.Allocate(3, 1);
+    auto* second = allocator.Allocate(24, 64);
+    EXPECT_TRUE(IsAligned(second, 64));
+
+    // Freeing the top gives back the padding as well.
+    allocator.Deallocate(second);
+    EXPECT_EQ(allocator.Allocate(24, 64), second);
+    allocator.Deallocate(second);
+    allocator.Deallocate(first);
+    EXPECT_EQ(allocator.Allocate(3, 1), first);
+}
+
+TEST(Allocator, HeapAlignment)
+{
+    HeapAllocator allocator;
+    for (std::size_t alignment: {16, 32, 64})
+    {
+        auto* ptr = allocator.Allocate(24, alignment);
+        EXPECT_TRUE(IsAligned(ptr, alignment));
+        allocator.Deallocate(ptr);
+    }
+}
+
+TEST(Allocator, TlsfAlignment)
+{
+    TlsfAllocator allocator(4096);
+    ExpectAlignedAllocations(allocator);
+
+    // A freed aligned block is reused by the next request of the same size.
+    auto* ptr = allocator.Allocate(24, 64);
+    allocator.Deallocate(ptr);
+    EXPECT_EQ(allocator.Allocate(24, 64), ptr);
+}
+
+TEST(TlsfAllocator, CoalescesFreedNeighbours)
+{
+    TlsfAllocator allocator(48 * 1024);
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 64; i++)
+    {
+        ptrs.push_back(allocator.Allocate(200 + i * 8, 8));
+    }
+    EXPECT_THROW(allocator.Allocate(32 * 1024, 8), std::runtime_error);
+
+    // Freeing every other block first, then the rest: the free blocks end up merged into one.
+    for (std::size_t i = 0; i < ptrs.size(); i += 2)
+    {
+        allocator.Deallocate(ptrs[i]);
+    }
+    for (std::size_t i = 1; i < ptrs.size(); i += 2)
+    {
+        allocator.Deallocate(ptrs[i]);
+    }
+    EXPECT_EQ(allocator.Allocate(32 * 1024, 8), ptrs[0]);
+}
+
+TEST(TlsfAllocator, RandomWorkloadKeepsBlocksDisjoint)
+{
+    TlsfAllocator allocator(256 * 1024);
+    std::vector<std::pair<unsigned char*, std::size_t>> live;
+    unsigned int seed = 12345;
+    auto random = [&seed]()
+    {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    for (int step = 0; step < 4000; step++)
+    {
+        if (live.empty() || (live.size() < 100 && random() % 2 == 0))
+        {
+            const std::size_t size = 1 + random() % 1500;
+            const std::size_t alignment = std::size_t(1) << (random() % 8);
+            auto* ptr = static_cast<unsigned char*>(allocator.Allocate(size, alignment));
+            ASSERT_TRUE(IsAligned(ptr, alignment));
+            std::fill(ptr, ptr + size, static_cast<unsigned char>(live.size()));
+            live.emplace_back(ptr, size);
+            continue;
+        }
+
+        const auto index = random() % live.size();
+        auto [ptr, size] = live[index];
+        // Any overlap would have overwritten the fill value of the block.
+        const auto value = *ptr;
+        EXPECT_TRUE(std::all_of(ptr, ptr + size, [value](unsigned char byte) { return byte == value; }));
+        allocator.Deallocate(ptr);
+        live[index] = live.back();
+        live.pop_back();
+        for (auto& [otherPtr, otherSize]: live)
+        {
+            std::fill(otherPtr, otherPtr + otherSize, static_cast<unsigned char>(&otherPtr - &live[0].first));
+        }
+    }
+
+    for (auto& [ptr, size]: live)
+    {
+        allocator.Deallocate(ptr);
+    }
+    // Everything merged back: the biggest block fits again.
+    EXPECT_NO_THROW(allocator.Deallocate(allocator.Allocate(200 * 1024, 8)));
+}
+
+TEST(TlsfAllocator, StandardAllocatorVector)
+{
+    TlsfAllocator allocator(64 * 1024, "TestTlsf");
+    {
+        AllocatedVector<int> values{StandardAllocator<int>{allocator}};
+        for (int i = 0; i < 1000; i++)
+        {
+            values.push_back(i);
+        }
+        EXPECT_EQ(values[999], 999);
+        EXPECT_GT(allocator.Stats().bytesInUse, 1000 * sizeof(int));
+    }
+    EXPECT_EQ(allocator.Stats().bytesInUse, 0);
+}
+
+TEST(Allocator, PoolAlignment)
+{
+    PoolAllocator allocator(4, 24, 32);
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(IsAligned(allocator.Allocate(24, 32), 32));
+    }
+    EXPECT_THROW(allocator.Allocate(24, 32), std::runtime_error);
+
+    PoolAllocator smallAlignment(1, 24, 16);
+    EXPECT_THROW(smallAlignment.Allocate(24, 32), std::runtime_error);
+}
+
+TEST(FrameAllocator, Alignment)
+{
+    FrameAllocator allocator(256);
+    ExpectAlignedAllocations(allocator);
+
+    // Overflow allocations are aligned too.
+    EXPECT_TRUE(IsAligned(allocator.Allocate(512, 64), 64));
+}
+
+TEST(AllocatorStats, UntaggedRecordsNothing)
+{
+    HeapAllocator allocator;
+    allocator.Deallocate(allocator.Allocate(64, 8));
+    const auto stats = allocator.Stats();
+    EXPECT_EQ(stats.tag, nullptr);
+    EXPECT_EQ(stats.allocationCount, 0);
+}
+
+TEST(AllocatorStats, HeapInUseAndPeak)
+{
+    HeapAllocator allocator("TestHeap");
+    auto* first = allocator.Allocate(64, 8);
+    auto* second = allocator.Allocate(32, 8);
+    allocator.Deallocate(first);
+
+    const auto stats = allocator.Stats();
+    EXPECT_EQ(stats.bytesInUse, 32);
+    EXPECT_EQ(stats.peakBytes, 96);
+    EXPECT_EQ(stats.allocationCount, 2);
+    EXPECT_EQ(stats.failedCount, 0);
+    allocator.Deallocate(second);
+    EXPECT_EQ(allocator.Stats().bytesInUse, 0);
+}
+
+TEST(AllocatorStats, FailedRequests)
+{
+    PoolAllocator pool(1, 16);
+    pool.SetTag("TestPool");
+    pool.Allocate(16, 8);
+    EXPECT_THROW(pool.Allocate(16, 8), std::runtime_error);
+    EXPECT_EQ(pool.Stats().failedCount, 1);
+
+    // Spilling out of a frame arena is a failed request, but still an allocation.
+    FrameAllocator frame(16, "TestFrame");
+    frame.Allocate(32, 1);
+    EXPECT_EQ(frame.Stats().failedCount, 1);
+    EXPECT_EQ(frame.Stats().bytesInUse, 32);
+    frame.Reset();
+    EXPECT_EQ(frame.Stats().bytesInUse, 0);
+    EXPECT_EQ(frame.Stats().peakBytes, 32);
+}
+
+TEST(AllocatorStats, CollectSumsPerTag)
+{
+    HeapAllocator first("TestCollect");
+    HeapAllocator second("TestCollect");
+    auto* firstPtr = first.Allocate(16, 8);
+    auto* secondPtr = second.Allocate(48, 8);
+
+    auto findTag = [](const char* tag)
+    {
+        const auto stats = CollectAllocatorStats();
+        return std::count_if(stats.begin(), stats.end(), [tag](const AllocatorStats& tagStats)
+        {
+            return std::string(tagStats.tag) == tag;
+        });
+    };
+
+    {
+        // A copy keeps the tag with its own counters.
+        HeapAllocator copy(first);
+        EXPECT_EQ(copy.Tag(), first.Tag());
+        EXPECT_EQ(copy.Stats().allocationCount, 0);
+
+        const auto stats = CollectAllocatorStats();
+        const auto it = std::find_if(stats.begin(), stats.end(), [](const AllocatorStats& tagStats)
+        {
+            return std::string(tagStats.tag) == "TestCollect";
+        });
+        ASSERT_NE(it, stats.end());
+        EXPECT_EQ(it->bytesInUse, 64);
+        EXPECT_EQ(it->allocationCount, 2);
+        EXPECT_EQ(findTag("TestCollect"), 1);
+    }
+    EXPECT_EQ(findTag("TestHeap"), 0);
+    first.Deallocate(firstPtr);
+    second.Deallocate(secondPtr);
+}
+
+TEST(ThreadCachePoolAllocator, ReusesFreedBlocks)
+{
+    ThreadCachePoolAllocator allocator(24, 32, 64);
+    EXPECT_EQ(allocator.BlockSize(), 32);
+
+    auto* ptr = allocator.Allocate(24, 32);
+    EXPECT_TRUE(IsAligned(ptr, 32));
+    allocator.Deallocate(ptr);
+    EXPECT_EQ(allocator.Allocate(24, 32), ptr);
+
+    EXPECT_THROW(allocator.Allocate(64, 8), std::runtime_error);
+    EXPECT_THROW(allocator.Allocate(16, 64), std::runtime_error);
+}
+
+TEST(ThreadCachePoolAllocator, GrowsBySlabs)
+{
+    ThreadCachePoolAllocator allocator(16, 16, 64, "TestThreadPool");
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 200; i++)
+    {
+        ptrs.push_back(allocator.Allocate(16, 16));
+    }
+    std::sort(ptrs.begin(), ptrs.end());
+    EXPECT_EQ(std::unique(ptrs.begin(), ptrs.end()), ptrs.end());
+    // 200 blocks need four slabs of 64 blocks.
+    EXPECT_EQ(allocator.Stats().bytesInUse, 4 * 64 * 16);
+
+    for (auto* ptr: ptrs)
+    {
+        allocator.Deallocate(ptr);
+    }
+}
+
+TEST(ThreadCachePoolAllocator, ConcurrentThreads)
+{
+    ThreadCachePoolAllocator allocator(sizeof(std::uint64_t), alignof(std::uint64_t), 256);
+    constexpr int threadCount = 4;
+    std::atomic<int> errors{0};
+
+    // Every thread frees half of its blocks on the next thread, so blocks move between thread caches.
+    std::vector<std::vector<std::uint64_t*>> handOver(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&allocator, &errors, &handOver, t]()
+        {
+            std::vector<std::uint64_t*> live;
+            for (int round = 0; round < 50; round++)
+            {
+                for (std::uint64_t i = 0; i < 200; i++)
+                {
+                    auto* value = allocator.Allocate<std::uint64_t>(1);
+                    *value = (static_cast<std::uint64_t>(t) << 32) | i;
+                    live.push_back(value);
+                }
+                for (std::uint64_t i = 0; i < live.size(); i++)
+                {
+                    if (*live[i] != ((static_cast<std::uint64_t>(t) << 32) | i))
+                    {
+                        errors++;
+                    }
+                }
+                for (std::size_t i = 0; i < live.size(); i += 2)
+                {
+                    allocator.Deallocate(live[i]);
+                }
+                for (std::size_t i = 1; i < live.size(); i += 2)
+                {
+                    handOver[t].push_back(live[i]);
+                }
+                live.clear();
+            }
+        });
+    }
+    for (auto& thread: threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(errors.load(), 0);
+
+    std::thread freeing([&allocator, &handOver]()
+    {
+        for (auto& ptrs: handOver)
+        {
+            for (auto* ptr: ptrs)
+            {
+                allocator.Deallocate(ptr);
+            }
+        }
+    });
+    freeing.join();
+}
+
+TEST(ThreadCachePoolAllocator, StandardAllocatorVector)
+{
+    ThreadCachePoolAllocator allocator(64 * sizeof(int));
+    AllocatedVector<int> values{StandardAllocator<int>{allocator}};
+    values.reserve(64);
+    for (int i = 0; i < 64; i++)
+    {
+        values.push_back(i);
+    }
+    EXPECT_EQ(values[63], 63);
+}
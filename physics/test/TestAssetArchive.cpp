@@ -0,0 +1,150 @@
+#include "AssetArchive.h"
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string ArchivePath(const char* name)
+    {
+        return testing::TempDir() + name;
+    }
+}
+
+TEST(AssetArchive, WrittenEntriesAreMappedInPlace)
+{
+    std::array<std::uint8_t, 3 * 2 * 4> pixels{};
+    for (std::size_t i = 0; i < pixels.size(); i++)
+    {
+        pixels[i] = static_cast<std::uint8_t>(i);
+    }
+    const char wave[] = "RIFF....WAVE";
+
+    AssetArchiveWriter writer;
+    EXPECT_TRUE(writer.AddFile("data/theme.wav", wave, sizeof(wave)));
+    EXPECT_TRUE(writer.AddImage("data/player1.png", pixels.data(), 3, 2, 0.5f));
+    EXPECT_FALSE(writer.AddFile("data/theme.wav", wave, sizeof(wave)));
+    EXPECT_FALSE(writer.AddFile(std::string(AssetEntry::MaxNameLength + 1, 'a'), wave, sizeof(wave)));
+
+    const auto path = ArchivePath("written.pack");
+    ASSERT_TRUE(writer.Write(path.c_str()));
+
+    AssetArchive archive;
+    ASSERT_TRUE(archive.Open(path.c_str()));
+    EXPECT_EQ(archive.EntryCount(), 2);
+    EXPECT_EQ(archive.Find("data/missing.png"), nullptr);
+
+    const auto* image = archive.Find("data/player1.png");
+    ASSERT_NE(image, nullptr);
+    EXPECT_EQ(image->type, AssetType::Image);
+    EXPECT_EQ(image->width, 3);
+    EXPECT_EQ(image->height, 2);
+    EXPECT_FLOAT_EQ(image->bakedScale, 0.5f);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(archive.Data(*image)) % AssetArchiveWriter::DataAlignment, 0);
+    EXPECT_EQ(std::memcmp(archive.Data(*image), pixels.data(), pixels.size()), 0);
+
+    const auto* file = archive.Find("data/theme.wav");
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(file->type, AssetType::File);
+    ASSERT_EQ(file->size, sizeof(wave));
+    EXPECT_EQ(std::memcmp(archive.Data(*file), wave, sizeof(wave)), 0);
+
+    archive.Close();
+    EXPECT_FALSE(archive.IsOpen());
+    EXPECT_EQ(archive.Find("data/theme.wav"), nullptr);
+    std::remove(path.c_str());
+}
+
+TEST(AssetArchive, RejectsInvalidFiles)
+{
+    AssetArchive archive;
+    EXPECT_FALSE(archive.Open(ArchivePath("missing.pack").c_str()));
+
+    const auto path = ArchivePath("invalid.pack");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not an asset archive at all";
+    }
+    EXPECT_FALSE(archive.Open(path.c_str()));
+    EXPECT_FALSE(archive.IsOpen());
+
+    // A valid archive cut before the end of its data.
+    const char data[64]{};
+    AssetArchiveWriter writer;
+    writer.AddFile("data/file.bin", data, sizeof(data));
+    ASSERT_TRUE(writer.Write(path.c_str()));
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        std::ofstream truncated(path, std::ios::binary | std::ios::trunc);
+        truncated.write(content.data(), static_cast<std::streamsize>(content.size() - 1));
+    }
+    EXPECT_FALSE(archive.Open(path.c_str()));
+    std::remove(path.c_str());
+}
+
+TEST(AssetArchive, AtlasSpritesPointInsideTheirAtlas)
+{
+    // Each sprite is filled with its own index, so that an overlap or a wrong region shows in the pixels.
+    const std::array<std::array<std::uint32_t, 2>, 4> sizes{{{5, 3}, {2, 7}, {9, 1}, {4, 4}}};
+    std::vector<std::vector<std::uint32_t>> pixels;
+    std::vector<AtlasSprite> sprites;
+    for (std::size_t i = 0; i < sizes.size(); i++)
+    {
+        pixels.emplace_back(sizes[i][0] * sizes[i][1], static_cast<std::uint32_t>(i + 1));
+        sprites.push_back(AtlasSprite{"data/sprite" + std::to_string(i) + ".png", pixels.back().data(),
+                                      sizes[i][0], sizes[i][1], 0.5f});
+    }
+
+    AssetArchiveWriter writer;
+    EXPECT_FALSE(writer.AddAtlas("data/sprites.atlas", {sprites[0], sprites[0]}));
+    ASSERT_TRUE(writer.AddAtlas("data/sprites.atlas", sprites));
+    EXPECT_FALSE(writer.AddFile("data/sprite1.png", pixels[1].data(), 4));
+
+    const auto path = ArchivePath("atlas.pack");
+    ASSERT_TRUE(writer.Write(path.c_str()));
+    AssetArchive archive;
+    ASSERT_TRUE(archive.Open(path.c_str()));
+    EXPECT_EQ(archive.EntryCount(), sizes.size() + 1);
+
+    const auto* atlas = archive.Find("data/sprites.atlas");
+    ASSERT_NE(atlas, nullptr);
+    EXPECT_EQ(atlas->type, AssetType::Image);
+    const auto* atlasPixels = reinterpret_cast<const std::uint32_t*>(archive.Data(*atlas));
+
+    std::size_t coloredPixels = 0;
+    for (std::size_t i = 0; i < atlas->width * atlas->height; i++)
+    {
+        coloredPixels += atlasPixels[i] != 0;
+    }
+    std::size_t spritePixels = 0;
+    for (std::size_t i = 0; i < sizes.size(); i++)
+    {
+        const auto* sprite = archive.Find(sprites[i].name);
+        ASSERT_NE(sprite, nullptr);
+        EXPECT_EQ(sprite->type, AssetType::Sprite);
+        EXPECT_EQ(sprite->width, sizes[i][0]);
+        EXPECT_EQ(sprite->height, sizes[i][1]);
+        EXPECT_FLOAT_EQ(sprite->bakedScale, 0.5f);
+
+        const auto region = archive.Region(*sprite);
+        EXPECT_EQ(&archive.Entry(region.atlasIndex), atlas);
+        for (std::uint32_t y = 0; y < sprite->height; y++)
+        {
+            for (std::uint32_t x = 0; x < sprite->width; x++)
+            {
+                EXPECT_EQ(atlasPixels[(region.y + y) * atlas->width + region.x + x], i + 1);
+            }
+        }
+        spritePixels += sprite->width * sprite->height;
+    }
+    // Nothing but the sprites is drawn, the padding stays transparent.
+    EXPECT_EQ(coloredPixels, spritePixels);
+    std::remove(path.c_str());
+}
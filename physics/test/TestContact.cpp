@@ -0,0 +1,105 @@
+#include "World.h"
+#include "NullContactListener.h"
+#include "gtest/gtest.h"
+
+#include <array>
+
+TEST(Contact, ResolveSwapsVelocitiesOfEqualCircles)
+{
+    Physics::Body bodyA(1.f, Math::Vec2F(1.f, 0.f), Math::Vec2F(0.f, 0.f));
+    Physics::Body bodyB(1.f, Math::Vec2F(-1.f, 0.f), Math::Vec2F(1.5f, 0.f));
+    Physics::Collider colliderA;
+    colliderA._shape = Math::ShapeType::Circle;
+    colliderA.circleShape = Math::CircleF(Math::Vec2F(0.f, 0.f), 1.f);
+    Physics::Collider colliderB = colliderA;
+
+    Physics::Contact contact;
+    contact.collidingBodies[0] = Physics::CollidingBody{&bodyA, &colliderA};
+    contact.collidingBodies[1] = Physics::CollidingBody{&bodyB, &colliderB};
+    contact.Resolve();
+
+    EXPECT_FLOAT_EQ(bodyA.Velocity().X, -1.f);
+    EXPECT_FLOAT_EQ(bodyB.Velocity().X, 1.f);
+    EXPECT_FLOAT_EQ(contact.normalImpulse, 2.f);
+    EXPECT_FLOAT_EQ(contact.Manifold().normal.X, -1.f);
+}
+
+TEST(Contact, WarmStartIgnoresTurnedNormal)
+{
+    Physics::Body bodyA(1.f, Math::Vec2F(0.f, 0.f), Math::Vec2F(0.f, 1.5f));
+    Physics::Body bodyB(1.f, Math::Vec2F(0.f, 0.f), Math::Vec2F(0.f, 0.f));
+    Physics::Collider collider;
+    collider._shape = Math::ShapeType::Circle;
+    collider.circleShape = Math::CircleF(Math::Vec2F(0.f, 0.f), 1.f);
+    collider.restitution = 0.f;
+    Physics::Collider otherCollider = collider;
+
+    Physics::Contact contact;
+    contact.collidingBodies[0] = Physics::CollidingBody{&bodyA, &collider};
+    contact.collidingBodies[1] = Physics::CollidingBody{&bodyB, &otherCollider};
+    contact.ComputeManifold();
+    contact.PrepareVelocity();
+
+    contact.WarmStart(Physics::ContactManifold{Math::Vec2F(0.f, 1.f), Math::Vec2F(1.f, 0.f), 0.5f, 3.f});
+    EXPECT_FLOAT_EQ(contact.normalImpulse, 0.f);
+    EXPECT_EQ(bodyA.Velocity(), Math::Vec2F(0.f, 0.f));
+
+    contact.WarmStart(Physics::ContactManifold{Math::Vec2F(0.f, 1.f), Math::Vec2F(0.f, 1.f), 0.5f, 3.f});
+    EXPECT_FLOAT_EQ(contact.normalImpulse, 3.f);
+    EXPECT_FLOAT_EQ(bodyA.Velocity().Y, 3.f);
+    EXPECT_FLOAT_EQ(bodyB.Velocity().Y, -3.f);
+
+    // Bodies flying apart: the solver takes the whole warm start impulse back.
+    contact.ResolveVelocity();
+    EXPECT_FLOAT_EQ(contact.normalImpulse, 0.f);
+    EXPECT_FLOAT_EQ(bodyA.Velocity().Y, 0.f);
+}
+
+TEST(Contact, StackComesToRest)
+{
+    Physics::World world;
+    world.Init();
+    NullContactListener listener;
+    world.contactListener = &listener;
+
+    const auto groundRef = world.CreateBody();
+    auto& ground = world.GetBody(groundRef);
+    ground.type = Physics::BodyType::STATIC;
+    ground.SetMass(1.f);
+    ground.SetPosition(Math::Vec2F(0.f, -100.f));
+    ground.SetVelocity(Math::Vec2F(0.f, 0.f));
+    auto& groundCollider = world.GetCollider(world.CreateCollider(groundRef));
+    groundCollider._shape = Math::ShapeType::Circle;
+    groundCollider.circleShape = Math::CircleF(Math::Vec2F(0.f, -100.f), 100.f);
+    groundCollider.restitution = 0.f;
+
+    std::array<Physics::BodyRef, 3> stack{};
+    for (std::size_t i = 0; i < stack.size(); i++)
+    {
+        stack[i] = world.CreateBody();
+        auto& body = world.GetBody(stack[i]);
+        body.SetMass(1.f);
+        body.SetPosition(Math::Vec2F(0.f, 1.f + 2.f * static_cast<float>(i)));
+        body.SetVelocity(Math::Vec2F(0.f, 0.f));
+        auto& collider = world.GetCollider(world.CreateCollider(stack[i]));
+        collider._shape = Math::ShapeType::Circle;
+        collider.circleShape = Math::CircleF(body.Position(), 1.f);
+        collider.restitution = 0.f;
+    }
+
+    for (int step = 0; step < 200; step++)
+    {
+        for (const auto& bodyRef: stack)
+        {
+            world.GetBody(bodyRef).AddForce(Math::Vec2F(0.f, -9.81f));
+        }
+        world.Update(1 / 50.f);
+    }
+
+    for (std::size_t i = 0; i < stack.size(); i++)
+    {
+        auto& body = world.GetBody(stack[i]);
+        EXPECT_NEAR(body.Velocity().Y, 0.f, 0.25f);
+        EXPECT_NEAR(body.Position().Y, 1.f + 2.f * static_cast<float>(i), 0.1f);
+    }
+}
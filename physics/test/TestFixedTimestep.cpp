@@ -0,0 +1,47 @@
+#include "FixedTimestep.h"
+#include "gtest/gtest.h"
+
+TEST(FixedTimestep, TicksAtTheFixedRateWhateverTheFrameRate)
+{
+    // One second of frames at 60, 144 and 30 Hz runs 50 ticks of 1/50 s each time.
+    for (const int frameRate: {60, 144, 30})
+    {
+        FixedTimestep timestep(1.0 / 50.0);
+        int tickCount = 0;
+        for (int frame = 0; frame < frameRate; frame++)
+        {
+            tickCount += timestep.Advance(1.0 / frameRate);
+            EXPECT_GE(timestep.Alpha(), 0.f);
+            EXPECT_LE(timestep.Alpha(), 1.f);
+        }
+        // The last tick may still be a rounding error away.
+        EXPECT_NEAR(tickCount, 50, 1);
+        EXPECT_EQ(timestep.DroppedTime(), 0.0);
+    }
+}
+
+TEST(FixedTimestep, AlphaIsTheFractionOfTheNextTick)
+{
+    FixedTimestep timestep(0.25);
+    EXPECT_EQ(timestep.Advance(0.125), 0);
+    EXPECT_FLOAT_EQ(timestep.Alpha(), 0.5f);
+    EXPECT_EQ(timestep.Advance(0.1875), 1);
+    EXPECT_FLOAT_EQ(timestep.Alpha(), 0.25f);
+
+    timestep.Reset();
+    EXPECT_FLOAT_EQ(timestep.Alpha(), 0.f);
+}
+
+TEST(FixedTimestep, CatchUpIsCapped)
+{
+    FixedTimestep timestep(0.25, 3);
+    EXPECT_EQ(timestep.Advance(0.5), 2);
+
+    // Ten ticks late: three run, the rest is dropped but the fraction of a tick is kept.
+    EXPECT_EQ(timestep.Advance(2.625), 3);
+    EXPECT_FLOAT_EQ(timestep.Alpha(), 0.5f);
+    EXPECT_DOUBLE_EQ(timestep.DroppedTime(), 1.75);
+    EXPECT_EQ(timestep.Advance(0.125), 1);
+
+    EXPECT_EQ(timestep.Advance(-1.0), 0);
+}
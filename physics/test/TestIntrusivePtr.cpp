@@ -0,0 +1,80 @@
+#include "IntrusivePtr.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Buffer : RefCounted<>
+    {
+        explicit Buffer(int size) noexcept : size(size)
+        {}
+
+        int size;
+    };
+
+    struct SharedBuffer : RefCounted<AtomicCount>
+    {
+        int size = 0;
+    };
+}
+
+TEST(IntrusivePtr, CountLivesInObject)
+{
+    IntrusivePtr<Buffer> ptr(new Buffer(4));
+    EXPECT_EQ(ptr.Count(), 1);
+
+    // A second pointer made from the raw pointer shares the same count.
+    IntrusivePtr<Buffer> ptr2(ptr.Get());
+    EXPECT_EQ(ptr.Count(), 2);
+
+    IntrusivePtr<Buffer> ptr3 = std::move(ptr2);
+    EXPECT_FALSE(ptr2);
+    EXPECT_EQ(ptr3->size, 4);
+    EXPECT_EQ(ptr.Count(), 2);
+
+    // A copy of the object starts unowned.
+    const Buffer copy = *ptr;
+    EXPECT_EQ(copy.RefCount(), 0);
+}
+
+TEST(IntrusivePtr, AllocateIntrusiveGivesMemoryBack)
+{
+    HeapAllocator heapAllocator{"TestAllocateIntrusive"};
+    {
+        auto ptr = AllocateIntrusive<Buffer>(heapAllocator, 16);
+        auto ptr2 = ptr;
+        ptr = ptr2;
+        EXPECT_EQ(ptr->size, 16);
+        EXPECT_EQ(ptr.Count(), 2);
+        EXPECT_EQ(heapAllocator.Stats().bytesInUse, sizeof(Buffer));
+    }
+    EXPECT_EQ(heapAllocator.Stats().bytesInUse, 0);
+}
+
+TEST(IntrusivePtr, AtomicCountAcrossThreads)
+{
+    HeapAllocator heapAllocator{"TestAtomicIntrusive"};
+    {
+        auto ptr = AllocateIntrusive<SharedBuffer>(heapAllocator);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++)
+        {
+            threads.emplace_back([ptr]()
+                                 {
+                                     for (int copy = 0; copy < 10000; copy++)
+                                     {
+                                         IntrusivePtr<SharedBuffer> local = ptr;
+                                         EXPECT_GE(local.Count(), 2);
+                                     }
+                                 });
+        }
+        for (auto& thread: threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(ptr.Count(), 1);
+    }
+    EXPECT_EQ(heapAllocator.Stats().bytesInUse, 0);
+}
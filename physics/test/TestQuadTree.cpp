@@ -2,35 +2,35 @@
 #include "gtest/gtest.h"
 #include <array>
 
-static HeapAllocator TestHeapAllocator;
-
 TEST(QuadNode, ConstructorDefault)
 {
-    Engine::QuadNode node{TestHeapAllocator};
+    Physics::QuadNode node;
     EXPECT_EQ(node.bounds.MaxBound().X, Math::Vec2F::Zero().X);
     EXPECT_EQ(node.bounds.MaxBound().Y, Math::Vec2F::Zero().Y);
 
     EXPECT_EQ(node.bounds.MinBound().X, Math::Vec2F::Zero().X);
     EXPECT_EQ(node.bounds.MinBound().Y, Math::Vec2F::Zero().Y);
 
-    EXPECT_EQ(node.children[0], nullptr);
-    EXPECT_EQ(node.children[1], nullptr);
-    EXPECT_EQ(node.children[2], nullptr);
-    EXPECT_EQ(node.children[3], nullptr);
+    EXPECT_EQ(node.children[0], Physics::QuadNode::NoChild);
+    EXPECT_EQ(node.children[1], Physics::QuadNode::NoChild);
+    EXPECT_EQ(node.children[2], Physics::QuadNode::NoChild);
+    EXPECT_EQ(node.children[3], Physics::QuadNode::NoChild);
+    EXPECT_FALSE(node.HasChildren());
 }
 
 TEST(QuadTree, ConstructorDefault)
 {
-    Engine::QuadTree quadTree{TestHeapAllocator};
+    Physics::QuadTree quadTree;
     EXPECT_EQ(quadTree.nodeIndex, 1);
-    EXPECT_EQ(quadTree.MaxColliderInNode, Engine::QuadTree::MaxColliderInNode);
-    EXPECT_EQ(quadTree.MaxDepth, Engine::QuadTree::MaxDepth);
+    EXPECT_EQ(quadTree.MaxColliderInNode, Physics::QuadTree::MaxColliderInNode);
+    EXPECT_EQ(quadTree.MaxDepth, Physics::QuadTree::MaxDepth);
 }
 
 TEST(QuadTree, Init)
 {
-    Engine::QuadTree quadTree{TestHeapAllocator};
-    quadTree.Init();
+    SimulationArena arena;
+    Physics::QuadTree quadTree;
+    quadTree.Init(arena);
 
     std::size_t maxChildrenPossible = 0;
     for (int i = 0; i <= quadTree.MaxDepth; i++)
@@ -38,8 +38,43 @@ TEST(QuadTree, Init)
         maxChildrenPossible += Math::Pow(4, i);
     }
 
-    EXPECT_EQ(quadTree.nodes[0].children[0], nullptr);
+    const auto nodes = arena.View(quadTree.nodes);
+    ASSERT_EQ(nodes.size(), maxChildrenPossible);
+    EXPECT_EQ(nodes[0].children[0], Physics::QuadNode::NoChild);
     EXPECT_EQ(quadTree.nodeIndex, 1);
-    EXPECT_EQ(quadTree.nodes[0].bounds.MaxBound(), Math::Vec2F(0.0f, 0.0f));
-    EXPECT_EQ(quadTree.nodes[maxChildrenPossible].children[0], nullptr);
-}
\ No newline at end of file
+    EXPECT_EQ(nodes[0].bounds.MaxBound(), Math::Vec2F(0.0f, 0.0f));
+    EXPECT_EQ(nodes.back().children[0], Physics::QuadNode::NoChild);
+    EXPECT_EQ(nodes.back().colliders.capacity, Physics::QuadTree::MaxColliderInNode);
+}
+
+TEST(QuadTree, SubdivideKeepsEveryCollider)
+{
+    // A small arena, so the inserts move it while the tree is built.
+    SimulationArena arena;
+    Physics::QuadTree quadTree;
+    quadTree.Init(arena);
+    quadTree.Clear(arena);
+
+    constexpr std::uint32_t colliderCount = 64;
+    for (std::uint32_t i = 0; i < colliderCount; i++)
+    {
+        const Math::Vec2F position(static_cast<float>(i % 8) * 10.f, static_cast<float>(i / 8) * 10.f);
+        quadTree.InsertInRootNode(arena, Physics::SimplifedCollider{Physics::ColliderRef{i, 0},
+                                                                    Math::RectangleF(position, position + Math::Vec2F(1.f, 1.f))});
+    }
+    quadTree.SubdivideNodeRecursively(arena, 0, 0);
+    EXPECT_TRUE(quadTree.Root(arena).HasChildren());
+
+    std::array<int, colliderCount> visits{};
+    auto visitor = [&visits](const Physics::SimplifedCollider& collider)
+    {
+        visits[collider.colliderRef.index]++;
+        return true;
+    };
+    quadTree.QueryAABB(arena, quadTree.Root(arena), Math::RectangleF(Math::Vec2F(-1.f, -1.f), Math::Vec2F(100.f, 100.f)),
+                       visitor);
+    for (const auto count: visits)
+    {
+        EXPECT_EQ(count, 1);
+    }
+}
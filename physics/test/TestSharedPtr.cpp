@@ -1,6 +1,9 @@
 #include "SharedPtr.h"
 #include "gtest/gtest.h"
 
+#include <thread>
+#include <vector>
+
 struct sharedPtrFixture : public ::testing::TestWithParam<float>
 {
 };
@@ -34,4 +37,59 @@ TEST_P(sharedPtrFixture, Copy)
     }
 
     EXPECT_EQ(sPtr2.Count(), 2);
-}
\ No newline at end of file
+}
+TEST(SharedPtr, AssignmentReleasesPrevious)
+{
+    SharedPtr<float> sPtr(new float(1.f));
+    SharedPtr<float> sPtr2(new float(2.f));
+    SharedPtr<float> sPtr3(sPtr2);
+
+    sPtr2 = sPtr;
+    EXPECT_EQ(sPtr.Count(), 2);
+    EXPECT_EQ(sPtr3.Count(), 1);
+
+    SharedPtr<float> moved(std::move(sPtr));
+    EXPECT_EQ(moved.Count(), 2);
+    EXPECT_FALSE(sPtr);
+    EXPECT_EQ(sPtr.Count(), 0);
+}
+
+TEST(SharedPtr, AllocateSharedUsesOneAllocation)
+{
+    HeapAllocator heapAllocator{"TestAllocateShared"};
+    {
+        auto sPtr = AllocateShared<double>(heapAllocator, 3.0);
+        auto sPtr2 = sPtr;
+        EXPECT_DOUBLE_EQ(*sPtr2, 3.0);
+        EXPECT_EQ(sPtr.Count(), 2);
+        EXPECT_EQ(heapAllocator.Stats().allocationCount, 1);
+        EXPECT_GT(heapAllocator.Stats().bytesInUse, 0);
+    }
+    EXPECT_EQ(heapAllocator.Stats().bytesInUse, 0);
+}
+
+TEST(SharedPtr, AtomicCountAcrossThreads)
+{
+    HeapAllocator heapAllocator{"TestAtomicShared"};
+    {
+        auto sPtr = AllocateShared<int, AtomicCount>(heapAllocator, 7);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++)
+        {
+            threads.emplace_back([sPtr]()
+                                 {
+                                     for (int copy = 0; copy < 10000; copy++)
+                                     {
+                                         AtomicSharedPtr<int> local = sPtr;
+                                         EXPECT_EQ(*local, 7);
+                                     }
+                                 });
+        }
+        for (auto& thread: threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(sPtr.Count(), 1);
+    }
+    EXPECT_EQ(heapAllocator.Stats().bytesInUse, 0);
+}
@@ -0,0 +1,176 @@
+#include "SimulationArena.h"
+#include "World.h"
+#include "NullContactListener.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+TEST(SimulationArena, VectorSurvivesGrowth)
+{
+    SimulationArena arena;
+    ArenaVector<int> values{};
+    for (int i = 0; i < 1000; i++)
+    {
+        arena.PushBack(values, i);
+    }
+
+    ASSERT_EQ(values.size, 1000);
+    const auto view = arena.View(values);
+    for (int i = 0; i < 1000; i++)
+    {
+        EXPECT_EQ(view[i], i);
+    }
+    EXPECT_LE(arena.UsedSize(), arena.Capacity());
+}
+
+TEST(SimulationArena, FreedBlockIsReused)
+{
+    SimulationArena arena{4096};
+    const auto first = arena.Allocate(100);
+    const auto usedSize = arena.UsedSize();
+    arena.Deallocate(first, 100);
+
+    // Same size class, same block, the bump offset does not move.
+    EXPECT_EQ(arena.Allocate(90), first);
+    EXPECT_EQ(arena.UsedSize(), usedSize);
+    EXPECT_NE(arena.Allocate(100), first);
+    EXPECT_EQ(first % SimulationArena::Alignment, 0);
+}
+
+TEST(SimulationArena, CopyIsIndependent)
+{
+    SimulationArena arena;
+    ArenaVector<float> values{};
+    arena.Resize(values, 10, 1.f);
+
+    SimulationArena copy = arena;
+    arena.View(values)[0] = 2.f;
+    EXPECT_FLOAT_EQ(copy.View(values)[0], 1.f);
+    EXPECT_EQ(copy.UsedSize(), arena.UsedSize());
+
+    // The free lists are part of the copied prefix, both arenas allocate the same offsets.
+    auto copiedValues = values;
+    arena.Free(values);
+    copy.Free(copiedValues);
+    EXPECT_EQ(arena.Allocate(40), copy.Allocate(40));
+
+    copy = arena;
+    EXPECT_EQ(copy.UsedSize(), arena.UsedSize());
+}
+
+TEST(SimulationArena, HandleInsideArenaFollowsGrowth)
+{
+    SimulationArena arena;
+    ArenaVector<ArenaVector<int>> outer{};
+    arena.Resize(outer, 4, ArenaVector<int>{});
+
+    // Each push may move the buffer holding the inner handle itself.
+    for (int i = 0; i < 500; i++)
+    {
+        arena.PushBack(arena.View(outer)[i % 4], i);
+    }
+
+    for (std::size_t handle = 0; handle < 4; handle++)
+    {
+        const auto inner = arena.View(arena.View(outer)[handle]);
+        ASSERT_EQ(inner.size(), 125);
+        for (std::size_t i = 0; i < inner.size(); i++)
+        {
+            EXPECT_EQ(inner[i], static_cast<int>(i * 4 + handle));
+        }
+    }
+}
+
+TEST(SimulationArena, TaggedArenaReportsItsLiveBlocks)
+{
+    SimulationArena arena(1024, "TestArena");
+    ArenaVector<int> values{};
+    arena.Resize(values, 8, 0);
+    EXPECT_EQ(arena.Stats().bytesInUse, 32);
+    EXPECT_EQ(arena.Stats().allocationCount, 1);
+
+    // Growing frees the old block into its free list.
+    arena.Reserve(values, 16);
+    EXPECT_EQ(arena.Stats().bytesInUse, 64);
+    EXPECT_EQ(arena.Stats().peakBytes, 96);
+
+    // A copy reports the live blocks of the state it copied.
+    SimulationArena copy(arena);
+    EXPECT_EQ(copy.Stats().bytesInUse, 64);
+
+    const auto stats = CollectAllocatorStats();
+    const auto it = std::find_if(stats.begin(), stats.end(), [](const AllocatorStats& tagStats)
+    {
+        return std::string(tagStats.tag) == "TestArena";
+    });
+    ASSERT_NE(it, stats.end());
+    EXPECT_EQ(it->bytesInUse, 128);
+
+    arena.Reset();
+    EXPECT_EQ(arena.Stats().bytesInUse, 0);
+}
+
+namespace
+{
+    std::vector<Physics::BodyRef> FillWorld(Physics::World& world)
+    {
+        std::vector<Physics::BodyRef> bodyRefs;
+        for (int i = 0; i < 40; i++)
+        {
+            const auto bodyRef = world.CreateBody();
+            auto& body = world.GetBody(bodyRef);
+            body.SetMass(1.f);
+            body.SetPosition(Math::Vec2F(static_cast<float>(i % 8) * 1.5f, static_cast<float>(i / 8) * 1.5f));
+            body.SetVelocity(Math::Vec2F(static_cast<float>(i % 3) - 1.f, static_cast<float>(i % 5) - 2.f));
+
+            auto& collider = world.GetCollider(world.CreateCollider(bodyRef));
+            collider._shape = Math::ShapeType::Circle;
+            collider.circleShape = Math::CircleF(body.Position(), 1.f);
+            bodyRefs.push_back(bodyRef);
+        }
+        return bodyRefs;
+    }
+}
+
+TEST(SimulationArena, WorldSnapshotReplaysTheSameSteps)
+{
+    NullContactListener listener;
+    Physics::World world;
+    world.Init();
+    world.contactListener = &listener;
+    const auto bodyRefs = FillWorld(world);
+
+    for (int step = 0; step < 10; step++)
+    {
+        world.Update(1 / 50.f);
+    }
+
+    std::vector<std::byte> snapshot;
+    world.SaveSnapshot(snapshot);
+    Physics::World copy = world;
+
+    for (int step = 0; step < 30; step++)
+    {
+        world.Update(1 / 50.f);
+        copy.Update(1 / 50.f);
+    }
+    std::vector<Math::Vec2F> positions;
+    for (const auto bodyRef: bodyRefs)
+    {
+        positions.push_back(world.GetBody(bodyRef).Position());
+        EXPECT_EQ(copy.GetBody(bodyRef).Position(), positions.back());
+    }
+
+    // Back to the snapshot, the same steps give the same bodies, contact cache included.
+    world.LoadSnapshot(snapshot);
+    for (int step = 0; step < 30; step++)
+    {
+        world.Update(1 / 50.f);
+    }
+    for (std::size_t i = 0; i < bodyRefs.size(); i++)
+    {
+        EXPECT_EQ(world.GetBody(bodyRefs[i]).Position(), positions[i]);
+    }
+}
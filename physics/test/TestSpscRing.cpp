@@ -0,0 +1,76 @@
+#include "SpscRing.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+
+TEST(SpscRing, PushAndPopInOrderUntilFull)
+{
+    SpscRing<int, 4> ring;
+    int value = -1;
+    EXPECT_FALSE(ring.Pop(value));
+    EXPECT_EQ(value, -1);
+
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(ring.Push(i));
+    }
+    EXPECT_FALSE(ring.Push(4));
+
+    EXPECT_TRUE(ring.Pop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.Push(4));
+
+    // The indices wrap around the slots.
+    for (int i = 1; i <= 4; i++)
+    {
+        EXPECT_TRUE(ring.Pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.Pop(value));
+}
+
+TEST(SpscRing, EveryValueCrossesThreadsOnceAndInOrder)
+{
+    struct Record
+    {
+        int sequence = 0;
+        int copies[7]{};
+    };
+
+    constexpr int recordCount = 20000;
+    SpscRing<Record, 64> ring;
+    std::thread producer([&ring]()
+                         {
+                             for (int sequence = 1; sequence <= recordCount; sequence++)
+                             {
+                                 Record record;
+                                 record.sequence = sequence;
+                                 for (auto& copy: record.copies)
+                                 {
+                                     copy = sequence;
+                                 }
+                                 while (!ring.Push(record))
+                                 {
+                                     std::this_thread::yield();
+                                 }
+                             }
+                         });
+
+    Record record;
+    int expectedSequence = 1;
+    while (expectedSequence <= recordCount)
+    {
+        if (!ring.Pop(record))
+        {
+            continue;
+        }
+        ASSERT_EQ(record.sequence, expectedSequence);
+        for (const auto copy: record.copies)
+        {
+            ASSERT_EQ(copy, expectedSequence);
+        }
+        expectedSequence++;
+    }
+    producer.join();
+    EXPECT_FALSE(ring.Pop(record));
+}
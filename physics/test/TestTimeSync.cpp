@@ -0,0 +1,60 @@
+#include "TimeSync.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+TEST(TimeSync, FullRateWithoutRemoteOrInLockstep)
+{
+    TimeSync timeSync(1.0 / 50.0);
+    timeSync.Update(10, -1, 0.1);
+    EXPECT_EQ(timeSync.Advantage(), 0.f);
+    EXPECT_EQ(timeSync.TimeScale(), 1.0);
+
+    // 100 ms round trip: the remote ran 2.5 frames since its frame 7.5 frames behind was sent.
+    timeSync.Update(10, 5, 0.1);
+    EXPECT_FLOAT_EQ(timeSync.LocalAdvantage(), 2.5f);
+
+    // The remote sees the same lag from its side, nobody is ahead.
+    TimeSync lockstep(1.0 / 50.0);
+    lockstep.SetRemoteAdvantage(2.5f);
+    lockstep.Update(10, 5, 0.1);
+    EXPECT_FLOAT_EQ(lockstep.Advantage(), 0.f);
+    EXPECT_EQ(lockstep.TimeScale(), 1.0);
+}
+
+TEST(TimeSync, PeerAheadSlowsDownUntilBothMeet)
+{
+    // Two peers over a 40 ms round trip, the first one started 6 ticks earlier.
+    constexpr double step = 1.0 / 50.0;
+    constexpr double roundTripTime = 0.04;
+    constexpr int latencyTicks = 1;
+    TimeSync first(step);
+    TimeSync second(step);
+    double firstTime = 6 * step;
+    double secondTime = 0.0;
+    std::vector<int> firstFrames;
+    std::vector<int> secondFrames;
+
+    for (int tick = 0; tick < 1500; tick++)
+    {
+        // Both run ticks of the same wall-clock duration, stretched by their time scale.
+        firstTime += step * first.TimeScale();
+        secondTime += step * second.TimeScale();
+        firstFrames.push_back(static_cast<int>(firstTime / step));
+        secondFrames.push_back(static_cast<int>(secondTime / step));
+
+        const auto lastSecondFrame = tick >= latencyTicks ? secondFrames[tick - latencyTicks] : -1;
+        const auto lastFirstFrame = tick >= latencyTicks ? firstFrames[tick - latencyTicks] : -1;
+        first.Update(firstFrames.back(), lastSecondFrame, roundTripTime);
+        second.Update(secondFrames.back(), lastFirstFrame, roundTripTime);
+        first.SetRemoteAdvantage(second.LocalAdvantage());
+        second.SetRemoteAdvantage(first.LocalAdvantage());
+
+        EXPECT_EQ(second.TimeScale(), 1.0);
+    }
+
+    // The first gave up its head start, within the dead zone.
+    EXPECT_LE(std::abs(firstTime - secondTime) / step, 2 * TimeSync::DeadZone + 1);
+    EXPECT_EQ(first.TimeScale(), 1.0);
+}
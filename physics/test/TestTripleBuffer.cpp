@@ -0,0 +1,70 @@
+#include "TripleBuffer.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+
+TEST(TripleBuffer, ReaderGetsTheLatestPublishedValue)
+{
+    TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.Update());
+    EXPECT_EQ(buffer.ReadBuffer(), 0);
+
+    buffer.WriteBuffer() = 1;
+    buffer.Publish();
+    buffer.WriteBuffer() = 2;
+    buffer.Publish();
+    EXPECT_TRUE(buffer.Update());
+    EXPECT_EQ(buffer.ReadBuffer(), 2);
+
+    // Nothing new: the reader keeps its value.
+    EXPECT_FALSE(buffer.Update());
+    EXPECT_EQ(buffer.ReadBuffer(), 2);
+
+    buffer.WriteBuffer() = 3;
+    EXPECT_EQ(buffer.ReadBuffer(), 2);
+    buffer.Publish();
+    EXPECT_TRUE(buffer.Update());
+    EXPECT_EQ(buffer.ReadBuffer(), 3);
+}
+
+TEST(TripleBuffer, ValuesAreNeverTornNorOlderAcrossThreads)
+{
+    struct Value
+    {
+        int sequence = 0;
+        int copies[15]{};
+    };
+
+    constexpr int publicationCount = 100000;
+    TripleBuffer<Value> buffer;
+    std::thread writer([&buffer]()
+                       {
+                           for (int sequence = 1; sequence <= publicationCount; sequence++)
+                           {
+                               auto& value = buffer.WriteBuffer();
+                               value.sequence = sequence;
+                               for (auto& copy: value.copies)
+                               {
+                                   copy = sequence;
+                               }
+                               buffer.Publish();
+                           }
+                       });
+
+    int lastSequence = 0;
+    while (lastSequence < publicationCount)
+    {
+        if (!buffer.Update())
+        {
+            continue;
+        }
+        const auto& value = buffer.ReadBuffer();
+        ASSERT_GT(value.sequence, lastSequence);
+        for (const auto copy: value.copies)
+        {
+            ASSERT_EQ(copy, value.sequence);
+        }
+        lastSequence = value.sequence;
+    }
+    writer.join();
+}
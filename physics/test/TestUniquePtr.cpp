@@ -1,4 +1,5 @@
 #include "UniquePtr.h"
+#include "Vec2.h"
 #include "gtest/gtest.h"
 
 struct uniquePtrFixture : public ::testing::TestWithParam<float>
@@ -26,4 +27,18 @@ TEST_P(uniquePtrFixture, MoveConstructor)
 
     EXPECT_EQ(*uPtr2, param);
     EXPECT_EQ(uPtr.operator->(), nullptr);
-}
\ No newline at end of file
+}
+TEST(UniquePtr, AllocateUniqueGivesMemoryBack)
+{
+    HeapAllocator heapAllocator{"TestAllocateUnique"};
+    {
+        auto uPtr = AllocateUnique<Math::Vec2F>(heapAllocator, 1.f, 2.f);
+        EXPECT_FLOAT_EQ(uPtr->Y, 2.f);
+        EXPECT_EQ(heapAllocator.Stats().bytesInUse, sizeof(Math::Vec2F));
+
+        auto uPtr2 = std::move(uPtr);
+        EXPECT_FALSE(uPtr);
+        EXPECT_TRUE(uPtr2);
+    }
+    EXPECT_EQ(heapAllocator.Stats().bytesInUse, 0);
+}
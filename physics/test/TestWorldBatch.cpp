@@ -0,0 +1,101 @@
+#include "WorldBatch.h"
+#include "gtest/gtest.h"
+
+TEST(WorldBatch, Init)
+{
+    Physics::WorldBatch batch;
+    batch.Init();
+    for (auto& world: batch.worlds)
+    {
+        EXPECT_EQ(world.CurrentBodyCount(), world.GetInitSizeForVector());
+    }
+}
+
+TEST(WorldBatch, UpdateMatchesSingleWorld)
+{
+    Physics::WorldBatch batch;
+    batch.Init();
+    std::array<Physics::World, Physics::WorldBatch::LaneCount> references;
+
+    for (std::size_t lane = 0; lane < Physics::WorldBatch::LaneCount; lane++)
+    {
+        references[lane].Init();
+        // Every lane gets a different number of bodies, so some slots are empty in some lanes.
+        for (std::size_t i = 0; i <= lane * 3; i++)
+        {
+            const auto value = static_cast<float>(lane + 1) * static_cast<float>(i + 1);
+            for (auto* world: {&batch[lane], &references[lane]})
+            {
+                auto& body = world->GetBody(world->CreateBody());
+                body.SetMass(value);
+                body.SetPosition(Math::Vec2F(value, -value));
+                body.SetVelocity(Math::Vec2F(-value, value * 0.5f));
+                body.AddForce(Math::Vec2F(value * 3.f, 9.81f));
+            }
+        }
+    }
+
+    for (int step = 0; step < 10; step++)
+    {
+        batch.Update(1 / 50.f);
+        for (auto& world: references)
+        {
+            world.Update(1 / 50.f);
+        }
+    }
+
+    for (std::size_t lane = 0; lane < Physics::WorldBatch::LaneCount; lane++)
+    {
+        for (std::size_t i = 0; i <= lane * 3; i++)
+        {
+            const Physics::BodyRef bodyRef{static_cast<std::uint32_t>(i), 0};
+            auto& batchBody = batch[lane].GetBody(bodyRef);
+            auto& referenceBody = references[lane].GetBody(bodyRef);
+            EXPECT_EQ(batchBody.Position(), referenceBody.Position());
+            EXPECT_EQ(batchBody.Velocity(), referenceBody.Velocity());
+            EXPECT_EQ(batchBody.Force(), referenceBody.Force());
+        }
+    }
+}
+
+TEST(WorldBatch, UpdateSkipsSleepingAndStaticBodies)
+{
+    Physics::WorldBatch batch;
+    batch.Init();
+    Physics::World reference;
+    reference.Init();
+
+    // Lane 0 mixes moving, resting and static bodies, so its awake list is not the slot order after a few steps.
+    for (auto* world: {&batch[0], &reference})
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            auto& body = world->GetBody(world->CreateBody());
+            body.SetMass(static_cast<float>(i + 1));
+            body.SetPosition(Math::Vec2F(static_cast<float>(i), 0.f));
+            if (i % 3 == 0)
+            {
+                body.type = Physics::BodyType::STATIC;
+            }
+            else if (i % 3 == 1)
+            {
+                body.SetVelocity(Math::Vec2F(1.f, static_cast<float>(i)));
+            }
+        }
+    }
+
+    for (int step = 0; step < 40; step++)
+    {
+        batch.Update(1 / 50.f);
+        reference.Update(1 / 50.f);
+    }
+
+    EXPECT_EQ(batch[0].AwakeBodyCount(), reference.AwakeBodyCount());
+    for (std::uint32_t i = 0; i < 8; i++)
+    {
+        const Physics::BodyRef bodyRef{i, 0};
+        EXPECT_EQ(batch[0].GetBody(bodyRef).Position(), reference.GetBody(bodyRef).Position());
+        EXPECT_EQ(batch[0].GetBody(bodyRef).Velocity(), reference.GetBody(bodyRef).Velocity());
+        EXPECT_EQ(batch[0].GetBody(bodyRef).IsAwake(), reference.GetBody(bodyRef).IsAwake());
+    }
+}
@@ -0,0 +1,195 @@
+#include "World.h"
+#include "NullContactListener.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+struct WorldQueryFixture : public ::testing::Test
+{
+    Physics::World world;
+    NullContactListener listener;
+    Physics::ColliderRef circleRef{};
+    Physics::ColliderRef rectangleRef{};
+    std::vector<Physics::ColliderRef> farRefs;
+
+    void SetUp() override
+    {
+        world.Init();
+        world.contactListener = &listener;
+
+        // Static bodies so the Update only builds the QuadTree.
+        const auto circleBodyRef = world.CreateBody();
+        auto& circleBody = world.GetBody(circleBodyRef);
+        circleBody.SetPosition(Math::Vec2F(100.f, 100.f));
+        circleBody.SetVelocity(Math::Vec2F(0.f, 0.f));
+        circleRef = world.CreateCollider(circleBodyRef);
+        auto& circle = world.GetCollider(circleRef);
+        circle._shape = Math::ShapeType::Circle;
+        circle.circleShape = Math::CircleF(Math::Vec2F(100.f, 100.f), 10.f);
+        circle.isTrigger = true;
+
+        const auto rectangleBodyRef = world.CreateBody();
+        world.GetBody(rectangleBodyRef).SetVelocity(Math::Vec2F(0.f, 0.f));
+        rectangleRef = world.CreateCollider(rectangleBodyRef);
+        auto& rectangle = world.GetCollider(rectangleRef);
+        rectangle._shape = Math::ShapeType::Rectangle;
+        rectangle.rectangleShape = Math::RectangleF(Math::Vec2F(200.f, 90.f), Math::Vec2F(220.f, 110.f));
+        rectangle.isTrigger = true;
+
+        // Enough far colliders to subdivide the QuadTree.
+        for (int i = 0; i < 12; i++)
+        {
+            const auto bodyRef = world.CreateBody();
+            world.GetBody(bodyRef).SetVelocity(Math::Vec2F(0.f, 0.f));
+            const auto colliderRef = world.CreateCollider(bodyRef);
+            auto& collider = world.GetCollider(colliderRef);
+            collider._shape = Math::ShapeType::Rectangle;
+            const auto offset = static_cast<float>(i) * 30.f;
+            collider.rectangleShape = Math::RectangleF(Math::Vec2F(offset, 500.f), Math::Vec2F(offset + 5.f, 505.f));
+            collider.isTrigger = true;
+            farRefs.push_back(colliderRef);
+        }
+
+        world.Update(1 / 50.f);
+    }
+};
+
+TEST_F(WorldQueryFixture, QueryAABB)
+{
+    std::vector<Physics::ColliderRef> found;
+    world.QueryAABB(Math::RectangleF(Math::Vec2F(105.f, 95.f), Math::Vec2F(205.f, 105.f)),
+                    [&found](Physics::ColliderRef colliderRef)
+                    {
+                        found.push_back(colliderRef);
+                        return true;
+                    });
+    ASSERT_EQ(found.size(), 2);
+    EXPECT_TRUE(found[0] == circleRef || found[1] == circleRef);
+    EXPECT_TRUE(found[0] == rectangleRef || found[1] == rectangleRef);
+
+    // The AABB of the circle overlaps this corner, not the circle itself.
+    found.clear();
+    world.QueryAABB(Math::RectangleF(Math::Vec2F(91.f, 91.f), Math::Vec2F(92.f, 92.f)),
+                    [&found](Physics::ColliderRef colliderRef)
+                    {
+                        found.push_back(colliderRef);
+                        return true;
+                    });
+    EXPECT_TRUE(found.empty());
+}
+
+TEST_F(WorldQueryFixture, QueryAABBStops)
+{
+    int visitCount = 0;
+    world.QueryAABB(Math::RectangleF(Math::Vec2F(0.f, 0.f), Math::Vec2F(1000.f, 1000.f)),
+                    [&visitCount](Physics::ColliderRef)
+                    {
+                        visitCount++;
+                        return false;
+                    });
+    EXPECT_EQ(visitCount, 1);
+}
+
+TEST_F(WorldQueryFixture, QueryPoint)
+{
+    std::vector<Physics::ColliderRef> found;
+    auto visitor = [&found](Physics::ColliderRef colliderRef)
+    {
+        found.push_back(colliderRef);
+        return true;
+    };
+
+    world.QueryPoint(Math::Vec2F(105.f, 100.f), visitor);
+    ASSERT_EQ(found.size(), 1);
+    EXPECT_TRUE(found[0] == circleRef);
+
+    found.clear();
+    world.QueryPoint(Math::Vec2F(61.f, 502.f), visitor);
+    ASSERT_EQ(found.size(), 1);
+    EXPECT_TRUE(found[0] == farRefs[2]);
+
+    found.clear();
+    world.QueryPoint(Math::Vec2F(150.f, 100.f), visitor);
+    EXPECT_TRUE(found.empty());
+}
+
+TEST_F(WorldQueryFixture, RayCast)
+{
+    std::vector<Physics::RayCastHit> hits;
+    world.RayCast(Math::Vec2F(50.f, 100.f), Math::Vec2F(250.f, 100.f),
+                  [&hits](const Physics::RayCastHit& hit)
+                  {
+                      hits.push_back(hit);
+                      return true;
+                  });
+    ASSERT_EQ(hits.size(), 2);
+
+    for (const auto& hit: hits)
+    {
+        if (hit.colliderRef == circleRef)
+        {
+            EXPECT_FLOAT_EQ(hit.fraction, 0.2f);
+            EXPECT_FLOAT_EQ(hit.point.X, 90.f);
+            EXPECT_FLOAT_EQ(hit.normal.X, -1.f);
+        }
+        else
+        {
+            EXPECT_TRUE(hit.colliderRef == rectangleRef);
+            EXPECT_FLOAT_EQ(hit.fraction, 0.75f);
+            EXPECT_FLOAT_EQ(hit.point.X, 200.f);
+            EXPECT_FLOAT_EQ(hit.normal.X, -1.f);
+            EXPECT_FLOAT_EQ(hit.normal.Y, 0.f);
+        }
+    }
+
+    // Going up along the rectangle misses everything.
+    hits.clear();
+    world.RayCast(Math::Vec2F(150.f, 0.f), Math::Vec2F(150.f, 400.f),
+                  [&hits](const Physics::RayCastHit& hit)
+                  {
+                      hits.push_back(hit);
+                      return true;
+                  });
+    EXPECT_TRUE(hits.empty());
+}
+
+TEST(WorldQuery, QueryWithoutContactListener)
+{
+    Physics::World world;
+    world.Init();
+
+    const auto bodyRef = world.CreateBody();
+    auto& body = world.GetBody(bodyRef);
+    body.SetPosition(Math::Vec2F(100.f, 100.f));
+    body.SetVelocity(Math::Vec2F(0.f, 0.f));
+    const auto colliderRef = world.CreateCollider(bodyRef);
+    auto& collider = world.GetCollider(colliderRef);
+    collider._shape = Math::ShapeType::Circle;
+    collider.circleShape = Math::CircleF(Math::Vec2F(100.f, 100.f), 10.f);
+
+    world.Update(1 / 50.f);
+
+    std::vector<Physics::ColliderRef> found;
+    world.QueryPoint(Math::Vec2F(100.f, 105.f), [&found](Physics::ColliderRef ref)
+    {
+        found.push_back(ref);
+        return true;
+    });
+    ASSERT_EQ(found.size(), 1);
+    EXPECT_TRUE(found[0] == colliderRef);
+}
+
+TEST_F(WorldQueryFixture, RayCastNearlyParallel)
+{
+    // Almost vertical, ending inside the rectangle: the tree must not cull it as parallel.
+    std::vector<Physics::RayCastHit> hits;
+    world.RayCast(Math::Vec2F(199.9995f, 80.f), Math::Vec2F(200.0001f, 100.f),
+                  [&hits](const Physics::RayCastHit& hit)
+                  {
+                      hits.push_back(hit);
+                      return true;
+                  });
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_TRUE(hits[0].colliderRef == rectangleRef);
+    EXPECT_FLOAT_EQ(hits[0].normal.X, -1.f);
+}
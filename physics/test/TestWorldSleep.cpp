@@ -0,0 +1,121 @@
+#include "World.h"
+#include "WorldBatch.h"
+#include "gtest/gtest.h"
+
+TEST(WorldSleep, StaticAndUnvalidBodiesLeaveAwakeList)
+{
+    Physics::World world;
+    world.Init();
+
+    auto& staticBody = world.GetBody(world.CreateBody());
+    staticBody.SetMass(1.f);
+    staticBody.type = Physics::BodyType::STATIC;
+
+    auto& dynamicBody = world.GetBody(world.CreateBody());
+    dynamicBody.SetMass(1.f);
+    dynamicBody.SetVelocity(Math::Vec2F(1.f, 0.f));
+
+    EXPECT_EQ(world.AwakeBodyCount(), 2);
+    world.Update(1 / 50.f);
+    EXPECT_EQ(world.AwakeBodyCount(), 1);
+    EXPECT_FLOAT_EQ(dynamicBody.Position().X, 1 / 50.f);
+    EXPECT_EQ(staticBody.Position(), Math::Vec2F(0.f, 0.f));
+}
+
+TEST(WorldSleep, IdleBodyFallsAsleepAndWakesUp)
+{
+    Physics::World world;
+    world.Init();
+    world.framesToSleep = 10;
+
+    const auto bodyRef = world.CreateBody();
+    world.GetBody(bodyRef).SetMass(1.f);
+
+    for (int step = 0; step < world.framesToSleep - 1; step++)
+    {
+        world.Update(1 / 50.f);
+        EXPECT_TRUE(world.GetBody(bodyRef).IsAwake());
+    }
+    world.Update(1 / 50.f);
+    EXPECT_FALSE(world.GetBody(bodyRef).IsAwake());
+    EXPECT_EQ(world.AwakeBodyCount(), 0);
+
+    // A zero velocity keeps it asleep, a force wakes it up.
+    world.GetBody(bodyRef).SetVelocity(Math::Vec2F(0.f, 0.f));
+    world.Update(1 / 50.f);
+    EXPECT_EQ(world.AwakeBodyCount(), 0);
+
+    world.GetBody(bodyRef).AddForce(Math::Vec2F(0.f, 50.f));
+    world.Update(1 / 50.f);
+    EXPECT_EQ(world.AwakeBodyCount(), 1);
+    EXPECT_GT(world.GetBody(bodyRef).Position().Y, 0.f);
+}
+
+TEST(WorldSleep, DestroyedBodyLeavesLists)
+{
+    Physics::World world;
+    world.Init();
+
+    const auto bodyRef = world.CreateBody();
+    world.GetBody(bodyRef).SetMass(1.f);
+    EXPECT_EQ(world.AwakeBodyCount(), 1);
+
+    world.DestroyBody(bodyRef);
+    EXPECT_EQ(world.AwakeBodyCount(), 0);
+
+    // The reused slot is listed once.
+    const auto newBodyRef = world.CreateBody();
+    EXPECT_EQ(newBodyRef.index, bodyRef.index);
+    EXPECT_EQ(world.CreateBody().index, bodyRef.index);
+    EXPECT_EQ(world.AwakeBodyCount(), 1);
+}
+
+TEST(WorldSleep, BatchSkipsSleepingBodies)
+{
+    Physics::WorldBatch batch;
+    batch.Init();
+    batch[0].framesToSleep = 2;
+
+    const auto bodyRef = batch[0].CreateBody();
+    batch[0].GetBody(bodyRef).SetMass(1.f);
+    batch.Update(1 / 50.f);
+    batch.Update(1 / 50.f);
+    EXPECT_FALSE(batch[0].GetBody(bodyRef).IsAwake());
+
+    batch[0].GetBody(bodyRef).SetVelocity(Math::Vec2F(0.f, 1.f));
+    batch.Update(1 / 50.f);
+    EXPECT_TRUE(batch[0].GetBody(bodyRef).IsAwake());
+    EXPECT_FLOAT_EQ(batch[0].GetBody(bodyRef).Position().Y, 1 / 50.f);
+}
+
+TEST(WorldSleep, StaticBodiesLeaveBothLists)
+{
+    Physics::World world;
+    world.Init();
+
+    const auto staticRef = world.CreateBody();
+    world.GetBody(staticRef).SetMass(1.f);
+    world.GetBody(staticRef).type = Physics::BodyType::STATIC;
+
+    const auto dynamicRef = world.CreateBody();
+    world.GetBody(dynamicRef).SetMass(1.f);
+    world.GetBody(dynamicRef).SetVelocity(Math::Vec2F(1.f, 0.f));
+
+    world.Update(1 / 50.f);
+    EXPECT_EQ(world.AwakeBodyCount(), 1);
+
+    // Destroying the static body finds nothing to remove, the dynamic body keeps its place.
+    world.DestroyBody(staticRef);
+    world.Update(1 / 50.f);
+    EXPECT_EQ(world.AwakeBodyCount(), 1);
+    EXPECT_FLOAT_EQ(world.GetBody(dynamicRef).Position().X, 2 / 50.f);
+
+    // The freed slot is listed again when reused.
+    const auto newRef = world.CreateBody();
+    EXPECT_EQ(newRef.index, staticRef.index);
+    world.GetBody(newRef).SetMass(1.f);
+    world.GetBody(newRef).SetVelocity(Math::Vec2F(0.f, 1.f));
+    world.Update(1 / 50.f);
+    EXPECT_EQ(world.AwakeBodyCount(), 2);
+    EXPECT_FLOAT_EQ(world.GetBody(newRef).Position().Y, 1 / 50.f);
+}
@@ -0,0 +1,163 @@
+// Build-time asset packer: decodes and pre-scales the images listed in a
+// manifest, and packs them with the raw audio files in one archive that the
+// game maps at startup (see AssetArchive).
+//
+// Usage: asset_packer <manifest> <data directory> <output archive>
+//
+// Each manifest line is either
+//   image <file> <scale>   decoded to RGBA8 and resized by scale
+//   sprite <file> <scale>  the same, packed with the other sprites in one atlas
+//   file <file>            packed as it is
+// Empty lines and lines starting with '#' are skipped.
+
+#include <raylib.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "AssetArchive.h"
+
+namespace {
+constexpr const char* kAtlasName = "data/sprites.atlas";
+
+// Entries are named after the path the game loads the loose file from.
+std::string EntryName(const std::string& file) { return "data/" + file; }
+
+// Decodes an image to RGBA8 and resizes it by scale, the baked scale is the
+// one actually applied after rounding the size.
+bool LoadScaledImage(const std::string& path, float scale, Image& image,
+                     float& baked_scale) {
+  image = LoadImage(path.c_str());
+  if (image.data == nullptr) {
+    return false;
+  }
+  ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+  const int width = std::max(1, static_cast<int>(image.width * scale + 0.5f));
+  const int height = std::max(1, static_cast<int>(image.height * scale + 0.5f));
+  baked_scale = static_cast<float>(width) / image.width;
+  if (width != image.width || height != image.height) {
+    ImageResize(&image, width, height);
+  }
+  return true;
+}
+
+bool PackImage(AssetArchiveWriter& writer, const std::string& path,
+               const std::string& file, float scale) {
+  Image image;
+  float baked_scale = 1.f;
+  if (!LoadScaledImage(path, scale, image, baked_scale)) {
+    return false;
+  }
+  const bool is_added =
+      writer.AddImage(EntryName(file), image.data,
+                      static_cast<std::uint32_t>(image.width),
+                      static_cast<std::uint32_t>(image.height), baked_scale);
+  UnloadImage(image);
+  return is_added;
+}
+
+// The sprite images stay loaded until the atlas is built.
+bool LoadSprite(std::vector<Image>& images, std::vector<AtlasSprite>& sprites,
+                const std::string& path, const std::string& file,
+                float scale) {
+  Image image;
+  float baked_scale = 1.f;
+  if (!LoadScaledImage(path, scale, image, baked_scale)) {
+    return false;
+  }
+  images.push_back(image);
+  sprites.push_back(AtlasSprite{EntryName(file), image.data,
+                                static_cast<std::uint32_t>(image.width),
+                                static_cast<std::uint32_t>(image.height),
+                                baked_scale});
+  return true;
+}
+
+bool PackFile(AssetArchiveWriter& writer, const std::string& path,
+              const std::string& file) {
+  int size = 0;
+  unsigned char* data = LoadFileData(path.c_str(), &size);
+  if (data == nullptr) {
+    return false;
+  }
+  const bool is_added = writer.AddFile(EntryName(file), data, size);
+  UnloadFileData(data);
+  return is_added;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 4) {
+    std::fprintf(stderr, "Usage: %s <manifest> <data directory> <output archive>\n",
+                 argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::ifstream manifest(argv[1]);
+  if (!manifest) {
+    std::fprintf(stderr, "asset_packer: cannot read %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  SetTraceLogLevel(LOG_WARNING);
+
+  AssetArchiveWriter writer;
+  std::vector<Image> sprite_images;
+  std::vector<AtlasSprite> sprites;
+  std::string line;
+  int line_number = 0;
+  while (std::getline(manifest, line)) {
+    line_number++;
+    std::istringstream fields(line);
+    std::string kind;
+    std::string file;
+    if (!(fields >> kind) || kind[0] == '#') {
+      continue;
+    }
+    fields >> file;
+    const std::string path = std::string(argv[2]) + "/" + file;
+
+    // A missing source is skipped: the game then looks for the loose file.
+    if (!FileExists(path.c_str())) {
+      std::fprintf(stderr, "asset_packer: %s is missing, skipped\n", path.c_str());
+      continue;
+    }
+
+    bool is_packed = false;
+    float scale = 1.f;
+    if (kind == "image" && (fields >> scale) && scale > 0.f) {
+      is_packed = PackImage(writer, path, file, scale);
+    } else if (kind == "sprite" && (fields >> scale) && scale > 0.f) {
+      is_packed = LoadSprite(sprite_images, sprites, path, file, scale);
+    } else if (kind == "file") {
+      is_packed = PackFile(writer, path, file);
+    }
+    if (!is_packed) {
+      std::fprintf(stderr, "asset_packer: %s:%d: cannot pack \"%s\"\n", argv[1],
+                   line_number, line.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+
+  const bool is_atlas_added =
+      sprites.empty() || writer.AddAtlas(kAtlasName, sprites);
+  for (auto& image : sprite_images) {
+    UnloadImage(image);
+  }
+  if (!is_atlas_added) {
+    std::fprintf(stderr, "asset_packer: cannot pack the sprites in %s\n",
+                 kAtlasName);
+    return EXIT_FAILURE;
+  }
+
+  if (!writer.Write(argv[3])) {
+    std::fprintf(stderr, "asset_packer: cannot write %s\n", argv[3]);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}